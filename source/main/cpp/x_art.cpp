@@ -0,0 +1,814 @@
+#include "xbase/x_target.h"
+#include "xbase/x_allocator.h"
+#include "xbase/x_debug.h"
+#include "xbase/x_integer.h"
+#include "xbase/x_memory.h"
+
+#include "xbase/x_art.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#    define X_ART_SSE2
+#    include <emmintrin.h>
+#endif
+
+namespace xcore
+{
+    typedef art_t::node_t node_t;
+    typedef art_t::leaf_t leaf_t;
+
+    enum
+    {
+        NODE4   = 0,
+        NODE16  = 1,
+        NODE48  = 2,
+        NODE256 = 3,
+    };
+
+    // The key follows the leaf in the same allocation
+    struct art_t::leaf_t
+    {
+        void* m_value;
+        u32   m_len;
+        u32   m_dummy;
+
+        inline xbyte*       key() { return (xbyte*)(this + 1); }
+        inline xbyte const* key() const { return (xbyte const*)(this + 1); }
+    };
+
+    // The prefix holds the first MAX_PREFIX bytes of a collapsed path of
+    // m_prefix_len bytes, the remaining bytes are taken from a leaf. A key
+    // that ends at this node is stored in m_leaf.
+    struct art_t::node_t
+    {
+        u8      m_type;
+        u8      m_dummy;
+        u16     m_count;
+        u32     m_prefix_len;
+        xbyte   m_prefix[art_t::MAX_PREFIX];
+        leaf_t* m_leaf;
+    };
+
+    // Children are sorted by key byte
+    struct node4_t : node_t
+    {
+        xbyte   m_keys[4];
+        node_t* m_children[4];
+    };
+
+    struct node16_t : node_t
+    {
+        xbyte   m_keys[16];
+        node_t* m_children[16];
+    };
+
+    // m_index maps a key byte to (slot + 1), 0 means 'no child'
+    struct node48_t : node_t
+    {
+        xbyte   m_index[256];
+        node_t* m_children[48];
+    };
+
+    struct node256_t : node_t
+    {
+        node_t* m_children[256];
+    };
+
+    // A child pointer with bit 0 set is a leaf
+    static inline bool    s_is_leaf(node_t const* n) { return ((uptr)n & 1) != 0; }
+    static inline leaf_t* s_to_leaf(node_t const* n) { return (leaf_t*)((uptr)n & ~(uptr)1); }
+    static inline node_t* s_tag(leaf_t* l) { return (node_t*)((uptr)l | 1); }
+
+    static inline bool s_leaf_matches(leaf_t const* l, cbuffer_t const& key) { return l->m_len == key.m_len && x_memcmp(l->key(), key.m_const, key.m_len) == 0; }
+
+    static leaf_t* s_new_leaf(alloc_t* a, cbuffer_t const& key, void* value)
+    {
+        leaf_t* l  = (leaf_t*)a->allocate(sizeof(leaf_t) + key.m_len, sizeof(void*));
+        l->m_value = value;
+        l->m_len   = key.m_len;
+        l->m_dummy = 0;
+        x_memcpy(l->key(), key.m_const, key.m_len);
+        return l;
+    }
+
+    static node_t* s_new_node(alloc_t* a, u8 type)
+    {
+        static const u32 sizes[] = {sizeof(node4_t), sizeof(node16_t), sizeof(node48_t), sizeof(node256_t)};
+        node_t*          n       = (node_t*)a->allocate(sizes[type], sizeof(void*));
+        x_memclr(n, sizes[type]);
+        n->m_type = type;
+        return n;
+    }
+
+    static void s_copy_header(node_t* dst, node_t const* src)
+    {
+        dst->m_count      = src->m_count;
+        dst->m_prefix_len = src->m_prefix_len;
+        dst->m_leaf       = src->m_leaf;
+        x_memcpy(dst->m_prefix, src->m_prefix, art_t::MAX_PREFIX);
+    }
+
+    static node_t** s_find_child(node_t* n, xbyte b)
+    {
+        switch (n->m_type)
+        {
+            case NODE4:
+            {
+                node4_t* n4 = (node4_t*)n;
+                for (u32 i = 0; i < n4->m_count; ++i)
+                {
+                    if (n4->m_keys[i] == b)
+                        return &n4->m_children[i];
+                }
+                return nullptr;
+            }
+            case NODE16:
+            {
+                node16_t* n16 = (node16_t*)n;
+#ifdef X_ART_SSE2
+                __m128i const cmp  = _mm_cmpeq_epi8(_mm_set1_epi8((char)b), _mm_loadu_si128((__m128i const*)n16->m_keys));
+                u32 const     mask = (u32)_mm_movemask_epi8(cmp) & ((1u << n16->m_count) - 1);
+                if (mask != 0)
+                    return &n16->m_children[xcountTrailingZeros(mask)];
+#else
+                for (u32 i = 0; i < n16->m_count; ++i)
+                {
+                    if (n16->m_keys[i] == b)
+                        return &n16->m_children[i];
+                }
+#endif
+                return nullptr;
+            }
+            case NODE48:
+            {
+                node48_t* n48 = (node48_t*)n;
+                if (n48->m_index[b] == 0)
+                    return nullptr;
+                return &n48->m_children[n48->m_index[b] - 1];
+            }
+        }
+        node256_t* n256 = (node256_t*)n;
+        return n256->m_children[b] != nullptr ? &n256->m_children[b] : nullptr;
+    }
+
+    // The position at which @b is inserted to keep @keys sorted
+    static inline u32 s_lower_bound4(xbyte const* keys, u32 count, xbyte b)
+    {
+        u32 i = 0;
+        while (i < count && keys[i] < b)
+            ++i;
+        return i;
+    }
+
+    static inline u32 s_lower_bound16(xbyte const* keys, u32 count, xbyte b)
+    {
+#ifdef X_ART_SSE2
+        // Unsigned compare by flipping the sign bit
+        __m128i const bias = _mm_set1_epi8((char)0x80);
+        __m128i const key  = _mm_xor_si128(_mm_set1_epi8((char)b), bias);
+        __m128i const cmp  = _mm_cmplt_epi8(key, _mm_xor_si128(_mm_loadu_si128((__m128i const*)keys), bias));
+        u32 const     mask = (u32)_mm_movemask_epi8(cmp) & ((1u << count) - 1);
+        return mask != 0 ? (u32)xcountTrailingZeros(mask) : count;
+#else
+        return s_lower_bound4(keys, count, b);
+#endif
+    }
+
+    // The child at or after @pos in key order, @pos is moved past it
+    static node_t* s_next_child(node_t* n, s32& pos)
+    {
+        switch (n->m_type)
+        {
+            case NODE4:
+                if (pos < n->m_count)
+                    return ((node4_t*)n)->m_children[pos++];
+                return nullptr;
+            case NODE16:
+                if (pos < n->m_count)
+                    return ((node16_t*)n)->m_children[pos++];
+                return nullptr;
+            case NODE48:
+            {
+                node48_t* n48 = (node48_t*)n;
+                while (pos < 256)
+                {
+                    xbyte const index = n48->m_index[pos++];
+                    if (index != 0)
+                        return n48->m_children[index - 1];
+                }
+                return nullptr;
+            }
+        }
+        node256_t* n256 = (node256_t*)n;
+        while (pos < 256)
+        {
+            node_t* child = n256->m_children[pos++];
+            if (child != nullptr)
+                return child;
+        }
+        return nullptr;
+    }
+
+    // The leaf with the smallest key, a key that ends at a node is smaller
+    // than all the keys below it
+    static leaf_t* s_min_leaf(node_t* n)
+    {
+        while (!s_is_leaf(n))
+        {
+            if (n->m_leaf != nullptr)
+                return n->m_leaf;
+            s32 pos = 0;
+            n       = s_next_child(n, pos);
+        }
+        return s_to_leaf(n);
+    }
+
+    // Number of prefix bytes of @n that match @key at @depth, bytes that are
+    // not stored in the node are compared against a leaf.
+    static u32 s_prefix_mismatch(node_t* n, cbuffer_t const& key, u32 depth)
+    {
+        u32 const max = xmin(n->m_prefix_len, key.m_len - depth);
+        u32       i   = 0;
+        for (; i < max && i < art_t::MAX_PREFIX; ++i)
+        {
+            if (n->m_prefix[i] != key.m_const[depth + i])
+                return i;
+        }
+        if (i < max)
+        {
+            leaf_t const* l = s_min_leaf(n);
+            for (; i < max; ++i)
+            {
+                if (l->key()[depth + i] != key.m_const[depth + i])
+                    return i;
+            }
+        }
+        return i;
+    }
+
+    // Compare only the stored prefix bytes, the full key is verified at the leaf
+    static inline bool s_prefix_matches(node_t const* n, cbuffer_t const& key, u32 depth)
+    {
+        if ((depth + n->m_prefix_len) > key.m_len)
+            return false;
+        u32 const len = xmin(n->m_prefix_len, (u32)art_t::MAX_PREFIX);
+        return x_memcmp(n->m_prefix, key.m_const + depth, len) == 0;
+    }
+
+    static void s_add_child(alloc_t* a, node_t** ref, xbyte b, node_t* child)
+    {
+        node_t* n = *ref;
+        switch (n->m_type)
+        {
+            case NODE4:
+            {
+                node4_t* n4 = (node4_t*)n;
+                if (n4->m_count < 4)
+                {
+                    u32 const pos = s_lower_bound4(n4->m_keys, n4->m_count, b);
+                    xmem::memmove(n4->m_keys + pos + 1, n4->m_keys + pos, n4->m_count - pos);
+                    xmem::memmove(n4->m_children + pos + 1, n4->m_children + pos, (n4->m_count - pos) * sizeof(node_t*));
+                    n4->m_keys[pos]     = b;
+                    n4->m_children[pos] = child;
+                    n4->m_count += 1;
+                    return;
+                }
+                node16_t* n16 = (node16_t*)s_new_node(a, NODE16);
+                s_copy_header(n16, n4);
+                x_memcpy(n16->m_keys, n4->m_keys, 4);
+                x_memcpy(n16->m_children, n4->m_children, 4 * sizeof(node_t*));
+                a->deallocate(n4);
+                *ref = n16;
+                break;
+            }
+            case NODE16:
+            {
+                node16_t* n16 = (node16_t*)n;
+                if (n16->m_count < 16)
+                {
+                    u32 const pos = s_lower_bound16(n16->m_keys, n16->m_count, b);
+                    xmem::memmove(n16->m_keys + pos + 1, n16->m_keys + pos, n16->m_count - pos);
+                    xmem::memmove(n16->m_children + pos + 1, n16->m_children + pos, (n16->m_count - pos) * sizeof(node_t*));
+                    n16->m_keys[pos]     = b;
+                    n16->m_children[pos] = child;
+                    n16->m_count += 1;
+                    return;
+                }
+                node48_t* n48 = (node48_t*)s_new_node(a, NODE48);
+                s_copy_header(n48, n16);
+                for (u32 i = 0; i < 16; ++i)
+                {
+                    n48->m_index[n16->m_keys[i]] = (xbyte)(i + 1);
+                    n48->m_children[i]           = n16->m_children[i];
+                }
+                a->deallocate(n16);
+                *ref = n48;
+                break;
+            }
+            case NODE48:
+            {
+                node48_t* n48 = (node48_t*)n;
+                if (n48->m_count < 48)
+                {
+                    u32 slot = 0;
+                    while (n48->m_children[slot] != nullptr)
+                        ++slot;
+                    n48->m_index[b]        = (xbyte)(slot + 1);
+                    n48->m_children[slot] = child;
+                    n48->m_count += 1;
+                    return;
+                }
+                node256_t* n256 = (node256_t*)s_new_node(a, NODE256);
+                s_copy_header(n256, n48);
+                for (u32 i = 0; i < 256; ++i)
+                {
+                    if (n48->m_index[i] != 0)
+                        n256->m_children[i] = n48->m_children[n48->m_index[i] - 1];
+                }
+                a->deallocate(n48);
+                *ref = n256;
+                break;
+            }
+            case NODE256:
+            {
+                node256_t* n256     = (node256_t*)n;
+                n256->m_children[b] = child;
+                n256->m_count += 1;
+                return;
+            }
+        }
+
+        // The node was grown, now it has room
+        s_add_child(a, ref, b, child);
+    }
+
+    // A node4 with a single child and no key of its own is merged with its
+    // child, a node4 without children is replaced by its key.
+    static void s_compact(alloc_t* a, node_t** ref)
+    {
+        node4_t* n4 = (node4_t*)*ref;
+        if (n4->m_type != NODE4)
+            return;
+
+        if (n4->m_count == 0)
+        {
+            *ref = n4->m_leaf != nullptr ? s_tag(n4->m_leaf) : nullptr;
+            a->deallocate(n4);
+        }
+        else if (n4->m_count == 1 && n4->m_leaf == nullptr)
+        {
+            node_t* child = n4->m_children[0];
+            if (!s_is_leaf(child))
+            {
+                // child prefix = our prefix + key byte + child prefix
+                xbyte prefix[art_t::MAX_PREFIX];
+                u32   len = xmin(n4->m_prefix_len, (u32)art_t::MAX_PREFIX);
+                x_memcpy(prefix, n4->m_prefix, len);
+                if (len < art_t::MAX_PREFIX)
+                    prefix[len++] = n4->m_keys[0];
+                u32 const tail = xmin(child->m_prefix_len, (u32)art_t::MAX_PREFIX - len);
+                x_memcpy(prefix + len, child->m_prefix, tail);
+                x_memcpy(child->m_prefix, prefix, len + tail);
+                child->m_prefix_len += n4->m_prefix_len + 1;
+            }
+            *ref = child;
+            a->deallocate(n4);
+        }
+    }
+
+    static void s_remove_child(alloc_t* a, node_t** ref, xbyte b, node_t** slot)
+    {
+        node_t* n = *ref;
+        switch (n->m_type)
+        {
+            case NODE4:
+            {
+                node4_t*  n4  = (node4_t*)n;
+                u32 const pos = (u32)(slot - n4->m_children);
+                xmem::memmove(n4->m_keys + pos, n4->m_keys + pos + 1, n4->m_count - pos - 1);
+                xmem::memmove(n4->m_children + pos, n4->m_children + pos + 1, (n4->m_count - pos - 1) * sizeof(node_t*));
+                n4->m_count -= 1;
+                break;
+            }
+            case NODE16:
+            {
+                node16_t* n16 = (node16_t*)n;
+                u32 const pos = (u32)(slot - n16->m_children);
+                xmem::memmove(n16->m_keys + pos, n16->m_keys + pos + 1, n16->m_count - pos - 1);
+                xmem::memmove(n16->m_children + pos, n16->m_children + pos + 1, (n16->m_count - pos - 1) * sizeof(node_t*));
+                n16->m_count -= 1;
+                if (n16->m_count <= 3)
+                {
+                    node4_t* n4 = (node4_t*)s_new_node(a, NODE4);
+                    s_copy_header(n4, n16);
+                    x_memcpy(n4->m_keys, n16->m_keys, n16->m_count);
+                    x_memcpy(n4->m_children, n16->m_children, n16->m_count * sizeof(node_t*));
+                    a->deallocate(n16);
+                    *ref = n4;
+                }
+                break;
+            }
+            case NODE48:
+            {
+                node48_t* n48                        = (node48_t*)n;
+                n48->m_children[n48->m_index[b] - 1] = nullptr;
+                n48->m_index[b]                      = 0;
+                n48->m_count -= 1;
+                if (n48->m_count <= 12)
+                {
+                    node16_t* n16 = (node16_t*)s_new_node(a, NODE16);
+                    s_copy_header(n16, n48);
+                    u32 count = 0;
+                    for (u32 i = 0; i < 256; ++i)
+                    {
+                        if (n48->m_index[i] != 0)
+                        {
+                            n16->m_keys[count]     = (xbyte)i;
+                            n16->m_children[count] = n48->m_children[n48->m_index[i] - 1];
+                            ++count;
+                        }
+                    }
+                    a->deallocate(n48);
+                    *ref = n16;
+                }
+                break;
+            }
+            case NODE256:
+            {
+                node256_t* n256     = (node256_t*)n;
+                n256->m_children[b] = nullptr;
+                n256->m_count -= 1;
+                if (n256->m_count <= 37)
+                {
+                    node48_t* n48 = (node48_t*)s_new_node(a, NODE48);
+                    s_copy_header(n48, n256);
+                    u32 count = 0;
+                    for (u32 i = 0; i < 256; ++i)
+                    {
+                        if (n256->m_children[i] != nullptr)
+                        {
+                            n48->m_index[i]        = (xbyte)(count + 1);
+                            n48->m_children[count] = n256->m_children[i];
+                            ++count;
+                        }
+                    }
+                    a->deallocate(n256);
+                    *ref = n48;
+                }
+                break;
+            }
+        }
+        s_compact(a, ref);
+    }
+
+    art_t::art_t(alloc_t* a) : m_allocator(a), m_root(nullptr), m_size(0)
+    {
+        if (m_allocator == nullptr)
+        {
+            m_allocator = alloc_t::get_system();
+        }
+    }
+
+    art_t::~art_t() { clear(); }
+
+    void art_t::clear()
+    {
+        free_node(m_root);
+        m_root = nullptr;
+        m_size = 0;
+    }
+
+    void art_t::free_node(node_t* n)
+    {
+        if (n == nullptr)
+            return;
+        if (s_is_leaf(n))
+        {
+            m_allocator->deallocate(s_to_leaf(n));
+            return;
+        }
+        if (n->m_leaf != nullptr)
+            m_allocator->deallocate(n->m_leaf);
+        s32     pos = 0;
+        node_t* child;
+        while ((child = s_next_child(n, pos)) != nullptr)
+            free_node(child);
+        m_allocator->deallocate(n);
+    }
+
+    bool art_t::insert(cbuffer_t const& key, void* value)
+    {
+        if (!insert(&m_root, 0, key, value))
+            return false;
+        m_size += 1;
+        return true;
+    }
+
+    bool art_t::insert(node_t** ref, u32 depth, cbuffer_t const& key, void* value)
+    {
+        node_t* n = *ref;
+        if (n == nullptr)
+        {
+            *ref = s_tag(s_new_leaf(m_allocator, key, value));
+            return true;
+        }
+
+        if (s_is_leaf(n))
+        {
+            leaf_t* l = s_to_leaf(n);
+            if (s_leaf_matches(l, key))
+            {
+                l->m_value = value;
+                return false;
+            }
+
+            // Split the leaf into a node4 holding the common prefix
+            u32 const max = xmin(l->m_len, key.m_len);
+            u32       lcp = depth;
+            while (lcp < max && l->key()[lcp] == key.m_const[lcp])
+                ++lcp;
+
+            node_t* nn       = s_new_node(m_allocator, NODE4);
+            nn->m_prefix_len = lcp - depth;
+            x_memcpy(nn->m_prefix, key.m_const + depth, xmin(nn->m_prefix_len, (u32)MAX_PREFIX));
+
+            leaf_t* nl = s_new_leaf(m_allocator, key, value);
+            if (l->m_len == lcp)
+                nn->m_leaf = l;
+            else
+                s_add_child(m_allocator, &nn, l->key()[lcp], n);
+            if (key.m_len == lcp)
+                nn->m_leaf = nl;
+            else
+                s_add_child(m_allocator, &nn, key.m_const[lcp], s_tag(nl));
+            *ref = nn;
+            return true;
+        }
+
+        if (n->m_prefix_len > 0)
+        {
+            u32 const mismatch = s_prefix_mismatch(n, key, depth);
+            if (mismatch < n->m_prefix_len)
+            {
+                // Split the prefix, the new node4 holds the part that matches
+                node_t* nn       = s_new_node(m_allocator, NODE4);
+                nn->m_prefix_len = mismatch;
+                x_memcpy(nn->m_prefix, n->m_prefix, xmin(mismatch, (u32)MAX_PREFIX));
+
+                xbyte b;
+                if (n->m_prefix_len <= MAX_PREFIX)
+                {
+                    b = n->m_prefix[mismatch];
+                    n->m_prefix_len -= mismatch + 1;
+                    xmem::memmove(n->m_prefix, n->m_prefix + mismatch + 1, n->m_prefix_len);
+                }
+                else
+                {
+                    leaf_t const* l = s_min_leaf(n);
+                    b               = l->key()[depth + mismatch];
+                    n->m_prefix_len -= mismatch + 1;
+                    x_memcpy(n->m_prefix, l->key() + depth + mismatch + 1, xmin(n->m_prefix_len, (u32)MAX_PREFIX));
+                }
+                s_add_child(m_allocator, &nn, b, n);
+
+                leaf_t* nl = s_new_leaf(m_allocator, key, value);
+                if (key.m_len == (depth + mismatch))
+                    nn->m_leaf = nl;
+                else
+                    s_add_child(m_allocator, &nn, key.m_const[depth + mismatch], s_tag(nl));
+                *ref = nn;
+                return true;
+            }
+            depth += n->m_prefix_len;
+        }
+
+        if (depth == key.m_len)
+        {
+            if (n->m_leaf != nullptr)
+            {
+                n->m_leaf->m_value = value;
+                return false;
+            }
+            n->m_leaf = s_new_leaf(m_allocator, key, value);
+            return true;
+        }
+
+        node_t** child = s_find_child(n, key.m_const[depth]);
+        if (child != nullptr)
+            return insert(child, depth + 1, key, value);
+
+        s_add_child(m_allocator, ref, key.m_const[depth], s_tag(s_new_leaf(m_allocator, key, value)));
+        return true;
+    }
+
+    bool art_t::remove(cbuffer_t const& key)
+    {
+        void* value;
+        return remove(key, value);
+    }
+
+    bool art_t::remove(cbuffer_t const& key, void*& value)
+    {
+        if (!remove(&m_root, 0, key, value))
+            return false;
+        m_size -= 1;
+        return true;
+    }
+
+    bool art_t::remove(node_t** ref, u32 depth, cbuffer_t const& key, void*& value)
+    {
+        node_t* n = *ref;
+        if (n == nullptr)
+            return false;
+
+        if (s_is_leaf(n))
+        {
+            leaf_t* l = s_to_leaf(n);
+            if (!s_leaf_matches(l, key))
+                return false;
+            value = l->m_value;
+            m_allocator->deallocate(l);
+            *ref = nullptr;
+            return true;
+        }
+
+        if (!s_prefix_matches(n, key, depth))
+            return false;
+        depth += n->m_prefix_len;
+
+        if (depth == key.m_len)
+        {
+            leaf_t* l = n->m_leaf;
+            if (l == nullptr || !s_leaf_matches(l, key))
+                return false;
+            value = l->m_value;
+            m_allocator->deallocate(l);
+            n->m_leaf = nullptr;
+            s_compact(m_allocator, ref);
+            return true;
+        }
+
+        node_t** child = s_find_child(n, key.m_const[depth]);
+        if (child == nullptr)
+            return false;
+
+        if (s_is_leaf(*child))
+        {
+            leaf_t* l = s_to_leaf(*child);
+            if (!s_leaf_matches(l, key))
+                return false;
+            value = l->m_value;
+            m_allocator->deallocate(l);
+            s_remove_child(m_allocator, ref, key.m_const[depth], child);
+            return true;
+        }
+        return remove(child, depth + 1, key, value);
+    }
+
+    bool art_t::find(cbuffer_t const& key, void*& value) const
+    {
+        node_t* n     = m_root;
+        u32     depth = 0;
+        while (n != nullptr)
+        {
+            if (s_is_leaf(n))
+            {
+                leaf_t const* l = s_to_leaf(n);
+                if (!s_leaf_matches(l, key))
+                    return false;
+                value = l->m_value;
+                return true;
+            }
+
+            if (!s_prefix_matches(n, key, depth))
+                return false;
+            depth += n->m_prefix_len;
+
+            if (depth == key.m_len)
+            {
+                leaf_t const* l = n->m_leaf;
+                if (l == nullptr || !s_leaf_matches(l, key))
+                    return false;
+                value = l->m_value;
+                return true;
+            }
+
+            node_t** child = s_find_child(n, key.m_const[depth]);
+            if (child == nullptr)
+                return false;
+            n = *child;
+            depth += 1;
+        }
+        return false;
+    }
+
+    bool art_t::contains(cbuffer_t const& key) const
+    {
+        void* value;
+        return find(key, value);
+    }
+
+    // m_pos is -1 before the key of the node itself is visited
+    struct art_t::iter_t::frame_t
+    {
+        node_t* m_node;
+        s32     m_pos;
+    };
+
+    art_t::iter_t::iter_t(art_t const& tree) : m_tree(&tree), m_stack(nullptr), m_depth(0), m_capacity(0)
+    {
+        if (tree.m_root != nullptr)
+            push(tree.m_root);
+    }
+
+    art_t::iter_t::iter_t(art_t const& tree, cbuffer_t const& prefix) : m_tree(&tree), m_stack(nullptr), m_depth(0), m_capacity(0)
+    {
+        // Find the subtree where all keys share the first prefix.m_len bytes,
+        // then check that those bytes are @prefix.
+        node_t* n     = tree.m_root;
+        u32     depth = 0;
+        while (n != nullptr && !s_is_leaf(n))
+        {
+            if ((depth + n->m_prefix_len) >= prefix.m_len)
+                break;
+            depth += n->m_prefix_len;
+            node_t** child = s_find_child(n, prefix.m_const[depth]);
+            n              = child != nullptr ? *child : nullptr;
+            depth += 1;
+        }
+
+        if (n != nullptr)
+        {
+            leaf_t const* l = s_min_leaf(n);
+            if (l->m_len >= prefix.m_len && x_memcmp(l->key(), prefix.m_const, prefix.m_len) == 0)
+                push(n);
+        }
+    }
+
+    art_t::iter_t::~iter_t()
+    {
+        if (m_stack != nullptr)
+            m_tree->m_allocator->deallocate(m_stack);
+    }
+
+    void art_t::iter_t::push(node_t* node)
+    {
+        if (m_depth == m_capacity)
+        {
+            s32 const capacity = m_capacity == 0 ? 32 : m_capacity * 2;
+            frame_t*  stack    = (frame_t*)m_tree->m_allocator->allocate(capacity * sizeof(frame_t), sizeof(void*));
+            if (m_stack != nullptr)
+            {
+                x_memcpy(stack, m_stack, m_depth * sizeof(frame_t));
+                m_tree->m_allocator->deallocate(m_stack);
+            }
+            m_stack    = stack;
+            m_capacity = capacity;
+        }
+        m_stack[m_depth].m_node = node;
+        m_stack[m_depth].m_pos  = -1;
+        m_depth += 1;
+    }
+
+    bool art_t::iter_t::next(cbuffer_t& key, void*& value)
+    {
+        while (m_depth > 0)
+        {
+            frame_t& f = m_stack[m_depth - 1];
+            leaf_t*  l = nullptr;
+            if (s_is_leaf(f.m_node))
+            {
+                l = s_to_leaf(f.m_node);
+                m_depth -= 1;
+            }
+            else
+            {
+                if (f.m_pos < 0)
+                {
+                    f.m_pos = 0;
+                    l       = f.m_node->m_leaf;
+                }
+                if (l == nullptr)
+                {
+                    node_t* child = s_next_child(f.m_node, f.m_pos);
+                    if (child == nullptr)
+                    {
+                        m_depth -= 1;
+                        continue;
+                    }
+                    if (!s_is_leaf(child))
+                    {
+                        push(child);
+                        continue;
+                    }
+                    l = s_to_leaf(child);
+                }
+            }
+
+            key   = cbuffer_t(l->m_len, l->key());
+            value = l->m_value;
+            return true;
+        }
+        return false;
+    }
+
+}; // namespace xcore
@@ -721,7 +721,7 @@ namespace xcore
                 if (is_node(node->m_nodes[child]))
                 {
                     m_node[level]    = node;
-                    m_child[level++] = child;
+                    m_child[level++] = child + 1; // resume after this child
                     m_node[level]    = as_node_ptr(node->m_nodes[child]);
                     m_child[level++] = 0;
                     break;
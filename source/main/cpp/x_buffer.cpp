@@ -1,6 +1,7 @@
 #include "xbase/x_target.h"
 #include "xbase/x_base.h"
 #include "xbase/x_buffer.h"
+#include "xbase/x_crc.h"
 #include "xbase/x_runes.h"
 
 namespace xcore
@@ -99,36 +100,36 @@ namespace xcore
         static inline void write_u32(xbyte* ptr, u32 b)
         {
             write_u16(ptr, (u16)((b >> 0) & 0xFFFF));
-            write_u16(ptr, (u16)((b >> 16) & 0xFFFF));
+            write_u16(ptr + 2, (u16)((b >> 16) & 0xFFFF));
         }
         static inline void write_s32(xbyte* ptr, s32 b)
         {
             u32 const c = *((u32*)&b);
             write_u16(ptr, (u16)((c >> 0) & 0xFFFF));
-            write_u16(ptr, (u16)((c >> 16) & 0xFFFF));
+            write_u16(ptr + 2, (u16)((c >> 16) & 0xFFFF));
         }
         static inline void write_f32(xbyte* ptr, f32 f)
         {
             u32 const c = *((u32*)&f);
             write_u16(ptr, (u16)((c >> 0) & 0xFFFF));
-            write_u16(ptr, (u16)((c >> 16) & 0xFFFF));
+            write_u16(ptr + 2, (u16)((c >> 16) & 0xFFFF));
         }
         static inline void write_u64(xbyte* ptr, u64 b)
         {
-            write_u16(ptr, (u32)((b >> 0) & 0xFFFFFFFF));
-            write_u16(ptr, (u32)((b >> 32) & 0xFFFFFFFF));
+            write_u32(ptr, (u32)((b >> 0) & 0xFFFFFFFF));
+            write_u32(ptr + 4, (u32)((b >> 32) & 0xFFFFFFFF));
         }
         static inline void write_s64(xbyte* ptr, s64 b)
         {
             u64 const c = *((u64*)&b);
             write_u32(ptr, (u32)((c >> 0) & 0xFFFFFFFF));
-            write_u32(ptr, (u32)((c >> 32) & 0xFFFFFFFF));
+            write_u32(ptr + 4, (u32)((c >> 32) & 0xFFFFFFFF));
         }
         static inline void write_f64(xbyte* ptr, f64 f)
         {
             u64 const c = *((u64*)&f);
             write_u32(ptr, (u32)((c >> 0) & 0xFFFFFFFF));
-            write_u32(ptr, (u32)((c >> 32) & 0xFFFFFFFF));
+            write_u32(ptr + 4, (u32)((c >> 32) & 0xFFFFFFFF));
         }
     } // namespace xuadrw
 
@@ -534,6 +535,16 @@ namespace xcore
         return offset;
     }
 
+    void binary_reader_t::begin_frame() { m_frame = m_cursor; }
+
+    bool binary_reader_t::end_frame()
+    {
+        if (m_frame > m_cursor || !can_read(sizeof(u32)))
+            return false;
+        u32 const crc = crc32c(m_buffer + m_frame, m_cursor - m_frame);
+        return read_u32() == crc;
+    }
+
     /// ---------------------------------------------------------------------------------------
     /// Binary Writer
     /// ---------------------------------------------------------------------------------------
@@ -822,4 +833,13 @@ namespace xcore
         return -1;
     }
 
+    void binary_writer_t::begin_frame() { m_frame = m_cursor; }
+
+    s32 binary_writer_t::end_frame()
+    {
+        if (m_frame > m_cursor)
+            return -1;
+        return write(crc32c(m_buffer + m_frame, m_cursor - m_frame));
+    }
+
 } // namespace xcore
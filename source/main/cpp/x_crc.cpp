@@ -0,0 +1,249 @@
+#include "xbase/x_target.h"
+#include "xbase/x_debug.h"
+#include "xbase/x_endian.h"
+
+#include "xbase/x_crc.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#    define X_CRC_SSE42
+#    include <nmmintrin.h>
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#        define X_CRC_TARGET_SSE42
+#    else
+#        define X_CRC_TARGET_SSE42 __attribute__((target("sse4.2")))
+#    endif
+#endif
+
+namespace xcore
+{
+    static const u32 sCrc32cPoly = 0x82f63b78; // reflected
+
+    // The 3-way interleaved streams are combined by shifting the CRC of a
+    // stream over the length of the streams that follow it, a shift over a
+    // fixed length is a linear operator that is precomputed as 4 x 256 tables.
+    enum
+    {
+        CRC_LONG  = 8192,
+        CRC_SHORT = 256,
+    };
+
+    static u32 s_gf2_matrix_times(u32 const* mat, u32 vec)
+    {
+        u32 sum = 0;
+        while (vec != 0)
+        {
+            if (vec & 1)
+                sum ^= *mat;
+            vec >>= 1;
+            mat++;
+        }
+        return sum;
+    }
+
+    static void s_gf2_matrix_square(u32* square, u32 const* mat)
+    {
+        for (s32 n = 0; n < 32; n++)
+            square[n] = s_gf2_matrix_times(mat, mat[n]);
+    }
+
+    // The operator that appends @len zero bytes to a message
+    static void s_crc32c_zeros_op(u32* even, u32 len)
+    {
+        u32 odd[32];
+        odd[0]  = sCrc32cPoly;
+        u32 row = 1;
+        for (s32 n = 1; n < 32; n++)
+        {
+            odd[n] = row;
+            row <<= 1;
+        }
+
+        s_gf2_matrix_square(even, odd); // 2 zero bits
+        s_gf2_matrix_square(odd, even); // 4 zero bits
+
+        // The first square puts the operator for one zero byte (8 zero bits) in even
+        do
+        {
+            s_gf2_matrix_square(even, odd);
+            len >>= 1;
+            if (len == 0)
+                return;
+            s_gf2_matrix_square(odd, even);
+            len >>= 1;
+        } while (len != 0);
+
+        for (s32 n = 0; n < 32; n++)
+            even[n] = odd[n];
+    }
+
+    static void s_crc32c_zeros(u32 zeros[4][256], u32 len)
+    {
+        u32 op[32];
+        s_crc32c_zeros_op(op, len);
+        for (u32 n = 0; n < 256; n++)
+        {
+            zeros[0][n] = s_gf2_matrix_times(op, n);
+            zeros[1][n] = s_gf2_matrix_times(op, n << 8);
+            zeros[2][n] = s_gf2_matrix_times(op, n << 16);
+            zeros[3][n] = s_gf2_matrix_times(op, n << 24);
+        }
+    }
+
+    static inline u32 s_crc32c_shift(u32 const zeros[4][256], u32 crc) { return zeros[0][crc & 0xff] ^ zeros[1][(crc >> 8) & 0xff] ^ zeros[2][(crc >> 16) & 0xff] ^ zeros[3][crc >> 24]; }
+
+    struct crc32c_tables_t
+    {
+        crc32c_tables_t()
+        {
+            for (u32 n = 0; n < 256; n++)
+            {
+                u32 crc = n;
+                for (s32 k = 0; k < 8; k++)
+                    crc = (crc & 1) ? (crc >> 1) ^ sCrc32cPoly : crc >> 1;
+                m_slice[0][n] = crc;
+            }
+            for (u32 n = 0; n < 256; n++)
+            {
+                u32 crc = m_slice[0][n];
+                for (s32 k = 1; k < 8; k++)
+                {
+                    crc           = m_slice[0][crc & 0xff] ^ (crc >> 8);
+                    m_slice[k][n] = crc;
+                }
+            }
+            s_crc32c_zeros(m_long, CRC_LONG);
+            s_crc32c_zeros(m_short, CRC_SHORT);
+        }
+
+        u32 m_slice[8][256];
+        u32 m_long[4][256];
+        u32 m_short[4][256];
+    };
+
+    static crc32c_tables_t const& s_crc32c_tables()
+    {
+        static crc32c_tables_t tables;
+        return tables;
+    }
+
+    static u32 s_crc32c_sw(u32 const slice[8][256], u32 crc, xbyte const* next, u32 len)
+    {
+        while (len > 0 && ((uptr)next & 7) != 0)
+        {
+            crc = slice[0][(crc ^ *next++) & 0xff] ^ (crc >> 8);
+            len--;
+        }
+        while (len >= 8)
+        {
+            u32 lo, hi;
+            ::memcpy(&lo, next, sizeof(lo));
+            ::memcpy(&hi, next + 4, sizeof(hi));
+            lo = x_IntelEndian::swap(lo) ^ crc;
+            hi = x_IntelEndian::swap(hi);
+            crc = slice[7][lo & 0xff] ^ slice[6][(lo >> 8) & 0xff] ^ slice[5][(lo >> 16) & 0xff] ^ slice[4][lo >> 24] ^ slice[3][hi & 0xff] ^ slice[2][(hi >> 8) & 0xff] ^ slice[1][(hi >> 16) & 0xff] ^ slice[0][hi >> 24];
+            next += 8;
+            len -= 8;
+        }
+        while (len > 0)
+        {
+            crc = slice[0][(crc ^ *next++) & 0xff] ^ (crc >> 8);
+            len--;
+        }
+        return crc;
+    }
+
+#ifdef X_CRC_SSE42
+    static inline u64 s_load64(xbyte const* p)
+    {
+        u64 v;
+        ::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    X_CRC_TARGET_SSE42 static u32 s_crc32c_hw(crc32c_tables_t const& tables, u32 crc, xbyte const* next, u32 len)
+    {
+        u64 crc0 = crc;
+        while (len > 0 && ((uptr)next & 7) != 0)
+        {
+            crc0 = _mm_crc32_u8((u32)crc0, *next++);
+            len--;
+        }
+
+        // 3 streams of CRC_LONG bytes, then 3 streams of CRC_SHORT bytes
+        while (len >= CRC_LONG * 3)
+        {
+            u64                crc1 = 0;
+            u64                crc2 = 0;
+            xbyte const* const end  = next + CRC_LONG;
+            do
+            {
+                crc0 = _mm_crc32_u64(crc0, s_load64(next));
+                crc1 = _mm_crc32_u64(crc1, s_load64(next + CRC_LONG));
+                crc2 = _mm_crc32_u64(crc2, s_load64(next + CRC_LONG * 2));
+                next += 8;
+            } while (next < end);
+            crc0 = s_crc32c_shift(tables.m_long, (u32)crc0) ^ crc1;
+            crc0 = s_crc32c_shift(tables.m_long, (u32)crc0) ^ crc2;
+            next += CRC_LONG * 2;
+            len -= CRC_LONG * 3;
+        }
+        while (len >= CRC_SHORT * 3)
+        {
+            u64                crc1 = 0;
+            u64                crc2 = 0;
+            xbyte const* const end  = next + CRC_SHORT;
+            do
+            {
+                crc0 = _mm_crc32_u64(crc0, s_load64(next));
+                crc1 = _mm_crc32_u64(crc1, s_load64(next + CRC_SHORT));
+                crc2 = _mm_crc32_u64(crc2, s_load64(next + CRC_SHORT * 2));
+                next += 8;
+            } while (next < end);
+            crc0 = s_crc32c_shift(tables.m_short, (u32)crc0) ^ crc1;
+            crc0 = s_crc32c_shift(tables.m_short, (u32)crc0) ^ crc2;
+            next += CRC_SHORT * 2;
+            len -= CRC_SHORT * 3;
+        }
+
+        while (len >= 8)
+        {
+            crc0 = _mm_crc32_u64(crc0, s_load64(next));
+            next += 8;
+            len -= 8;
+        }
+        while (len > 0)
+        {
+            crc0 = _mm_crc32_u8((u32)crc0, *next++);
+            len--;
+        }
+        return (u32)crc0;
+    }
+
+    static bool s_cpu_has_sse42()
+    {
+#    if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 20)) != 0;
+#    else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.2") != 0;
+#    endif
+    }
+#endif
+
+    u32 crc32c(xbyte const* data, u32 size, u32 crc)
+    {
+        crc32c_tables_t const& tables = s_crc32c_tables();
+#ifdef X_CRC_SSE42
+        static bool const s_hw = s_cpu_has_sse42();
+        if (s_hw)
+            return ~s_crc32c_hw(tables, ~crc, data, size);
+#endif
+        return ~s_crc32c_sw(tables.m_slice, ~crc, data, size);
+    }
+
+}; // namespace xcore
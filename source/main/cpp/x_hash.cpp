@@ -1,43 +1,63 @@
 #include "xbase/x_target.h"
+#include "xbase/x_allocator.h"
+#include "xbase/x_buffer.h"
 #include "xbase/x_debug.h"
+#include "xbase/x_endian.h"
+#include "xbase/x_integer.h"
+#include "xbase/x_jobs.h"
 #include "xbase/x_hash.h"
 
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#    define X_HASH_SSE2
+#    include <emmintrin.h>
+#    if defined(_MSC_VER)
+#        include <immintrin.h>
+#        include <intrin.h>
+#        define X_HASH_AVX2
+#        define X_HASH_TARGET_AVX2
+#    elif defined(__GNUC__)
+#        include <immintrin.h>
+#        define X_HASH_AVX2
+#        define X_HASH_TARGET_AVX2 __attribute__((target("avx2")))
+#    endif
+#endif
+
 namespace xcore
 {
+    static constexpr u32 PRIME32_1 = 0x9E3779B1U;
+    static constexpr u32 PRIME32_2 = 0x85EBCA77U;
+    static constexpr u32 PRIME32_3 = 0xC2B2AE3DU;
+
     static constexpr u64 PRIME64_1 = 11400714785074694791ULL;
     static constexpr u64 PRIME64_2 = 14029467366897019727ULL;
     static constexpr u64 PRIME64_3 = 1609587929392839161ULL;
     static constexpr u64 PRIME64_4 = 9650029242287828579ULL;
     static constexpr u64 PRIME64_5 = 2870177450012600261ULL;
 
+    static constexpr u64 PRIME_MX1 = 0x165667919E3779F9ULL;
+    static constexpr u64 PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
 #define XXH_rotl32(x, r) ((x << r) | (x >> (32 - r)))
 #define XXH_rotl64(x, r) ((x << r) | (x >> (64 - r)))
 
-    static u32 XXH_get32bits(const void* memPtr)
+    // Unaligned little-endian loads, the memcpy compiles to a single load
+    static inline u32 XXH_get32bits(const void* memPtr)
     {
-        xbyte const* bptr = (xbyte const*)memPtr;
-        u32          val  = bptr[0];
-        val               = val << 8 | bptr[1];
-        val               = val << 8 | bptr[2];
-        val               = val << 8 | bptr[3];
-        return val;
+        u32 val;
+        ::memcpy(&val, memPtr, sizeof(val));
+        return x_IntelEndian::swap(val);
     }
 
-    static u64 XXH_get64bits(const void* memPtr)
+    static inline u64 XXH_get64bits(const void* memPtr)
     {
-        xbyte const* bptr = (xbyte const*)memPtr;
-        u64          val  = bptr[0];
-        val               = val << 8 | bptr[1];
-        val               = val << 8 | bptr[2];
-        val               = val << 8 | bptr[3];
-        val               = val << 8 | bptr[4];
-        val               = val << 8 | bptr[5];
-        val               = val << 8 | bptr[6];
-        val               = val << 8 | bptr[7];
-        return val;
+        u64 val;
+        ::memcpy(&val, memPtr, sizeof(val));
+        return x_IntelEndian::swap(val);
     }
 
-    static u64 XXH64_round(u64 acc, u64 input)
+    static inline u64 XXH64_round(u64 acc, u64 input)
     {
         acc += input * PRIME64_2;
         acc = XXH_rotl64(acc, 31);
@@ -45,7 +65,7 @@ namespace xcore
         return acc;
     }
 
-    static u64 XXH64_mergeRound(u64 acc, u64 val)
+    static inline u64 XXH64_mergeRound(u64 acc, u64 val)
     {
         val = XXH64_round(0, val);
         acc ^= val;
@@ -53,9 +73,19 @@ namespace xcore
         return acc;
     }
 
-    u64 XXH64(const void* input, u32 len, u64 seed = PRIME64_4)
+    static inline u64 XXH64_avalanche(u64 h64)
     {
-        const xbyte* p    = (const xbyte*)input;
+        h64 ^= h64 >> 33;
+        h64 *= PRIME64_2;
+        h64 ^= h64 >> 29;
+        h64 *= PRIME64_3;
+        h64 ^= h64 >> 32;
+        return h64;
+    }
+
+    u64 xxhash64(xbyte const* input, u32 len, u64 seed)
+    {
+        const xbyte* p    = input;
         const xbyte* bEnd = p + len;
         u64          h64;
 
@@ -109,22 +139,716 @@ namespace xcore
 
         while (p < bEnd)
         {
-            h64 ^= (*p) * PRIME64_5;
+            h64 ^= (u64)(*p) * PRIME64_5;
             h64 = XXH_rotl64(h64, 11) * PRIME64_1;
             p++;
         }
 
-        h64 ^= h64 >> 33;
-        h64 *= PRIME64_2;
-        h64 ^= h64 >> 29;
-        h64 *= PRIME64_3;
-        h64 ^= h64 >> 32;
+        return XXH64_avalanche(h64);
+    }
 
-        return h64;
+    // ----------------------------------------------------------------------------
+    // XXH3
+    //
+    // Inputs up to 240 bytes are hashed with scalar code, longer inputs are
+    // processed in stripes of 64 bytes by an accumulate kernel. The kernel
+    // (scalar, SSE2 or AVX2) is selected once at runtime from what the CPU
+    // supports, all kernels give the same result.
+    // ----------------------------------------------------------------------------
+
+    enum
+    {
+        XXH3_SECRET_SIZE         = 192,
+        XXH3_SECRET_SIZE_MIN     = 136,
+        XXH3_MIDSIZE_MAX         = 240,
+        XXH3_MIDSIZE_STARTOFFSET = 3,
+        XXH3_MIDSIZE_LASTOFFSET  = 17,
+        XXH3_STRIPE_LEN          = 64,
+        XXH3_SECRET_CONSUME_RATE = 8,
+        XXH3_ACC_NB              = 8,
+        XXH3_SECRET_LASTACC      = 7,
+        XXH3_SECRET_MERGEACCS    = 11,
+    };
+
+    static const xbyte XXH3_kSecret[XXH3_SECRET_SIZE] = {
+      0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c, 0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+      0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21, 0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+      0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3, 0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+      0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d, 0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+      0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb, 0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+      0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce, 0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+    };
+
+    static inline u64 XXH_swap64(u64 x) { return x_endian_swap::swap(x); }
+    static inline u32 XXH_swap32(u32 x) { return x_endian_swap::swap(x); }
+    static inline u64 XXH_xorshift64(u64 v, s32 shift) { return v ^ (v >> shift); }
+
+    static inline hash128_t XXH_mult64to128(u64 lhs, u64 rhs)
+    {
+        hash128_t r;
+#if defined(__SIZEOF_INT128__)
+        __uint128_t const product = (__uint128_t)lhs * (__uint128_t)rhs;
+        r.m_low                   = (u64)product;
+        r.m_high                  = (u64)(product >> 64);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64))
+        r.m_low = _umul128(lhs, rhs, &r.m_high);
+#else
+        u64 const lo_lo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+        u64 const hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+        u64 const lo_hi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+        u64 const hi_hi = (lhs >> 32) * (rhs >> 32);
+        u64 const cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+        r.m_high        = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+        r.m_low         = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+#endif
+        return r;
+    }
+
+    static inline u64 XXH3_mul128_fold64(u64 lhs, u64 rhs)
+    {
+        hash128_t const product = XXH_mult64to128(lhs, rhs);
+        return product.m_low ^ product.m_high;
+    }
+
+    static inline u64 XXH3_avalanche(u64 h64)
+    {
+        h64 = XXH_xorshift64(h64, 37);
+        h64 *= PRIME_MX1;
+        return XXH_xorshift64(h64, 32);
+    }
+
+    static inline u64 XXH3_rrmxmx(u64 h64, u64 len)
+    {
+        h64 ^= XXH_rotl64(h64, 49) ^ XXH_rotl64(h64, 24);
+        h64 *= PRIME_MX2;
+        h64 ^= (h64 >> 35) + len;
+        h64 *= PRIME_MX2;
+        return XXH_xorshift64(h64, 28);
+    }
+
+    static inline u64 XXH3_mix16B(xbyte const* input, xbyte const* secret, u64 seed)
+    {
+        u64 const input_lo = XXH_get64bits(input);
+        u64 const input_hi = XXH_get64bits(input + 8);
+        return XXH3_mul128_fold64(input_lo ^ (XXH_get64bits(secret) + seed), input_hi ^ (XXH_get64bits(secret + 8) - seed));
+    }
+
+    static u64 XXH3_len_0to16_64b(xbyte const* input, u32 len, xbyte const* secret, u64 seed)
+    {
+        if (len > 8)
+        {
+            u64 const bitflip1 = (XXH_get64bits(secret + 24) ^ XXH_get64bits(secret + 32)) + seed;
+            u64 const bitflip2 = (XXH_get64bits(secret + 40) ^ XXH_get64bits(secret + 48)) - seed;
+            u64 const input_lo = XXH_get64bits(input) ^ bitflip1;
+            u64 const input_hi = XXH_get64bits(input + len - 8) ^ bitflip2;
+            u64 const acc      = len + XXH_swap64(input_lo) + input_hi + XXH3_mul128_fold64(input_lo, input_hi);
+            return XXH3_avalanche(acc);
+        }
+        if (len >= 4)
+        {
+            seed ^= (u64)XXH_swap32((u32)seed) << 32;
+            u32 const input1  = XXH_get32bits(input);
+            u32 const input2  = XXH_get32bits(input + len - 4);
+            u64 const bitflip = (XXH_get64bits(secret + 8) ^ XXH_get64bits(secret + 16)) - seed;
+            u64 const input64 = input2 + (((u64)input1) << 32);
+            return XXH3_rrmxmx(input64 ^ bitflip, len);
+        }
+        if (len > 0)
+        {
+            u32 const combined = ((u32)input[0] << 16) | ((u32)input[len >> 1] << 24) | ((u32)input[len - 1] << 0) | ((u32)len << 8);
+            u64 const bitflip  = (XXH_get32bits(secret) ^ XXH_get32bits(secret + 4)) + seed;
+            return XXH64_avalanche((u64)combined ^ bitflip);
+        }
+        return XXH64_avalanche(seed ^ (XXH_get64bits(secret + 56) ^ XXH_get64bits(secret + 64)));
+    }
+
+    static u64 XXH3_len_17to128_64b(xbyte const* input, u32 len, xbyte const* secret, u64 seed)
+    {
+        u64 acc = len * PRIME64_1;
+        if (len > 32)
+        {
+            if (len > 64)
+            {
+                if (len > 96)
+                {
+                    acc += XXH3_mix16B(input + 48, secret + 96, seed);
+                    acc += XXH3_mix16B(input + len - 64, secret + 112, seed);
+                }
+                acc += XXH3_mix16B(input + 32, secret + 64, seed);
+                acc += XXH3_mix16B(input + len - 48, secret + 80, seed);
+            }
+            acc += XXH3_mix16B(input + 16, secret + 32, seed);
+            acc += XXH3_mix16B(input + len - 32, secret + 48, seed);
+        }
+        acc += XXH3_mix16B(input + 0, secret + 0, seed);
+        acc += XXH3_mix16B(input + len - 16, secret + 16, seed);
+        return XXH3_avalanche(acc);
+    }
+
+    static u64 XXH3_len_129to240_64b(xbyte const* input, u32 len, xbyte const* secret, u64 seed)
+    {
+        u64       acc      = len * PRIME64_1;
+        u32 const nbRounds = len / 16;
+        for (u32 i = 0; i < 8; i++)
+            acc += XXH3_mix16B(input + (16 * i), secret + (16 * i), seed);
+        u64 acc_end = XXH3_mix16B(input + len - 16, secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET, seed);
+        acc         = XXH3_avalanche(acc);
+        for (u32 i = 8; i < nbRounds; i++)
+            acc_end += XXH3_mix16B(input + (16 * i), secret + (16 * (i - 8)) + XXH3_MIDSIZE_STARTOFFSET, seed);
+        return XXH3_avalanche(acc + acc_end);
+    }
+
+    // Accumulate @nbStripes stripes of 64 bytes into the 8 accumulators, the
+    // secret advances 8 bytes per stripe. Scramble mixes the accumulators at
+    // the end of every block.
+    typedef void (*xxh3_accumulate_fn)(u64* acc, xbyte const* input, xbyte const* secret, u32 nbStripes);
+    typedef void (*xxh3_scramble_fn)(u64* acc, xbyte const* secret);
+
+    static void XXH3_accumulate_scalar(u64* acc, xbyte const* input, xbyte const* secret, u32 nbStripes)
+    {
+        for (u32 n = 0; n < nbStripes; n++)
+        {
+            xbyte const* in  = input + n * XXH3_STRIPE_LEN;
+            xbyte const* key = secret + n * XXH3_SECRET_CONSUME_RATE;
+            for (u32 i = 0; i < XXH3_ACC_NB; i++)
+            {
+                u64 const data_val = XXH_get64bits(in + i * 8);
+                u64 const data_key = data_val ^ XXH_get64bits(key + i * 8);
+                acc[i ^ 1] += data_val;
+                acc[i] += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+            }
+        }
+    }
+
+    static void XXH3_scramble_scalar(u64* acc, xbyte const* secret)
+    {
+        for (u32 i = 0; i < XXH3_ACC_NB; i++)
+        {
+            u64 a = XXH_xorshift64(acc[i], 47);
+            a ^= XXH_get64bits(secret + i * 8);
+            acc[i] = a * PRIME32_1;
+        }
+    }
+
+#ifdef X_HASH_SSE2
+    static void XXH3_accumulate_sse2(u64* acc, xbyte const* input, xbyte const* secret, u32 nbStripes)
+    {
+        __m128i a[4];
+        for (u32 i = 0; i < 4; i++)
+            a[i] = _mm_loadu_si128((__m128i const*)acc + i);
+
+        for (u32 n = 0; n < nbStripes; n++)
+        {
+            __m128i const* xinput  = (__m128i const*)(input + n * XXH3_STRIPE_LEN);
+            __m128i const* xsecret = (__m128i const*)(secret + n * XXH3_SECRET_CONSUME_RATE);
+            for (u32 i = 0; i < 4; i++)
+            {
+                __m128i const data_vec    = _mm_loadu_si128(xinput + i);
+                __m128i const key_vec     = _mm_loadu_si128(xsecret + i);
+                __m128i const data_key    = _mm_xor_si128(data_vec, key_vec);
+                __m128i const data_key_lo = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+                __m128i const product     = _mm_mul_epu32(data_key, data_key_lo);
+                __m128i const data_swap   = _mm_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2));
+                a[i]                      = _mm_add_epi64(product, _mm_add_epi64(a[i], data_swap));
+            }
+        }
+
+        for (u32 i = 0; i < 4; i++)
+            _mm_storeu_si128((__m128i*)acc + i, a[i]);
+    }
+
+    static void XXH3_scramble_sse2(u64* acc, xbyte const* secret)
+    {
+        __m128i const prime32 = _mm_set1_epi32((int)PRIME32_1);
+        for (u32 i = 0; i < 4; i++)
+        {
+            __m128i const acc_vec     = _mm_loadu_si128((__m128i const*)acc + i);
+            __m128i const data_vec    = _mm_xor_si128(acc_vec, _mm_srli_epi64(acc_vec, 47));
+            __m128i const data_key    = _mm_xor_si128(data_vec, _mm_loadu_si128((__m128i const*)secret + i));
+            __m128i const data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+            __m128i const prod_lo     = _mm_mul_epu32(data_key, prime32);
+            __m128i const prod_hi     = _mm_mul_epu32(data_key_hi, prime32);
+            _mm_storeu_si128((__m128i*)acc + i, _mm_add_epi64(prod_lo, _mm_slli_epi64(prod_hi, 32)));
+        }
+    }
+#endif
+
+#ifdef X_HASH_AVX2
+    X_HASH_TARGET_AVX2 static void XXH3_accumulate_avx2(u64* acc, xbyte const* input, xbyte const* secret, u32 nbStripes)
+    {
+        __m256i a0 = _mm256_loadu_si256((__m256i const*)acc + 0);
+        __m256i a1 = _mm256_loadu_si256((__m256i const*)acc + 1);
+
+        for (u32 n = 0; n < nbStripes; n++)
+        {
+            __m256i const* xinput  = (__m256i const*)(input + n * XXH3_STRIPE_LEN);
+            __m256i const* xsecret = (__m256i const*)(secret + n * XXH3_SECRET_CONSUME_RATE);
+
+            __m256i const d0  = _mm256_loadu_si256(xinput + 0);
+            __m256i const dk0 = _mm256_xor_si256(d0, _mm256_loadu_si256(xsecret + 0));
+            __m256i const p0  = _mm256_mul_epu32(dk0, _mm256_srli_epi64(dk0, 32));
+            a0                = _mm256_add_epi64(p0, _mm256_add_epi64(a0, _mm256_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2))));
+
+            __m256i const d1  = _mm256_loadu_si256(xinput + 1);
+            __m256i const dk1 = _mm256_xor_si256(d1, _mm256_loadu_si256(xsecret + 1));
+            __m256i const p1  = _mm256_mul_epu32(dk1, _mm256_srli_epi64(dk1, 32));
+            a1                = _mm256_add_epi64(p1, _mm256_add_epi64(a1, _mm256_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2))));
+        }
+
+        _mm256_storeu_si256((__m256i*)acc + 0, a0);
+        _mm256_storeu_si256((__m256i*)acc + 1, a1);
+    }
+
+    X_HASH_TARGET_AVX2 static void XXH3_scramble_avx2(u64* acc, xbyte const* secret)
+    {
+        __m256i const prime32 = _mm256_set1_epi32((int)PRIME32_1);
+        for (u32 i = 0; i < 2; i++)
+        {
+            __m256i const acc_vec     = _mm256_loadu_si256((__m256i const*)acc + i);
+            __m256i const data_vec    = _mm256_xor_si256(acc_vec, _mm256_srli_epi64(acc_vec, 47));
+            __m256i const data_key    = _mm256_xor_si256(data_vec, _mm256_loadu_si256((__m256i const*)secret + i));
+            __m256i const data_key_hi = _mm256_srli_epi64(data_key, 32);
+            __m256i const prod_lo     = _mm256_mul_epu32(data_key, prime32);
+            __m256i const prod_hi     = _mm256_mul_epu32(data_key_hi, prime32);
+            _mm256_storeu_si256((__m256i*)acc + i, _mm256_add_epi64(prod_lo, _mm256_slli_epi64(prod_hi, 32)));
+        }
+    }
+
+    static bool s_cpu_has_avx2()
+    {
+#    if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+        __cpuid(info, 1);
+        bool const osxsave = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+        if (!osxsave || (_xgetbv(0) & 6) != 6)
+            return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#    else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#    endif
+    }
+#endif
+
+    struct xxh3_kernels_t
+    {
+        xxh3_kernels_t()
+        {
+            m_accumulate = XXH3_accumulate_scalar;
+            m_scramble   = XXH3_scramble_scalar;
+#ifdef X_HASH_SSE2
+            m_accumulate = XXH3_accumulate_sse2;
+            m_scramble   = XXH3_scramble_sse2;
+#endif
+#ifdef X_HASH_AVX2
+            if (s_cpu_has_avx2())
+            {
+                m_accumulate = XXH3_accumulate_avx2;
+                m_scramble   = XXH3_scramble_avx2;
+            }
+#endif
+        }
+        xxh3_accumulate_fn m_accumulate;
+        xxh3_scramble_fn   m_scramble;
+    };
+
+    static xxh3_kernels_t const& s_xxh3_kernels()
+    {
+        static xxh3_kernels_t kernels;
+        return kernels;
+    }
+
+    static void XXH3_hashLong(u64* acc, xbyte const* input, u32 len, xbyte const* secret)
+    {
+        xxh3_kernels_t const& k = s_xxh3_kernels();
+
+        acc[0] = PRIME32_3;
+        acc[1] = PRIME64_1;
+        acc[2] = PRIME64_2;
+        acc[3] = PRIME64_3;
+        acc[4] = PRIME64_4;
+        acc[5] = PRIME32_2;
+        acc[6] = PRIME64_5;
+        acc[7] = PRIME32_1;
+
+        u32 const nbStripesPerBlock = (XXH3_SECRET_SIZE - XXH3_STRIPE_LEN) / XXH3_SECRET_CONSUME_RATE;
+        u32 const block_len         = XXH3_STRIPE_LEN * nbStripesPerBlock;
+        u32 const nb_blocks         = (len - 1) / block_len;
+        for (u32 n = 0; n < nb_blocks; n++)
+        {
+            k.m_accumulate(acc, input + n * block_len, secret, nbStripesPerBlock);
+            k.m_scramble(acc, secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN);
+        }
+
+        // Last partial block and the last stripe
+        u32 const nbStripes = ((len - 1) - (block_len * nb_blocks)) / XXH3_STRIPE_LEN;
+        k.m_accumulate(acc, input + nb_blocks * block_len, secret, nbStripes);
+        k.m_accumulate(acc, input + len - XXH3_STRIPE_LEN, secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN - XXH3_SECRET_LASTACC, 1);
+    }
+
+    static u64 XXH3_mergeAccs(u64 const* acc, xbyte const* secret, u64 start)
+    {
+        u64 result64 = start;
+        for (u32 i = 0; i < 4; i++)
+            result64 += XXH3_mul128_fold64(acc[2 * i] ^ XXH_get64bits(secret + 16 * i), acc[2 * i + 1] ^ XXH_get64bits(secret + 16 * i + 8));
+        return XXH3_avalanche(result64);
+    }
+
+    // Long inputs with a seed use a secret derived from the seed
+    static xbyte const* XXH3_secret(u64 seed, xbyte* custom)
+    {
+        if (seed == 0)
+            return XXH3_kSecret;
+        for (u32 i = 0; i < XXH3_SECRET_SIZE; i += 16)
+        {
+            u64 const lo = x_IntelEndian::swap((u64)(XXH_get64bits(XXH3_kSecret + i) + seed));
+            u64 const hi = x_IntelEndian::swap((u64)(XXH_get64bits(XXH3_kSecret + i + 8) - seed));
+            ::memcpy(custom + i, &lo, sizeof(lo));
+            ::memcpy(custom + i + 8, &hi, sizeof(hi));
+        }
+        return custom;
+    }
+
+    u64 xxhash3_64(xbyte const* input, u32 len, u64 seed)
+    {
+        if (len <= 16)
+            return XXH3_len_0to16_64b(input, len, XXH3_kSecret, seed);
+        if (len <= 128)
+            return XXH3_len_17to128_64b(input, len, XXH3_kSecret, seed);
+        if (len <= XXH3_MIDSIZE_MAX)
+            return XXH3_len_129to240_64b(input, len, XXH3_kSecret, seed);
+
+        xbyte        custom[XXH3_SECRET_SIZE];
+        xbyte const* secret = XXH3_secret(seed, custom);
+        u64          acc[XXH3_ACC_NB];
+        XXH3_hashLong(acc, input, len, secret);
+        return XXH3_mergeAccs(acc, secret + XXH3_SECRET_MERGEACCS, (u64)len * PRIME64_1);
+    }
+
+    static inline hash128_t XXH128_mix32B(hash128_t acc, xbyte const* input_1, xbyte const* input_2, xbyte const* secret, u64 seed)
+    {
+        acc.m_low += XXH3_mix16B(input_1, secret + 0, seed);
+        acc.m_low ^= XXH_get64bits(input_2) + XXH_get64bits(input_2 + 8);
+        acc.m_high += XXH3_mix16B(input_2, secret + 16, seed);
+        acc.m_high ^= XXH_get64bits(input_1) + XXH_get64bits(input_1 + 8);
+        return acc;
+    }
+
+    static hash128_t XXH3_len_0to16_128b(xbyte const* input, u32 len, xbyte const* secret, u64 seed)
+    {
+        hash128_t h128;
+        if (len > 8)
+        {
+            u64 const bitflipl = (XXH_get64bits(secret + 32) ^ XXH_get64bits(secret + 40)) - seed;
+            u64 const bitfliph = (XXH_get64bits(secret + 48) ^ XXH_get64bits(secret + 56)) + seed;
+            u64 const input_lo = XXH_get64bits(input);
+            u64       input_hi = XXH_get64bits(input + len - 8);
+            hash128_t m128     = XXH_mult64to128(input_lo ^ input_hi ^ bitflipl, PRIME64_1);
+            m128.m_low += (u64)(len - 1) << 54;
+            input_hi ^= bitfliph;
+            m128.m_high += input_hi + (u64)(u32)input_hi * (u64)(PRIME32_2 - 1);
+            m128.m_low ^= XXH_swap64(m128.m_high);
+            h128 = XXH_mult64to128(m128.m_low, PRIME64_2);
+            h128.m_high += m128.m_high * PRIME64_2;
+            h128.m_low  = XXH3_avalanche(h128.m_low);
+            h128.m_high = XXH3_avalanche(h128.m_high);
+            return h128;
+        }
+        if (len >= 4)
+        {
+            seed ^= (u64)XXH_swap32((u32)seed) << 32;
+            u32 const input_lo = XXH_get32bits(input);
+            u32 const input_hi = XXH_get32bits(input + len - 4);
+            u64 const input_64 = input_lo + ((u64)input_hi << 32);
+            u64 const bitflip  = (XXH_get64bits(secret + 16) ^ XXH_get64bits(secret + 24)) + seed;
+            h128               = XXH_mult64to128(input_64 ^ bitflip, PRIME64_1 + ((u64)len << 2));
+            h128.m_high += (h128.m_low << 1);
+            h128.m_low ^= (h128.m_high >> 3);
+            h128.m_low = XXH_xorshift64(h128.m_low, 35);
+            h128.m_low *= PRIME_MX2;
+            h128.m_low  = XXH_xorshift64(h128.m_low, 28);
+            h128.m_high = XXH3_avalanche(h128.m_high);
+            return h128;
+        }
+        if (len > 0)
+        {
+            u32 const combinedl = ((u32)input[0] << 16) | ((u32)input[len >> 1] << 24) | ((u32)input[len - 1] << 0) | ((u32)len << 8);
+            u32 const swapped   = XXH_swap32(combinedl);
+            u32 const combinedh = XXH_rotl32(swapped, 13);
+            u64 const bitflipl  = (XXH_get32bits(secret) ^ XXH_get32bits(secret + 4)) + seed;
+            u64 const bitfliph  = (XXH_get32bits(secret + 8) ^ XXH_get32bits(secret + 12)) - seed;
+            h128.m_low          = XXH64_avalanche((u64)combinedl ^ bitflipl);
+            h128.m_high         = XXH64_avalanche((u64)combinedh ^ bitfliph);
+            return h128;
+        }
+        h128.m_low  = XXH64_avalanche(seed ^ (XXH_get64bits(secret + 64) ^ XXH_get64bits(secret + 72)));
+        h128.m_high = XXH64_avalanche(seed ^ (XXH_get64bits(secret + 80) ^ XXH_get64bits(secret + 88)));
+        return h128;
+    }
+
+    static hash128_t XXH3_finalize_128b(hash128_t acc, u32 len, u64 seed)
+    {
+        hash128_t h128;
+        h128.m_low  = acc.m_low + acc.m_high;
+        h128.m_high = (acc.m_low * PRIME64_1) + (acc.m_high * PRIME64_4) + (((u64)len - seed) * PRIME64_2);
+        h128.m_low  = XXH3_avalanche(h128.m_low);
+        h128.m_high = (u64)0 - XXH3_avalanche(h128.m_high);
+        return h128;
+    }
+
+    static hash128_t XXH3_len_17to128_128b(xbyte const* input, u32 len, xbyte const* secret, u64 seed)
+    {
+        hash128_t acc;
+        acc.m_low  = len * PRIME64_1;
+        acc.m_high = 0;
+        if (len > 32)
+        {
+            if (len > 64)
+            {
+                if (len > 96)
+                    acc = XXH128_mix32B(acc, input + 48, input + len - 64, secret + 96, seed);
+                acc = XXH128_mix32B(acc, input + 32, input + len - 48, secret + 64, seed);
+            }
+            acc = XXH128_mix32B(acc, input + 16, input + len - 32, secret + 32, seed);
+        }
+        acc = XXH128_mix32B(acc, input, input + len - 16, secret, seed);
+        return XXH3_finalize_128b(acc, len, seed);
+    }
+
+    static hash128_t XXH3_len_129to240_128b(xbyte const* input, u32 len, xbyte const* secret, u64 seed)
+    {
+        hash128_t acc;
+        acc.m_low  = len * PRIME64_1;
+        acc.m_high = 0;
+        for (u32 i = 32; i < 160; i += 32)
+            acc = XXH128_mix32B(acc, input + i - 32, input + i - 16, secret + i - 32, seed);
+        acc.m_low  = XXH3_avalanche(acc.m_low);
+        acc.m_high = XXH3_avalanche(acc.m_high);
+        for (u32 i = 160; i <= len; i += 32)
+            acc = XXH128_mix32B(acc, input + i - 32, input + i - 16, secret + XXH3_MIDSIZE_STARTOFFSET + i - 160, seed);
+        acc = XXH128_mix32B(acc, input + len - 16, input + len - 32, secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET - 16, (u64)0 - seed);
+        return XXH3_finalize_128b(acc, len, seed);
+    }
+
+    hash128_t xxhash3_128(xbyte const* input, u32 len, u64 seed)
+    {
+        if (len <= 16)
+            return XXH3_len_0to16_128b(input, len, XXH3_kSecret, seed);
+        if (len <= 128)
+            return XXH3_len_17to128_128b(input, len, XXH3_kSecret, seed);
+        if (len <= XXH3_MIDSIZE_MAX)
+            return XXH3_len_129to240_128b(input, len, XXH3_kSecret, seed);
+
+        xbyte        custom[XXH3_SECRET_SIZE];
+        xbyte const* secret = XXH3_secret(seed, custom);
+        u64          acc[XXH3_ACC_NB];
+        XXH3_hashLong(acc, input, len, secret);
+
+        hash128_t h128;
+        h128.m_low  = XXH3_mergeAccs(acc, secret + XXH3_SECRET_MERGEACCS, (u64)len * PRIME64_1);
+        h128.m_high = XXH3_mergeAccs(acc, secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN - XXH3_SECRET_MERGEACCS, ~((u64)len * PRIME64_2));
+        return h128;
+    }
+
+    // ----------------------------------------------------------------------------
+    u64 calchash(xbyte const* data, u32 size) { return xxhash3_64(data, size, 0); }
+
+    // Every task hashes one chunk, the digests are stored little-endian so
+    // that the root hash is the same on every platform
+    class calchash_chunk_job_t : public job_t
+    {
+    public:
+        inline calchash_chunk_job_t(cbuffer_t const& data, u64* digests) : m_data(data), m_digests(digests) {}
+
+        virtual void execute(u32 index)
+        {
+            u32 const offset = index * (u32)HASH_CHUNK_SIZE;
+            u32 const size   = xmin(m_data.m_len - offset, (u32)HASH_CHUNK_SIZE);
+            m_digests[index] = x_IntelEndian::swap(xxhash3_64(m_data.m_const + offset, size, 0));
+        }
+
+        cbuffer_t m_data;
+        u64*      m_digests;
+    };
+
+    u64 calchash_parallel(cbuffer_t const& data, jobs_t* jobs, alloc_t* allocator)
+    {
+        if (data.m_len <= (u32)HASH_CHUNK_SIZE)
+            return calchash(data.m_const, data.m_len);
+
+        if (allocator == nullptr)
+            allocator = alloc_t::get_system();
+
+        u32 const num_chunks = (u32)(((u64)data.m_len + HASH_CHUNK_SIZE - 1) / HASH_CHUNK_SIZE);
+        u64*      digests    = (u64*)allocator->allocate(num_chunks * sizeof(u64), sizeof(u64));
+
+        calchash_chunk_job_t job(data, digests);
+        run_job(jobs, &job, num_chunks);
+
+        u64 const hash = xxhash3_64((xbyte const*)digests, num_chunks * sizeof(u64), data.m_len);
+        allocator->deallocate(digests);
+        return hash;
     }
 
     // ----------------------------------------------------------------------------
-    u64 calchash(xbyte const* data, u32 size) { return XXH64(data, size); }
+    // Batched hashing
+    //
+    // The AVX2 kernels hash 4 keys per vector and run 2 vectors per iteration.
+    // AVX2 has no 64-bit multiply, it is done with 3 32-bit multiplies.
+    // ----------------------------------------------------------------------------
+
+    typedef void (*hash_batch_u32_fn)(u32 const* keys, u64* hashes, u32 count);
+    typedef void (*hash_batch_u64_fn)(u64 const* keys, u64* hashes, u32 count);
+    typedef void (*hash_batch_bytes_fn)(xbyte const* keys, u32 key_size, u64* hashes, u32 count);
+
+    static void s_hash_batch_u32_scalar(u32 const* keys, u64* hashes, u32 count)
+    {
+        for (u32 i = 0; i < count; ++i)
+            hashes[i] = mixhash(keys[i]);
+    }
+
+    static void s_hash_batch_u64_scalar(u64 const* keys, u64* hashes, u32 count)
+    {
+        for (u32 i = 0; i < count; ++i)
+            hashes[i] = mixhash(keys[i]);
+    }
+
+    static void s_hash_batch_bytes_scalar(xbyte const* keys, u32 key_size, u64* hashes, u32 count)
+    {
+        if (key_size <= 16)
+        {
+            for (u32 i = 0; i < count; ++i)
+                hashes[i] = XXH3_len_0to16_64b(keys + i * key_size, key_size, XXH3_kSecret, 0);
+        }
+        else
+        {
+            for (u32 i = 0; i < count; ++i)
+                hashes[i] = xxhash3_64(keys + i * key_size, key_size, 0);
+        }
+    }
+
+#ifdef X_HASH_AVX2
+    X_HASH_TARGET_AVX2 static inline __m256i s_mul64_avx2(__m256i a, __m256i b, __m256i b_hi)
+    {
+        __m256i const lo    = _mm256_mul_epu32(a, b);
+        __m256i const cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b), _mm256_mul_epu32(a, b_hi));
+        return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+    }
+
+    X_HASH_TARGET_AVX2 static inline __m256i s_xorshift_avx2(__m256i v, s32 shift) { return _mm256_xor_si256(v, _mm256_srli_epi64(v, shift)); }
+
+    X_HASH_TARGET_AVX2 static inline __m256i s_mixhash_avx2(__m256i k)
+    {
+        __m256i const c1    = _mm256_set1_epi64x((s64)0x3C79AC492BA7B653ULL);
+        __m256i const c1_hi = _mm256_set1_epi64x((s64)(0x3C79AC492BA7B653ULL >> 32));
+        __m256i const c2    = _mm256_set1_epi64x((s64)0x1C69B3F74AC4AE35ULL);
+        __m256i const c2_hi = _mm256_set1_epi64x((s64)(0x1C69B3F74AC4AE35ULL >> 32));
+        k                   = s_mul64_avx2(s_xorshift_avx2(k, 27), c1, c1_hi);
+        k                   = s_mul64_avx2(s_xorshift_avx2(k, 33), c2, c2_hi);
+        return s_xorshift_avx2(k, 27);
+    }
+
+    X_HASH_TARGET_AVX2 static void s_hash_batch_u32_avx2(u32 const* keys, u64* hashes, u32 count)
+    {
+        u32 i = 0;
+        for (; (i + 8) <= count; i += 8)
+        {
+            __m256i const k0 = _mm256_cvtepu32_epi64(_mm_loadu_si128((__m128i const*)(keys + i)));
+            __m256i const k1 = _mm256_cvtepu32_epi64(_mm_loadu_si128((__m128i const*)(keys + i + 4)));
+            _mm256_storeu_si256((__m256i*)(hashes + i), s_mixhash_avx2(k0));
+            _mm256_storeu_si256((__m256i*)(hashes + i + 4), s_mixhash_avx2(k1));
+        }
+        s_hash_batch_u32_scalar(keys + i, hashes + i, count - i);
+    }
+
+    X_HASH_TARGET_AVX2 static void s_hash_batch_u64_avx2(u64 const* keys, u64* hashes, u32 count)
+    {
+        u32 i = 0;
+        for (; (i + 8) <= count; i += 8)
+        {
+            __m256i const k0 = _mm256_loadu_si256((__m256i const*)(keys + i));
+            __m256i const k1 = _mm256_loadu_si256((__m256i const*)(keys + i + 4));
+            _mm256_storeu_si256((__m256i*)(hashes + i), s_mixhash_avx2(k0));
+            _mm256_storeu_si256((__m256i*)(hashes + i + 4), s_mixhash_avx2(k1));
+        }
+        s_hash_batch_u64_scalar(keys + i, hashes + i, count - i);
+    }
+
+    // XXH3 for keys of 4 to 8 bytes (XXH3_len_0to16_64b with seed 0)
+    X_HASH_TARGET_AVX2 static inline __m256i s_rotl64_avx2(__m256i v, s32 r) { return _mm256_or_si256(_mm256_slli_epi64(v, r), _mm256_srli_epi64(v, 64 - r)); }
+
+    X_HASH_TARGET_AVX2 static inline __m256i s_xxh3_4to8_avx2(__m256i input64, __m256i bitflip, __m256i len)
+    {
+        __m256i const mx2    = _mm256_set1_epi64x((s64)PRIME_MX2);
+        __m256i const mx2_hi = _mm256_set1_epi64x((s64)(PRIME_MX2 >> 32));
+        __m256i       h      = _mm256_xor_si256(input64, bitflip);
+        h                    = _mm256_xor_si256(h, _mm256_xor_si256(s_rotl64_avx2(h, 49), s_rotl64_avx2(h, 24)));
+        h                    = s_mul64_avx2(h, mx2, mx2_hi);
+        h                    = _mm256_xor_si256(h, _mm256_add_epi64(_mm256_srli_epi64(h, 35), len));
+        h                    = s_mul64_avx2(h, mx2, mx2_hi);
+        return s_xorshift_avx2(h, 28);
+    }
+
+    static inline s64 s_xxh3_4to8_input(xbyte const* key, u32 key_size) { return (s64)(XXH_get32bits(key + key_size - 4) + (((u64)XXH_get32bits(key)) << 32)); }
+
+    X_HASH_TARGET_AVX2 static void s_hash_batch_bytes_avx2(xbyte const* keys, u32 key_size, u64* hashes, u32 count)
+    {
+        if (key_size < 4 || key_size > 8)
+        {
+            s_hash_batch_bytes_scalar(keys, key_size, hashes, count);
+            return;
+        }
+
+        __m256i const bitflip = _mm256_set1_epi64x((s64)(XXH_get64bits(XXH3_kSecret + 8) ^ XXH_get64bits(XXH3_kSecret + 16)));
+        __m256i const len     = _mm256_set1_epi64x((s64)key_size);
+        u32           i       = 0;
+        for (; (i + 8) <= count; i += 8)
+        {
+            xbyte const*  k  = keys + i * key_size;
+            __m256i const k0 = _mm256_set_epi64x(s_xxh3_4to8_input(k + 3 * key_size, key_size), s_xxh3_4to8_input(k + 2 * key_size, key_size), s_xxh3_4to8_input(k + key_size, key_size), s_xxh3_4to8_input(k, key_size));
+            k += 4 * key_size;
+            __m256i const k1 = _mm256_set_epi64x(s_xxh3_4to8_input(k + 3 * key_size, key_size), s_xxh3_4to8_input(k + 2 * key_size, key_size), s_xxh3_4to8_input(k + key_size, key_size), s_xxh3_4to8_input(k, key_size));
+            _mm256_storeu_si256((__m256i*)(hashes + i), s_xxh3_4to8_avx2(k0, bitflip, len));
+            _mm256_storeu_si256((__m256i*)(hashes + i + 4), s_xxh3_4to8_avx2(k1, bitflip, len));
+        }
+        s_hash_batch_bytes_scalar(keys + i * key_size, key_size, hashes + i, count - i);
+    }
+#endif
+
+    struct hash_batch_kernels_t
+    {
+        hash_batch_kernels_t()
+        {
+            m_u32   = s_hash_batch_u32_scalar;
+            m_u64   = s_hash_batch_u64_scalar;
+            m_bytes = s_hash_batch_bytes_scalar;
+#ifdef X_HASH_AVX2
+            if (s_cpu_has_avx2())
+            {
+                m_u32   = s_hash_batch_u32_avx2;
+                m_u64   = s_hash_batch_u64_avx2;
+                m_bytes = s_hash_batch_bytes_avx2;
+            }
+#endif
+        }
+        hash_batch_u32_fn   m_u32;
+        hash_batch_u64_fn   m_u64;
+        hash_batch_bytes_fn m_bytes;
+    };
+
+    static hash_batch_kernels_t const& s_hash_batch_kernels()
+    {
+        static hash_batch_kernels_t kernels;
+        return kernels;
+    }
+
+    void calchash_batch(u32 const* keys, u64* hashes, u32 count) { s_hash_batch_kernels().m_u32(keys, hashes, count); }
+    void calchash_batch(u64 const* keys, u64* hashes, u32 count) { s_hash_batch_kernels().m_u64(keys, hashes, count); }
+    void calchash_batch(xbyte const* keys, u32 key_size, u64* hashes, u32 count) { s_hash_batch_kernels().m_bytes(keys, key_size, hashes, count); }
 } // namespace xcore
 
 namespace xcore
@@ -279,4 +279,393 @@ namespace xcore
         return false;
     }
 
+    // ------------------------------------------------------------------------------------------
+    // hibitset64_t
+
+    static inline u64 mask_from(u32 bit) { return ~(u64)0 << (bit & 63); }      // bits [bit, 63]
+    static inline u64 mask_until(u32 bit) { return ~(u64)0 >> (63 - (bit & 63)); } // bits [0, bit]
+
+    u32 hibitset64_t::size_in_qwords(u32 numbits)
+    {
+        u32 numqwords = 0;
+        do
+        {
+            u32 const n = (numbits + 63) / 64;
+            numqwords += n;
+            numbits = n;
+        } while (numbits > 1);
+        return numqwords;
+    }
+
+    void hibitset64_t::init(u64* bitlist, u32 maxbits)
+    {
+        m_numbits = maxbits;
+
+        // Figure out the pointer and size of every level
+        u32  numbits = maxbits;
+        u64* level   = bitlist;
+        s32  i       = 0;
+        do
+        {
+            m_levels[i]    = level;
+            m_levelbits[i] = numbits;
+            i += 1;
+            level += ((numbits + 63) / 64);
+            numbits = (numbits + 63) / 64;
+        } while (numbits > 1);
+        m_maxlevel = i;
+    }
+
+    void hibitset64_t::init(alloc_t* alloc, u32 maxbits)
+    {
+        u32 const nqwords = size_in_qwords(maxbits);
+        u64*      bitlist = (u64*)alloc->allocate(nqwords * sizeof(u64), sizeof(u64));
+        x_memset(bitlist, 0, nqwords * sizeof(u64));
+        init(bitlist, maxbits);
+    }
+
+    void hibitset64_t::release(alloc_t* alloc)
+    {
+        if (alloc != nullptr)
+        {
+            alloc->deallocate(m_levels[0]);
+        }
+        m_maxlevel = 0;
+        m_numbits  = 0;
+    }
+
+    void hibitset64_t::reset() { x_memset(m_levels[0], 0, size_in_qwords(m_numbits) * sizeof(u64)); }
+
+    void hibitset64_t::set(u32 bit)
+    {
+        ASSERT(bit < m_numbits);
+
+        // set bit in level 0, then avalanche up when the word was empty
+        for (s32 i = 0; i < m_maxlevel; ++i)
+        {
+            u64&      word = m_levels[i][bit >> 6];
+            u64 const w0   = word;
+            word           = w0 | ((u64)1 << (bit & 63));
+            if (w0 != 0)
+                break;
+            bit = bit >> 6;
+        }
+    }
+
+    void hibitset64_t::clr(u32 bit)
+    {
+        ASSERT(bit < m_numbits);
+
+        // clear bit in level 0, then avalanche up when the word became empty
+        for (s32 i = 0; i < m_maxlevel; ++i)
+        {
+            u64&      word = m_levels[i][bit >> 6];
+            u64 const w0   = word;
+            u64 const w1   = w0 & ~((u64)1 << (bit & 63));
+            word           = w1;
+            if (w1 != 0 || w0 == w1)
+                break;
+            bit = bit >> 6;
+        }
+    }
+
+    void hibitset64_t::set_range(u32 from, u32 to)
+    {
+        ASSERT(from <= to && to <= m_numbits);
+
+        // Every word touched becomes non-empty, so the same holds for the
+        // range of summary bits on the level above.
+        for (s32 i = 0; i < m_maxlevel && from < to; ++i)
+        {
+            u64*      level = m_levels[i];
+            u32 const w0    = from >> 6;
+            u32 const w1    = (to - 1) >> 6;
+            if (w0 == w1)
+            {
+                level[w0] |= mask_from(from) & mask_until(to - 1);
+            }
+            else
+            {
+                level[w0] |= mask_from(from);
+                for (u32 w = w0 + 1; w < w1; ++w)
+                    level[w] = ~(u64)0;
+                level[w1] |= mask_until(to - 1);
+            }
+            from = w0;
+            to   = w1 + 1;
+        }
+    }
+
+    void hibitset64_t::clr_range(u32 from, u32 to)
+    {
+        ASSERT(from <= to && to <= m_numbits);
+
+        // Only the words that became empty need their summary bit cleared, these
+        // are all the inner words plus the edge words when they are empty now.
+        for (s32 i = 0; i < m_maxlevel && from < to; ++i)
+        {
+            u64*      level = m_levels[i];
+            u32 const w0    = from >> 6;
+            u32 const w1    = (to - 1) >> 6;
+            if (w0 == w1)
+            {
+                level[w0] &= ~(mask_from(from) & mask_until(to - 1));
+            }
+            else
+            {
+                level[w0] &= ~mask_from(from);
+                for (u32 w = w0 + 1; w < w1; ++w)
+                    level[w] = 0;
+                level[w1] &= ~mask_until(to - 1);
+            }
+            from = (level[w0] == 0) ? w0 : (w0 + 1);
+            to   = (level[w1] == 0) ? (w1 + 1) : w1;
+        }
+    }
+
+    bool hibitset64_t::is_set(u32 bit) const
+    {
+        ASSERT(bit < m_numbits);
+        return ((m_levels[0][bit >> 6] >> (bit & 63)) & 1) == 1;
+    }
+
+    bool hibitset64_t::is_empty() const { return m_levels[m_maxlevel - 1][0] == 0; }
+
+    bool hibitset64_t::find(u32& bit) const
+    {
+        // Start at top level and follow the first '1' bit down
+        u32 w = 0;
+        for (s32 i = m_maxlevel - 1; i >= 0; --i)
+        {
+            u64 const word = m_levels[i][w];
+            if (word == 0)
+                return false;
+            w = (w << 6) + xcountTrailingZeros(word);
+        }
+        bit = w;
+        return true;
+    }
+
+    bool hibitset64_t::upper(u32 pivot, u32& bit) const
+    {
+        // Move up until a level has a '1' at or after the pivot, then go down
+        s32 il = 0;
+        u32 ib = pivot;
+        for (;;)
+        {
+            if (ib >= m_levelbits[il])
+                return false;
+            u32 const iw   = ib >> 6;
+            u64 const word = m_levels[il][iw] & mask_from(ib);
+            if (word != 0)
+            {
+                ib = (iw << 6) + xcountTrailingZeros(word);
+                break;
+            }
+            il += 1;
+            if (il == m_maxlevel)
+                return false;
+            ib = iw + 1;
+        }
+        while (il > 0)
+        {
+            il -= 1;
+            ib = (ib << 6) + xcountTrailingZeros(m_levels[il][ib]);
+        }
+        bit = ib;
+        return true;
+    }
+
+    bool hibitset64_t::lower(u32 pivot, u32& bit) const
+    {
+        if (pivot >= m_numbits)
+            pivot = m_numbits - 1;
+
+        // Move up until a level has a '1' at or before the pivot, then go down
+        s32 il = 0;
+        u32 ib = pivot;
+        for (;;)
+        {
+            u32 const iw   = ib >> 6;
+            u64 const word = m_levels[il][iw] & mask_until(ib);
+            if (word != 0)
+            {
+                ib = (iw << 6) + (63 - xcountLeadingZeros(word));
+                break;
+            }
+            il += 1;
+            if (iw == 0 || il == m_maxlevel)
+                return false;
+            ib = iw - 1;
+        }
+        while (il > 0)
+        {
+            il -= 1;
+            ib = (ib << 6) + (63 - xcountLeadingZeros(m_levels[il][ib]));
+        }
+        bit = ib;
+        return true;
+    }
+
+    hibitset64_t::iter_t::iter_t(hibitset64_t const& set) : m_set(&set), m_word(0), m_wordindex(0)
+    {
+        if (set.m_numbits > 0)
+            m_word = set.m_levels[0][0];
+    }
+
+    bool hibitset64_t::iter_t::next(u32& bit)
+    {
+        while (m_word == 0)
+        {
+            // Use the summary levels to skip over empty words
+            u32 next;
+            if (!m_set->upper((m_wordindex + 1) << 6, next))
+                return false;
+            m_wordindex = next >> 6;
+            m_word      = m_set->m_levels[0][m_wordindex];
+        }
+        bit = (m_wordindex << 6) + xcountTrailingZeros(m_word);
+        m_word &= m_word - 1;
+        return true;
+    }
+
+    // ----------------------------------------------------------------------------------------
+    // rank / select index
+
+    static inline u32 s_num_words(u32 numbits) { return (numbits + 31) / 32; }
+    static inline u32 s_num_blocks(u32 numbits) { return (s_num_words(numbits) + hibitset_rank_t::BLOCK_WORDS - 1) / hibitset_rank_t::BLOCK_WORDS; }
+    static inline u32 s_num_supers(u32 numbits) { return (s_num_blocks(numbits) + hibitset_rank_t::SUPER_BLOCKS - 1) / hibitset_rank_t::SUPER_BLOCKS; }
+    static inline u32 s_num_samples(u32 numbits) { return (numbits / hibitset_rank_t::SELECT_SAMPLE) + 1; }
+
+    u32 hibitset_rank_t::size_in_bytes(u32 maxbits)
+    {
+        u32 const blocks_size = xalignUp(s_num_blocks(maxbits) * (u32)sizeof(u16), (u32)sizeof(u32));
+        return (s_num_supers(maxbits) + s_num_samples(maxbits)) * sizeof(u32) + blocks_size;
+    }
+
+    void hibitset_rank_t::init(alloc_t* alloc, hibitset_t const& set)
+    {
+        u32 const numbits = set.m_numbits;
+        u8*       mem     = (u8*)alloc->allocate(size_in_bytes(numbits), sizeof(u32));
+
+        m_set     = &set;
+        m_supers  = (u32*)mem;
+        m_samples = m_supers + s_num_supers(numbits);
+        m_blocks  = (u16*)(m_samples + s_num_samples(numbits));
+        build();
+    }
+
+    void hibitset_rank_t::release(alloc_t* alloc)
+    {
+        if (alloc != nullptr && m_supers != nullptr)
+        {
+            alloc->deallocate(m_supers);
+        }
+        m_set        = nullptr;
+        m_supers     = nullptr;
+        m_blocks     = nullptr;
+        m_samples    = nullptr;
+        m_numblocks  = 0;
+        m_numsamples = 0;
+        m_count      = 0;
+    }
+
+    void hibitset_rank_t::build()
+    {
+        u32 const* words    = m_set->m_levels[0];
+        u32 const  numwords = s_num_words(m_set->m_numbits);
+
+        m_numblocks  = s_num_blocks(m_set->m_numbits);
+        m_numsamples = 0;
+
+        u32 total = 0;
+        for (u32 b = 0; b < m_numblocks; ++b)
+        {
+            if ((b % SUPER_BLOCKS) == 0)
+                m_supers[b / SUPER_BLOCKS] = total;
+            m_blocks[b] = (u16)(total - m_supers[b / SUPER_BLOCKS]);
+
+            u32 const end = xmin((b + 1) * BLOCK_WORDS, numwords);
+            for (u32 w = b * BLOCK_WORDS; w < end; ++w)
+            {
+                u32 const c = xcountBits(words[w]);
+                // A word holds less than SELECT_SAMPLE bits, so at most one sample per word
+                if ((m_numsamples * SELECT_SAMPLE) < (total + c))
+                    m_samples[m_numsamples++] = b;
+                total += c;
+            }
+        }
+        m_count = total;
+    }
+
+    u32 hibitset_rank_t::rank(u32 bit) const
+    {
+        ASSERT(bit <= m_set->m_numbits);
+        if (bit == m_set->m_numbits)
+            return m_count;
+
+        u32 const* words = m_set->m_levels[0];
+        u32 const  w     = bit >> 5;
+        u32        r     = block_rank(w / BLOCK_WORDS);
+        for (u32 i = (w / BLOCK_WORDS) * BLOCK_WORDS; i < w; ++i)
+            r += xcountBits(words[i]);
+        if ((bit & 31) != 0)
+            r += xcountBits(words[w] & (0xffffffff >> (32 - (bit & 31))));
+        return r;
+    }
+
+    // Position of the @k-th (0 based) 1 bit in @word, @word has more than @k bits set
+    static inline u32 s_select_in_word(u32 word, u32 k)
+    {
+        u32 pos = 0;
+        while (true)
+        {
+            u32 const c = xcountBits(word & 0xff);
+            if (k < c)
+                break;
+            k -= c;
+            word >>= 8;
+            pos += 8;
+        }
+        while (k > 0)
+        {
+            word &= word - 1;
+            k -= 1;
+        }
+        return pos + xcountTrailingZeros(word);
+    }
+
+    bool hibitset_rank_t::select(u32 k, u32& bit) const
+    {
+        if (k >= m_count)
+            return false;
+
+        // Binary search for the last block with a rank <= k in between the samples
+        u32 const s  = k / SELECT_SAMPLE;
+        u32       lo = m_samples[s];
+        u32       hi = (s + 1) < m_numsamples ? m_samples[s + 1] : (m_numblocks - 1);
+        while (lo < hi)
+        {
+            u32 const mid = (lo + hi + 1) / 2;
+            if (block_rank(mid) <= k)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+
+        u32 const* words = m_set->m_levels[0];
+        u32        r     = block_rank(lo);
+        u32        w     = lo * BLOCK_WORDS;
+        while (true)
+        {
+            u32 const c = xcountBits(words[w]);
+            if ((r + c) > k)
+                break;
+            r += c;
+            w += 1;
+        }
+        bit = (w << 5) + s_select_in_word(words[w], k - r);
+        return true;
+    }
+
 }; // namespace xcore
@@ -0,0 +1,185 @@
+#include "xbase/x_target.h"
+#include "xbase/x_allocator.h"
+#include "xbase/x_debug.h"
+#include "xbase/x_integer.h"
+
+#include "xbase/x_hibitset_atomic.h"
+
+namespace xcore
+{
+    static const u64 sFull = ~(u64)0;
+
+    u32 hibitset_atomic_t::size_in_qwords(u32 numbits)
+    {
+        u32 numqwords = 0;
+        do
+        {
+            u32 const n = (numbits + 63) / 64;
+            numqwords += n;
+            numbits = n;
+        } while (numbits > 1);
+        return numqwords;
+    }
+
+    void hibitset_atomic_t::init(alloc_t* alloc, u32 maxbits)
+    {
+        u32 const         nqwords = size_in_qwords(maxbits);
+        std::atomic<u64>* bitlist = (std::atomic<u64>*)alloc->allocate(nqwords * sizeof(u64), X_CACHE_LINE_SIZE);
+
+        m_numbits = maxbits;
+
+        // Figure out the pointer to every level
+        u32               numbits = maxbits;
+        std::atomic<u64>* level   = bitlist;
+        s32               i       = 0;
+        do
+        {
+            m_levels[i++] = level;
+            level += ((numbits + 63) / 64);
+            numbits = (numbits + 63) / 64;
+        } while (numbits > 1);
+        m_maxlevel = i;
+
+        reset();
+    }
+
+    void hibitset_atomic_t::release(alloc_t* alloc)
+    {
+        if (alloc != nullptr && m_maxlevel > 0)
+        {
+            alloc->deallocate(m_levels[0]);
+        }
+        m_maxlevel = 0;
+        m_numbits  = 0;
+    }
+
+    void hibitset_atomic_t::reset()
+    {
+        u32 numbits = m_numbits;
+        for (s32 i = 0; i < m_maxlevel; ++i)
+        {
+            u32 const numqwords = (numbits + 63) / 64;
+            for (u32 w = 0; w < numqwords; ++w)
+                m_levels[i][w].store(0, std::memory_order_relaxed);
+
+            // The bits beyond the end are marked as 'in use'
+            if ((numbits & 63) != 0)
+                m_levels[i][numqwords - 1].store(sFull << (numbits & 63), std::memory_order_relaxed);
+            numbits = numqwords;
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    // The word at @level is (or was) full, set the summary bit on the levels above.
+    // After setting the summary bit the word is checked again, if in the meantime
+    // another thread freed a bit the summary bit is reverted.
+    void hibitset_atomic_t::mark_full(s32 level, u32 word)
+    {
+        for (s32 il = level + 1; il < m_maxlevel; ++il)
+        {
+            u64 const         m      = (u64)1 << (word & 63);
+            std::atomic<u64>& parent = m_levels[il][word >> 6];
+            u64 const         prev   = parent.fetch_or(m);
+            if (m_levels[il - 1][word].load() != sFull)
+            {
+                mark_not_full(il - 1, word);
+                return;
+            }
+            if ((prev | m) != sFull)
+                return;
+            word = word >> 6;
+        }
+    }
+
+    // The word at @level is not full anymore, clear the summary bit on the levels
+    // above for as long as the parent word was full.
+    void hibitset_atomic_t::mark_not_full(s32 level, u32 word)
+    {
+        for (s32 il = level + 1; il < m_maxlevel; ++il)
+        {
+            u64 const         m      = (u64)1 << (word & 63);
+            std::atomic<u64>& parent = m_levels[il][word >> 6];
+            u64 const         prev   = parent.fetch_and(~m);
+            if (prev != sFull)
+                return;
+            word = word >> 6;
+        }
+    }
+
+    bool hibitset_atomic_t::set(u32 bit)
+    {
+        ASSERT(bit < m_numbits);
+        u64 const m    = (u64)1 << (bit & 63);
+        u64 const prev = m_levels[0][bit >> 6].fetch_or(m);
+        if ((prev & m) != 0)
+            return false;
+        if ((prev | m) == sFull)
+            mark_full(0, bit >> 6);
+        return true;
+    }
+
+    bool hibitset_atomic_t::clr(u32 bit)
+    {
+        ASSERT(bit < m_numbits);
+        u64 const m    = (u64)1 << (bit & 63);
+        u64 const prev = m_levels[0][bit >> 6].fetch_and(~m);
+        if ((prev & m) == 0)
+            return false;
+        if (prev == sFull)
+            mark_not_full(0, bit >> 6);
+        return true;
+    }
+
+    bool hibitset_atomic_t::is_set(u32 bit) const
+    {
+        ASSERT(bit < m_numbits);
+        return ((m_levels[0][bit >> 6].load(std::memory_order_acquire) >> (bit & 63)) & 1) == 1;
+    }
+
+    bool hibitset_atomic_t::is_full() const { return m_levels[m_maxlevel - 1][0].load(std::memory_order_acquire) == sFull; }
+
+    bool hibitset_atomic_t::find_and_set(u32& bit)
+    {
+        for (;;)
+        {
+            // Walk down the 'not full' hints
+            u32 w  = 0;
+            s32 il = m_maxlevel - 1;
+            while (il > 0)
+            {
+                u64 const word = m_levels[il][w].load(std::memory_order_acquire);
+                if (word == sFull)
+                    break;
+                w = (w << 6) + xcountTrailingZeros(~word);
+                il -= 1;
+            }
+
+            if (il == 0)
+            {
+                // Try to claim the lowest free bit in this word
+                std::atomic<u64>& level0 = m_levels[0][w];
+                u64               word   = level0.load(std::memory_order_relaxed);
+                while (word != sFull)
+                {
+                    u64 const m    = (u64)1 << xcountTrailingZeros(~word);
+                    u64 const prev = level0.fetch_or(m);
+                    if ((prev & m) == 0)
+                    {
+                        if ((prev | m) == sFull)
+                            mark_full(0, w);
+                        bit = (w << 6) + xcountTrailingZeros(m);
+                        return true;
+                    }
+                    word = prev | m;
+                }
+            }
+
+            if (il == m_maxlevel - 1 && m_levels[il][w].load() == sFull)
+                return false;
+
+            // Stale hint, the word at this level is full, repair and try again
+            mark_full(il, w);
+        }
+    }
+
+}; // namespace xcore
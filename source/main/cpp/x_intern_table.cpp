@@ -0,0 +1,314 @@
+#include "xbase/x_target.h"
+#include "xbase/x_allocator.h"
+#include "xbase/x_debug.h"
+#include "xbase/x_hash.h"
+#include "xbase/x_integer.h"
+#include "xbase/x_memory.h"
+
+#include "xbase/x_intern_table.h"
+
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#    include <emmintrin.h>
+#    define X_INTERN_PAUSE() _mm_pause()
+#elif defined(__aarch64__) && defined(__GNUC__)
+#    define X_INTERN_PAUSE() __asm__ __volatile__("yield")
+#else
+#    define X_INTERN_PAUSE()
+#endif
+
+namespace xcore
+{
+    // Spins on the lock before the waiting thread gives up its time slice
+    static const u32 sLockSpins = 64;
+
+    struct intern_table_t::entry_t
+    {
+        xbyte const* m_data;
+        u64          m_hash;
+        u32          m_len; // in bytes, without the terminator
+        s32          m_type;
+    };
+
+    // Open addressing table of (entry index + 1), 0 is an empty slot. The
+    // slots follow the header in the same allocation.
+    struct intern_table_t::table_t
+    {
+        table_t* m_retired; // the previous (smaller) table
+        u32      m_mask;
+        u32      m_dummy;
+
+        inline std::atomic<u32>* slots() { return (std::atomic<u32>*)(this + 1); }
+    };
+
+    static u32 s_rune_size(s32 type)
+    {
+        switch (type)
+        {
+            case ascii::TYPE: return sizeof(ascii::rune);
+            case utf8::TYPE: return sizeof(utf8::rune);
+            case utf16::TYPE: return sizeof(utf16::rune);
+            case utf32::TYPE: return sizeof(utf32::rune);
+        }
+        ASSERT(false);
+        return 1;
+    }
+
+    static crunes_t s_make_crunes(s32 type, xbyte const* data, u32 len)
+    {
+        switch (type)
+        {
+            case utf8::TYPE: return crunes_t((utf8::pcrune)data, (utf8::pcrune)(data + len));
+            case utf16::TYPE: return crunes_t((utf16::pcrune)data, (utf16::pcrune)(data + len));
+            case utf32::TYPE: return crunes_t((utf32::pcrune)data, (utf32::pcrune)(data + len));
+        }
+        return crunes_t((ascii::pcrune)data, (ascii::pcrune)(data + len));
+    }
+
+    static inline xbyte const* s_data(crunes_t const& str) { return (xbyte const*)str.m_runes.m_ascii.m_str; }
+    static inline u32          s_len(crunes_t const& str) { return (u32)((xbyte const*)str.m_runes.m_ascii.m_end - (xbyte const*)str.m_runes.m_ascii.m_str); }
+
+    intern_table_t::intern_table_t(alloc_t* a) : m_allocator(a), m_table(nullptr), m_pages(nullptr), m_size(0), m_lock(0), m_arena(nullptr), m_arena_used(0), m_arena_size(0)
+    {
+        if (m_allocator == nullptr)
+        {
+            m_allocator = alloc_t::get_system();
+        }
+    }
+
+    intern_table_t::~intern_table_t() { release(); }
+
+    // Not thread safe, no other thread should use the table
+    void intern_table_t::release()
+    {
+        table_t* table = m_table.load(std::memory_order_relaxed);
+        while (table != nullptr)
+        {
+            table_t* retired = table->m_retired;
+            m_allocator->deallocate(table);
+            table = retired;
+        }
+        m_table.store(nullptr, std::memory_order_relaxed);
+
+        if (m_pages != nullptr)
+        {
+            for (u32 i = 0; i < MAX_PAGES && m_pages[i] != nullptr; ++i)
+                m_allocator->deallocate(m_pages[i]);
+            m_allocator->deallocate(m_pages);
+            m_pages = nullptr;
+        }
+
+        // Arena blocks are linked through their first pointer
+        while (m_arena != nullptr)
+        {
+            xbyte* next = *(xbyte**)m_arena;
+            m_allocator->deallocate(m_arena);
+            m_arena = next;
+        }
+        m_arena_used = 0;
+        m_arena_size = 0;
+        m_size.store(0, std::memory_order_relaxed);
+    }
+
+    handle_t intern_table_t::intern(crunes_t const& str)
+    {
+        xbyte const* data = s_data(str);
+        u32 const    len  = s_len(str);
+        u64 const    hash = calchash(data, len);
+
+        handle_t h = lookup(hash, str.m_type, data, len);
+        if (h.isValid())
+            return h;
+
+        lock();
+        h = insert(hash, str.m_type, data, len);
+        unlock();
+        return h;
+    }
+
+    void intern_table_t::intern(crunes_t const* strs, u32 count, handle_t* handles)
+    {
+        // Most strings of a batch are usually known, resolve those without
+        // locking and only take the lock when there is something to insert.
+        bool locked = false;
+        for (u32 i = 0; i < count; ++i)
+        {
+            xbyte const* data = s_data(strs[i]);
+            u32 const    len  = s_len(strs[i]);
+            u64 const    hash = calchash(data, len);
+
+            handles[i] = lookup(hash, strs[i].m_type, data, len);
+            if (handles[i].isNull())
+            {
+                if (!locked)
+                {
+                    lock();
+                    locked = true;
+                }
+                handles[i] = insert(hash, strs[i].m_type, data, len);
+            }
+        }
+        if (locked)
+            unlock();
+    }
+
+    handle_t intern_table_t::find(crunes_t const& str) const
+    {
+        xbyte const* data = s_data(str);
+        u32 const    len  = s_len(str);
+        return lookup(calchash(data, len), str.m_type, data, len);
+    }
+
+    crunes_t intern_table_t::view(handle_t h) const
+    {
+        ASSERT(h.get() < size());
+        entry_t const& e = m_pages[h.get() / PAGE_ENTRIES][h.get() % PAGE_ENTRIES];
+        return s_make_crunes(e.m_type, e.m_data, e.m_len);
+    }
+
+    u64 intern_table_t::hash(handle_t h) const
+    {
+        ASSERT(h.get() < size());
+        return m_pages[h.get() / PAGE_ENTRIES][h.get() % PAGE_ENTRIES].m_hash;
+    }
+
+    u32 intern_table_t::size() const { return m_size.load(std::memory_order_acquire); }
+
+    // An entry is fully written before its slot is published with a release
+    // store, so a reader that sees the slot also sees the entry and its text.
+    handle_t intern_table_t::lookup(u64 hash, s32 type, xbyte const* data, u32 len) const
+    {
+        table_t* table = m_table.load(std::memory_order_acquire);
+        if (table == nullptr)
+            return handle_t();
+
+        std::atomic<u32>* slots = table->slots();
+        u32               i     = (u32)hash & table->m_mask;
+        while (true)
+        {
+            u32 const slot = slots[i].load(std::memory_order_acquire);
+            if (slot == 0)
+                return handle_t();
+
+            u32 const      index = slot - 1;
+            entry_t const& e     = m_pages[index / PAGE_ENTRIES][index % PAGE_ENTRIES];
+            if (e.m_hash == hash && e.m_len == len && e.m_type == type && x_memcmp(e.m_data, data, len) == 0)
+                return handle_t(index);
+            i = (i + 1) & table->m_mask;
+        }
+    }
+
+    // Called with the lock held
+    handle_t intern_table_t::insert(u64 hash, s32 type, xbyte const* data, u32 len)
+    {
+        // Another thread may have added the string after our lookup
+        handle_t h = lookup(hash, type, data, len);
+        if (h.isValid())
+            return h;
+
+        u32 const index = m_size.load(std::memory_order_relaxed);
+        ASSERT(index < ((u32)PAGE_ENTRIES * (u32)MAX_PAGES));
+
+        if (m_pages == nullptr)
+        {
+            m_pages = (entry_t**)m_allocator->allocate(MAX_PAGES * sizeof(entry_t*), sizeof(void*));
+            x_memclr(m_pages, MAX_PAGES * sizeof(entry_t*));
+        }
+        u32 const page = index / PAGE_ENTRIES;
+        if (m_pages[page] == nullptr)
+        {
+            m_pages[page] = (entry_t*)m_allocator->allocate(PAGE_ENTRIES * sizeof(entry_t), sizeof(void*));
+        }
+
+        entry_t& e = m_pages[page][index % PAGE_ENTRIES];
+        e.m_data   = store(data, len, s_rune_size(type));
+        e.m_hash   = hash;
+        e.m_len    = len;
+        e.m_type   = type;
+
+        table_t* table = m_table.load(std::memory_order_relaxed);
+        if (table == nullptr || ((index + 1) * 2) > (table->m_mask + 1))
+        {
+            grow();
+            table = m_table.load(std::memory_order_relaxed);
+        }
+
+        std::atomic<u32>* slots = table->slots();
+        u32               i     = (u32)hash & table->m_mask;
+        while (slots[i].load(std::memory_order_relaxed) != 0)
+            i = (i + 1) & table->m_mask;
+        slots[i].store(index + 1, std::memory_order_release);
+
+        m_size.store(index + 1, std::memory_order_release);
+        return handle_t(index);
+    }
+
+    // Copy the text and a terminator into the arena
+    xbyte* intern_table_t::store(xbyte const* data, u32 len, u32 rune_size)
+    {
+        u32 const bytes = xalignUp(len + rune_size, (u32)sizeof(void*));
+        if (m_arena == nullptr || (m_arena_used + bytes) > m_arena_size)
+        {
+            u32 const size = xmax((u32)ARENA_BYTES, (u32)sizeof(xbyte*) + bytes);
+            xbyte*    block = (xbyte*)m_allocator->allocate(size, sizeof(void*));
+            *(xbyte**)block = m_arena;
+            m_arena         = block;
+            m_arena_used    = sizeof(xbyte*);
+            m_arena_size    = size;
+        }
+
+        xbyte* str = m_arena + m_arena_used;
+        x_memcpy(str, data, len);
+        x_memclr(str + len, rune_size);
+        m_arena_used += bytes;
+        return str;
+    }
+
+    // Readers may still be probing the current table, so it is not freed but
+    // kept in the retired list until release().
+    void intern_table_t::grow()
+    {
+        table_t* const old      = m_table.load(std::memory_order_relaxed);
+        u32 const      capacity = old == nullptr ? 1024 : (old->m_mask + 1) * 2;
+
+        table_t* table   = (table_t*)m_allocator->allocate(sizeof(table_t) + capacity * sizeof(u32), sizeof(void*));
+        table->m_retired = old;
+        table->m_mask    = capacity - 1;
+        table->m_dummy   = 0;
+        x_memclr(table->slots(), capacity * sizeof(u32));
+
+        std::atomic<u32>* slots = table->slots();
+        u32 const         count = m_size.load(std::memory_order_relaxed);
+        for (u32 index = 0; index < count; ++index)
+        {
+            entry_t const& e = m_pages[index / PAGE_ENTRIES][index % PAGE_ENTRIES];
+            u32            i = (u32)e.m_hash & table->m_mask;
+            while (slots[i].load(std::memory_order_relaxed) != 0)
+                i = (i + 1) & table->m_mask;
+            slots[i].store(index + 1, std::memory_order_relaxed);
+        }
+
+        m_table.store(table, std::memory_order_release);
+    }
+
+    // The holder can be preempted while it allocates an arena block or grows the
+    // table, after a few paused spins the waiting thread yields to it
+    void intern_table_t::lock()
+    {
+        while (m_lock.exchange(1, std::memory_order_acquire) != 0)
+        {
+            u32 spins = 0;
+            while (m_lock.load(std::memory_order_relaxed) != 0)
+            {
+                if (++spins < sLockSpins)
+                    X_INTERN_PAUSE();
+                else
+                    std::this_thread::yield();
+            }
+        }
+    }
+
+    void intern_table_t::unlock() { m_lock.store(0, std::memory_order_release); }
+
+}; // namespace xcore
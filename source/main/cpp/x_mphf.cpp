@@ -0,0 +1,283 @@
+#include "xbase/x_target.h"
+#include "xbase/x_allocator.h"
+#include "xbase/x_buffer.h"
+#include "xbase/x_debug.h"
+#include "xbase/x_hash.h"
+#include "xbase/x_integer.h"
+#include "xbase/x_memory.h"
+
+#include "xbase/x_mphf.h"
+
+namespace xcore
+{
+    static const u32 sRankBlockWords = 8;
+
+    // Every level hashes the key hash again with its own seed (splitmix64
+    // finalizer), the bit is picked with a multiply instead of a modulo.
+    static inline u32 s_position(u64 hash, u32 level, u32 num_bits)
+    {
+        u64 x = hash + (u64)(level + 1) * 0x9E3779B97F4A7C15ull;
+        x     = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x     = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        x     = x ^ (x >> 31);
+        return (u32)(((x >> 32) * (u64)num_bits) >> 32);
+    }
+
+    static inline bool s_test(u64 const* words, u32 bit) { return (words[bit >> 6] & ((u64)1 << (bit & 63))) != 0; }
+    static inline void s_set(u64* words, u32 bit) { words[bit >> 6] |= ((u64)1 << (bit & 63)); }
+
+    mphf_t::mphf_t(alloc_t* a) : m_allocator(a), m_words(nullptr), m_ranks(nullptr), m_fallback(nullptr), m_count(0), m_levels(0), m_fallback_count(0), m_ranked(0)
+    {
+        if (m_allocator == nullptr)
+        {
+            m_allocator = alloc_t::get_system();
+        }
+        m_offsets[0] = 0;
+    }
+
+    mphf_t::~mphf_t() { release(); }
+
+    void mphf_t::release()
+    {
+        if (m_words != nullptr)
+            m_allocator->deallocate(m_words);
+        if (m_ranks != nullptr)
+            m_allocator->deallocate(m_ranks);
+        if (m_fallback != nullptr)
+            m_allocator->deallocate(m_fallback);
+        m_words          = nullptr;
+        m_ranks          = nullptr;
+        m_fallback       = nullptr;
+        m_count          = 0;
+        m_levels         = 0;
+        m_fallback_count = 0;
+        m_ranked         = 0;
+        m_offsets[0]     = 0;
+    }
+
+    u64 mphf_t::hash(cbuffer_t const& key) { return xcore::calchash(key.m_const, key.m_len); }
+
+    bool mphf_t::build(cbuffer_t const* keys, u32 count, u32 gamma)
+    {
+        u64* hashes = (u64*)m_allocator->allocate(xmax(count, 1u) * sizeof(u64), sizeof(u64));
+        for (u32 i = 0; i < count; ++i)
+            hashes[i] = hash(keys[i]);
+        bool const ok = build(hashes, count, gamma);
+        m_allocator->deallocate(hashes);
+        return ok;
+    }
+
+    bool mphf_t::build(u64 const* hashes, u32 count, u32 gamma)
+    {
+        release();
+        gamma = xmax(gamma, 100u);
+
+        // The keys that are left, compacted in place after every level
+        u64* keys = (u64*)m_allocator->allocate(xmax(count, 1u) * sizeof(u64), sizeof(u64));
+        x_memcpy(keys, hashes, count * sizeof(u64));
+
+        u64* levels[MAX_LEVELS];
+        u32  left = count;
+        while (left > 0 && m_levels < MAX_LEVELS)
+        {
+            u32 const num_bits  = xalignUp(xmax((u32)(((u64)left * gamma) / 100), 64u), 64u);
+            u32 const num_words = num_bits / 64;
+            u64*      bits      = (u64*)m_allocator->allocate(num_words * sizeof(u64) * 2, sizeof(u64));
+            u64*      collide   = bits + num_words;
+            x_memclr(bits, num_words * sizeof(u64) * 2);
+
+            for (u32 i = 0; i < left; ++i)
+            {
+                u32 const p = s_position(keys[i], m_levels, num_bits);
+                if (s_test(bits, p))
+                    s_set(collide, p);
+                else
+                    s_set(bits, p);
+            }
+            for (u32 w = 0; w < num_words; ++w)
+                bits[w] &= ~collide[w];
+
+            u32 next = 0;
+            for (u32 i = 0; i < left; ++i)
+            {
+                if (!s_test(bits, s_position(keys[i], m_levels, num_bits)))
+                    keys[next++] = keys[i];
+            }
+
+            levels[m_levels]          = bits;
+            m_offsets[m_levels + 1]   = m_offsets[m_levels] + num_bits;
+            m_levels += 1;
+            left = next;
+        }
+
+        // Concatenate the levels
+        u32 const total_words = m_offsets[m_levels] / 64;
+        m_words               = (u64*)m_allocator->allocate(xmax(total_words, 1u) * sizeof(u64), sizeof(u64));
+        for (u32 l = 0; l < m_levels; ++l)
+        {
+            x_memcpy(m_words + m_offsets[l] / 64, levels[l], (m_offsets[l + 1] - m_offsets[l]) / 8);
+            m_allocator->deallocate(levels[l]);
+        }
+
+        // Insertion sort, this list is empty or very short
+        bool unique = true;
+        if (left > 0)
+        {
+            m_fallback       = (u64*)m_allocator->allocate(left * sizeof(u64), sizeof(u64));
+            m_fallback_count = left;
+            for (u32 i = 0; i < left; ++i)
+            {
+                u64 const h = keys[i];
+                u32       j = i;
+                while (j > 0 && m_fallback[j - 1] > h)
+                {
+                    m_fallback[j] = m_fallback[j - 1];
+                    --j;
+                }
+                m_fallback[j] = h;
+            }
+            for (u32 i = 1; i < left && unique; ++i)
+                unique = m_fallback[i - 1] != m_fallback[i];
+        }
+        m_allocator->deallocate(keys);
+
+        m_count = count;
+        build_ranks();
+        if (!unique)
+        {
+            release();
+            return false;
+        }
+        return true;
+    }
+
+    void mphf_t::build_ranks()
+    {
+        u32 const total_words = m_offsets[m_levels] / 64;
+        u32 const num_blocks  = (total_words + sRankBlockWords - 1) / sRankBlockWords;
+        m_ranks               = (u32*)m_allocator->allocate((num_blocks + 1) * sizeof(u32), sizeof(u32));
+
+        u32 ranked = 0;
+        for (u32 w = 0; w < total_words; ++w)
+        {
+            if ((w % sRankBlockWords) == 0)
+                m_ranks[w / sRankBlockWords] = ranked;
+            ranked += xcountBits(m_words[w]);
+        }
+        m_ranks[num_blocks] = ranked;
+        m_ranked            = ranked;
+    }
+
+    u32 mphf_t::rank(u32 bit) const
+    {
+        u32 const word  = bit >> 6;
+        u32       r     = m_ranks[word / sRankBlockWords];
+        for (u32 w = word - (word % sRankBlockWords); w < word; ++w)
+            r += xcountBits(m_words[w]);
+        return r + xcountBits(m_words[word] & (((u64)1 << (bit & 63)) - 1));
+    }
+
+    u32 mphf_t::lookup(u64 h) const
+    {
+        for (u32 l = 0; l < m_levels; ++l)
+        {
+            u32 const bit = m_offsets[l] + s_position(h, l, m_offsets[l + 1] - m_offsets[l]);
+            if (s_test(m_words, bit))
+                return rank(bit);
+        }
+
+        // Binary search in the fallback list
+        u32 lo = 0, hi = m_fallback_count;
+        while (lo < hi)
+        {
+            u32 const mid = (lo + hi) / 2;
+            if (m_fallback[mid] < h)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo < m_fallback_count && m_fallback[lo] == h)
+            return m_ranked + lo;
+        return INVALID;
+    }
+
+    u32 mphf_t::size_in_bytes() const
+    {
+        u32 const total_words = m_offsets[m_levels] / 64;
+        u32 const num_blocks  = (total_words + sRankBlockWords - 1) / sRankBlockWords;
+        return total_words * sizeof(u64) + (num_blocks + 1) * sizeof(u32) + m_fallback_count * sizeof(u64);
+    }
+
+    u32 mphf_t::serialized_size() const { return 3 * sizeof(u32) + (m_levels + 1) * sizeof(u32) + (m_offsets[m_levels] / 64) * sizeof(u64) + m_fallback_count * sizeof(u64); }
+
+    s32 mphf_t::serialize(binary_writer_t& writer) const
+    {
+        u32 const size = serialized_size();
+        if (!writer.can_write(size))
+            return -1;
+
+        writer.write(m_count);
+        writer.write(m_levels);
+        writer.write(m_fallback_count);
+        for (u32 l = 0; l <= m_levels; ++l)
+            writer.write(m_offsets[l]);
+        u32 const total_words = m_offsets[m_levels] / 64;
+        for (u32 w = 0; w < total_words; ++w)
+            writer.write(m_words[w]);
+        for (u32 i = 0; i < m_fallback_count; ++i)
+            writer.write(m_fallback[i]);
+        return (s32)size;
+    }
+
+    bool mphf_t::deserialize(binary_reader_t& reader)
+    {
+        release();
+
+        u32 count, levels, fallback_count;
+        if (reader.read(count) < 0 || reader.read(levels) < 0 || reader.read(fallback_count) < 0)
+            return false;
+        if (levels > MAX_LEVELS || fallback_count > count || !reader.can_read((levels + 1) * sizeof(u32)))
+            return false;
+
+        // Level offsets should start at 0 and increase in whole words
+        u32 offsets[MAX_LEVELS + 1];
+        for (u32 l = 0; l <= levels; ++l)
+            reader.read(offsets[l]);
+        if (offsets[0] != 0)
+            return false;
+        for (u32 l = 0; l < levels; ++l)
+        {
+            if (offsets[l + 1] <= offsets[l] || (offsets[l + 1] % 64) != 0)
+                return false;
+        }
+
+        u32 const total_words = offsets[levels] / 64;
+        if (!reader.can_read(total_words * sizeof(u64) + fallback_count * sizeof(u64)))
+            return false;
+
+        m_words = (u64*)m_allocator->allocate(xmax(total_words, 1u) * sizeof(u64), sizeof(u64));
+        for (u32 w = 0; w < total_words; ++w)
+            reader.read(m_words[w]);
+        if (fallback_count > 0)
+        {
+            m_fallback = (u64*)m_allocator->allocate(fallback_count * sizeof(u64), sizeof(u64));
+            for (u32 i = 0; i < fallback_count; ++i)
+                reader.read(m_fallback[i]);
+        }
+
+        m_count          = count;
+        m_levels         = levels;
+        m_fallback_count = fallback_count;
+        x_memcpy(m_offsets, offsets, (levels + 1) * sizeof(u32));
+        build_ranks();
+
+        // Every key has exactly one bit or fallback entry
+        if ((m_ranked + m_fallback_count) != m_count)
+        {
+            release();
+            return false;
+        }
+        return true;
+    }
+
+}; // namespace xcore
@@ -1199,6 +1199,7 @@ namespace xcore
                         crunes_t src = (crunes_t)args[argindex];
 						buffer->write(src);
                     }
+                    argindex++;
 
                     size = (s32)buffer->count();
                     sign = '\0';
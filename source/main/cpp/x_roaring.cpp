@@ -0,0 +1,1051 @@
+#include "xbase/x_target.h"
+#include "xbase/x_allocator.h"
+#include "xbase/x_buffer.h"
+#include "xbase/x_debug.h"
+#include "xbase/x_integer.h"
+#include "xbase/x_memory.h"
+
+#include "xbase/x_roaring.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#    define X_ROARING_SSE2
+#    include <emmintrin.h>
+#endif
+
+namespace xcore
+{
+    typedef roaring_t::container_t container_t;
+
+    enum
+    {
+        OP_OR     = 0,
+        OP_AND    = 1,
+        OP_ANDNOT = 2,
+    };
+
+    static const u32 sArrayMax    = roaring_t::ARRAY_MAX_SIZE;
+    static const u32 sBitmapWords = roaring_t::BITMAP_WORDS;
+    static const u32 sBitmapBytes = roaring_t::BITMAP_WORDS * sizeof(u64);
+
+    // ----------------------------------------------------------------------------------------
+    // bitmap kernels
+
+    static void s_bitmap_op(s32 op, u64* dst, u64 const* a, u64 const* b)
+    {
+#ifdef X_ROARING_SSE2
+        __m128i*       vd = (__m128i*)dst;
+        __m128i const* va = (__m128i const*)a;
+        __m128i const* vb = (__m128i const*)b;
+        switch (op)
+        {
+            case OP_OR:
+                for (u32 i = 0; i < sBitmapWords / 2; ++i)
+                    _mm_store_si128(vd + i, _mm_or_si128(_mm_load_si128(va + i), _mm_load_si128(vb + i)));
+                break;
+            case OP_AND:
+                for (u32 i = 0; i < sBitmapWords / 2; ++i)
+                    _mm_store_si128(vd + i, _mm_and_si128(_mm_load_si128(va + i), _mm_load_si128(vb + i)));
+                break;
+            case OP_ANDNOT:
+                for (u32 i = 0; i < sBitmapWords / 2; ++i)
+                    _mm_store_si128(vd + i, _mm_andnot_si128(_mm_load_si128(vb + i), _mm_load_si128(va + i)));
+                break;
+        }
+#else
+        switch (op)
+        {
+            case OP_OR:
+                for (u32 i = 0; i < sBitmapWords; ++i)
+                    dst[i] = a[i] | b[i];
+                break;
+            case OP_AND:
+                for (u32 i = 0; i < sBitmapWords; ++i)
+                    dst[i] = a[i] & b[i];
+                break;
+            case OP_ANDNOT:
+                for (u32 i = 0; i < sBitmapWords; ++i)
+                    dst[i] = a[i] & ~b[i];
+                break;
+        }
+#endif
+    }
+
+    static u32 s_bitmap_cardinality(u64 const* words)
+    {
+        u32 card = 0;
+        for (u32 i = 0; i < sBitmapWords; ++i)
+            card += xcountBits(words[i]);
+        return card;
+    }
+
+    // Set the bits in [from, to)
+    static void s_bitmap_set_range(u64* words, u32 from, u32 to)
+    {
+        while (from < to)
+        {
+            u32 const b = from & 63;
+            u32       n = to - from;
+            if (n > (64 - b))
+                n = 64 - b;
+            u64 const m = (n == 64) ? ~(u64)0 : ((((u64)1 << n) - 1) << b);
+            words[from >> 6] |= m;
+            from += n;
+        }
+    }
+
+    // ----------------------------------------------------------------------------------------
+    // u16 array kernels, all of them return the number of values written to @out
+
+    static s32 s_array_find(u16 const* data, u32 size, u16 value)
+    {
+        s32 lo = 0;
+        s32 hi = (s32)size - 1;
+        while (lo <= hi)
+        {
+            s32 const mid = (lo + hi) >> 1;
+            if (data[mid] < value)
+                lo = mid + 1;
+            else if (data[mid] > value)
+                hi = mid - 1;
+            else
+                return mid;
+        }
+        return -(lo + 1);
+    }
+
+    static u32 s_array_union(u16 const* a, u32 na, u16 const* b, u32 nb, u16* out)
+    {
+        u32 i = 0, j = 0, n = 0;
+        while (i < na && j < nb)
+        {
+            if (a[i] < b[j])
+                out[n++] = a[i++];
+            else if (b[j] < a[i])
+                out[n++] = b[j++];
+            else
+            {
+                out[n++] = a[i++];
+                j++;
+            }
+        }
+        while (i < na)
+            out[n++] = a[i++];
+        while (j < nb)
+            out[n++] = b[j++];
+        return n;
+    }
+
+    // Index of the first value in @data[lo, size) that is >= @value
+    static u32 s_array_gallop(u16 const* data, u32 lo, u32 size, u16 value)
+    {
+        u32 step = 1;
+        u32 hi   = lo;
+        while (hi < size && data[hi] < value)
+        {
+            lo = hi + 1;
+            hi += step;
+            step <<= 1;
+        }
+        if (hi > size)
+            hi = size;
+        while (lo < hi)
+        {
+            u32 const mid = (lo + hi) >> 1;
+            if (data[mid] < value)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    static u32 s_array_intersect(u16 const* a, u32 na, u16 const* b, u32 nb, u16* out)
+    {
+        if (na > nb)
+        {
+            x_swap(a, b);
+            x_swap(na, nb);
+        }
+
+        u32 n = 0;
+        if ((na * 32) < nb)
+        {
+            // Very different sizes, gallop through the large array
+            u32 j = 0;
+            for (u32 i = 0; i < na && j < nb; ++i)
+            {
+                j = s_array_gallop(b, j, nb, a[i]);
+                if (j < nb && b[j] == a[i])
+                    out[n++] = a[i];
+            }
+            return n;
+        }
+
+        u32 i = 0, j = 0;
+        while (i < na && j < nb)
+        {
+            if (a[i] < b[j])
+                i++;
+            else if (b[j] < a[i])
+                j++;
+            else
+            {
+                out[n++] = a[i++];
+                j++;
+            }
+        }
+        return n;
+    }
+
+    static u32 s_array_difference(u16 const* a, u32 na, u16 const* b, u32 nb, u16* out)
+    {
+        u32 i = 0, j = 0, n = 0;
+        while (i < na && j < nb)
+        {
+            if (a[i] < b[j])
+                out[n++] = a[i++];
+            else if (b[j] < a[i])
+                j++;
+            else
+            {
+                i++;
+                j++;
+            }
+        }
+        while (i < na)
+            out[n++] = a[i++];
+        return n;
+    }
+
+    // ----------------------------------------------------------------------------------------
+    // containers
+
+    static inline u64*       c_words(container_t& c) { return (u64*)c.m_data; }
+    static inline u64 const* c_words(container_t const& c) { return (u64 const*)c.m_data; }
+
+    static void c_init(container_t& c, u16 key)
+    {
+        c.m_key      = key;
+        c.m_type     = roaring_t::TYPE_ARRAY;
+        c.m_size     = 0;
+        c.m_capacity = 0;
+        c.m_data     = nullptr;
+    }
+
+    static void c_release(alloc_t* alloc, container_t& c)
+    {
+        if (c.m_data != nullptr)
+            alloc->deallocate(c.m_data);
+        c_init(c, c.m_key);
+    }
+
+    static inline u32 c_used_u16(container_t const& c) { return c.m_type == roaring_t::TYPE_RUN ? c.m_size * 2 : c.m_size; }
+
+    // Grow the u16 storage of an array or run container
+    static void c_reserve(alloc_t* alloc, container_t& c, u32 capacity)
+    {
+        if (capacity < 4)
+            capacity = 4;
+        if (capacity <= c.m_capacity)
+            return;
+        u16* data = (u16*)alloc->allocate(capacity * sizeof(u16), sizeof(u64));
+        if (c.m_data != nullptr)
+        {
+            x_memcpy(data, c.m_data, c_used_u16(c) * sizeof(u16));
+            alloc->deallocate(c.m_data);
+        }
+        c.m_data     = data;
+        c.m_capacity = capacity;
+    }
+
+    static void c_copy(alloc_t* alloc, container_t& dst, container_t const& src)
+    {
+        c_init(dst, src.m_key);
+        dst.m_type = src.m_type;
+        dst.m_size = src.m_size;
+        if (src.m_type == roaring_t::TYPE_BITMAP)
+        {
+            dst.m_data = (u16*)alloc->allocate(sBitmapBytes, X_CACHE_LINE_SIZE);
+            x_memcpy(dst.m_data, src.m_data, sBitmapBytes);
+        }
+        else
+        {
+            u32 const used = c_used_u16(src);
+            dst.m_capacity = used < 4 ? 4 : used;
+            dst.m_data     = (u16*)alloc->allocate(dst.m_capacity * sizeof(u16), sizeof(u64));
+            x_memcpy(dst.m_data, src.m_data, used * sizeof(u16));
+        }
+    }
+
+    static u32 c_cardinality(container_t const& c)
+    {
+        if (c.m_type != roaring_t::TYPE_RUN)
+            return c.m_size;
+        u32 card = 0;
+        for (u32 i = 0; i < c.m_size; ++i)
+            card += (u32)c.m_data[i * 2 + 1] + 1;
+        return card;
+    }
+
+    // Index of the last run that starts at or before @value, or -1
+    static s32 s_run_find(u16 const* runs, u32 numruns, u16 value)
+    {
+        s32 lo = 0;
+        s32 hi = (s32)numruns - 1;
+        s32 r  = -1;
+        while (lo <= hi)
+        {
+            s32 const mid = (lo + hi) >> 1;
+            if (runs[mid * 2] <= value)
+            {
+                r  = mid;
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid - 1;
+            }
+        }
+        return r;
+    }
+
+    static bool c_contains(container_t const& c, u16 value)
+    {
+        switch (c.m_type)
+        {
+            case roaring_t::TYPE_ARRAY: return s_array_find(c.m_data, c.m_size, value) >= 0;
+            case roaring_t::TYPE_BITMAP: return ((c_words(c)[value >> 6] >> (value & 63)) & 1) != 0;
+        }
+        s32 const r = s_run_find(c.m_data, c.m_size, value);
+        return r >= 0 && (u32)(value - c.m_data[r * 2]) <= (u32)c.m_data[r * 2 + 1];
+    }
+
+    static void c_fill_bitmap(container_t const& c, u64* words)
+    {
+        if (c.m_type == roaring_t::TYPE_BITMAP)
+        {
+            x_memcpy(words, c.m_data, sBitmapBytes);
+            return;
+        }
+
+        x_memclr(words, sBitmapBytes);
+        if (c.m_type == roaring_t::TYPE_ARRAY)
+        {
+            for (u32 i = 0; i < c.m_size; ++i)
+                words[c.m_data[i] >> 6] |= (u64)1 << (c.m_data[i] & 63);
+        }
+        else
+        {
+            for (u32 i = 0; i < c.m_size; ++i)
+            {
+                u32 const start = c.m_data[i * 2];
+                s_bitmap_set_range(words, start, start + c.m_data[i * 2 + 1] + 1);
+            }
+        }
+    }
+
+    static void c_to_bitmap(alloc_t* alloc, container_t& c)
+    {
+        if (c.m_type == roaring_t::TYPE_BITMAP)
+            return;
+        u64* words = (u64*)alloc->allocate(sBitmapBytes, X_CACHE_LINE_SIZE);
+        c_fill_bitmap(c, words);
+        u32 const card = c_cardinality(c);
+        if (c.m_data != nullptr)
+            alloc->deallocate(c.m_data);
+        c.m_type     = roaring_t::TYPE_BITMAP;
+        c.m_size     = card;
+        c.m_capacity = 0;
+        c.m_data     = (u16*)words;
+    }
+
+    // The cardinality of the container should be <= ARRAY_MAX_SIZE
+    static void c_to_array(alloc_t* alloc, container_t& c)
+    {
+        if (c.m_type == roaring_t::TYPE_ARRAY)
+            return;
+
+        u32 const card     = c_cardinality(c);
+        u32 const capacity = card < 4 ? 4 : card;
+        ASSERT(card <= sArrayMax);
+
+        u16* data = (u16*)alloc->allocate(capacity * sizeof(u16), sizeof(u64));
+        u32  n    = 0;
+        if (c.m_type == roaring_t::TYPE_BITMAP)
+        {
+            u64 const* words = c_words(c);
+            for (u32 w = 0; w < sBitmapWords; ++w)
+            {
+                u64 word = words[w];
+                while (word != 0)
+                {
+                    data[n++] = (u16)((w << 6) + xcountTrailingZeros(word));
+                    word &= word - 1;
+                }
+            }
+        }
+        else
+        {
+            for (u32 i = 0; i < c.m_size; ++i)
+            {
+                u32 const start = c.m_data[i * 2];
+                u32 const end   = start + c.m_data[i * 2 + 1];
+                for (u32 v = start; v <= end; ++v)
+                    data[n++] = (u16)v;
+            }
+        }
+
+        if (c.m_data != nullptr)
+            alloc->deallocate(c.m_data);
+        c.m_type     = roaring_t::TYPE_ARRAY;
+        c.m_size     = card;
+        c.m_capacity = capacity;
+        c.m_data     = data;
+    }
+
+    // Turn the container into an array or bitmap container depending on its cardinality
+    static void c_normalize(alloc_t* alloc, container_t& c)
+    {
+        if (c_cardinality(c) <= sArrayMax)
+            c_to_array(alloc, c);
+        else
+            c_to_bitmap(alloc, c);
+    }
+
+    static u32 c_num_runs(container_t const& c)
+    {
+        u32 runs = 0;
+        switch (c.m_type)
+        {
+            case roaring_t::TYPE_ARRAY:
+                for (u32 i = 0; i < c.m_size; ++i)
+                    if (i == 0 || c.m_data[i] != (u16)(c.m_data[i - 1] + 1))
+                        runs++;
+                return runs;
+            case roaring_t::TYPE_BITMAP:
+            {
+                u64 const* words = c_words(c);
+                u64        carry = 0;
+                for (u32 w = 0; w < sBitmapWords; ++w)
+                {
+                    u64 const word = words[w];
+                    runs += xcountBits(word & ~((word << 1) | carry));
+                    carry = word >> 63;
+                }
+                return runs;
+            }
+        }
+        return c.m_size;
+    }
+
+    static void c_to_run(alloc_t* alloc, container_t& c, u32 numruns)
+    {
+        u16* runs = (u16*)alloc->allocate(numruns * 2 * sizeof(u16), sizeof(u64));
+        u32  n    = 0;
+        s32  start = -1;
+        s32  prev  = -1;
+        if (c.m_type == roaring_t::TYPE_ARRAY)
+        {
+            for (u32 i = 0; i < c.m_size; ++i)
+            {
+                s32 const v = c.m_data[i];
+                if (start < 0 || v != (prev + 1))
+                {
+                    if (start >= 0)
+                    {
+                        runs[n++] = (u16)start;
+                        runs[n++] = (u16)(prev - start);
+                    }
+                    start = v;
+                }
+                prev = v;
+            }
+        }
+        else
+        {
+            u64 const* words = c_words(c);
+            for (u32 w = 0; w < sBitmapWords; ++w)
+            {
+                u64 word = words[w];
+                while (word != 0)
+                {
+                    s32 const v = (s32)((w << 6) + xcountTrailingZeros(word));
+                    word &= word - 1;
+                    if (start < 0 || v != (prev + 1))
+                    {
+                        if (start >= 0)
+                        {
+                            runs[n++] = (u16)start;
+                            runs[n++] = (u16)(prev - start);
+                        }
+                        start = v;
+                    }
+                    prev = v;
+                }
+            }
+        }
+        runs[n++] = (u16)start;
+        runs[n++] = (u16)(prev - start);
+        ASSERT(n == numruns * 2);
+
+        alloc->deallocate(c.m_data);
+        c.m_type     = roaring_t::TYPE_RUN;
+        c.m_size     = numruns;
+        c.m_capacity = numruns * 2;
+        c.m_data     = runs;
+    }
+
+    static bool c_add(alloc_t* alloc, container_t& c, u16 value)
+    {
+        if (c.m_type == roaring_t::TYPE_RUN)
+        {
+            if (c_contains(c, value))
+                return false;
+            c_normalize(alloc, c);
+        }
+
+        if (c.m_type == roaring_t::TYPE_ARRAY)
+        {
+            s32 i = s_array_find(c.m_data, c.m_size, value);
+            if (i >= 0)
+                return false;
+
+            if (c.m_size < sArrayMax)
+            {
+                i = -(i + 1);
+                if (c.m_size == c.m_capacity)
+                {
+                    u32 const capacity = c.m_capacity * 2;
+                    c_reserve(alloc, c, capacity > sArrayMax ? sArrayMax : capacity);
+                }
+                xmem::memmove(c.m_data + i + 1, c.m_data + i, (c.m_size - i) * sizeof(u16));
+                c.m_data[i] = value;
+                c.m_size += 1;
+                return true;
+            }
+            c_to_bitmap(alloc, c);
+        }
+
+        u64&      word = c_words(c)[value >> 6];
+        u64 const m    = (u64)1 << (value & 63);
+        if ((word & m) != 0)
+            return false;
+        word |= m;
+        c.m_size += 1;
+        return true;
+    }
+
+    static bool c_remove(alloc_t* alloc, container_t& c, u16 value)
+    {
+        if (!c_contains(c, value))
+            return false;
+
+        if (c.m_type == roaring_t::TYPE_RUN)
+            c_normalize(alloc, c);
+
+        if (c.m_type == roaring_t::TYPE_ARRAY)
+        {
+            s32 const i = s_array_find(c.m_data, c.m_size, value);
+            xmem::memmove(c.m_data + i, c.m_data + i + 1, (c.m_size - i - 1) * sizeof(u16));
+            c.m_size -= 1;
+            return true;
+        }
+
+        c_words(c)[value >> 6] &= ~((u64)1 << (value & 63));
+        c.m_size -= 1;
+        if (c.m_size <= sArrayMax)
+            c_to_array(alloc, c);
+        return true;
+    }
+
+    // Keep the values of array container @a that are (or are not) in @other
+    static u32 s_array_filter(container_t const& a, container_t const& other, bool keep_contained, u16* out)
+    {
+        u32 n = 0;
+        for (u32 i = 0; i < a.m_size; ++i)
+        {
+            if (c_contains(other, a.m_data[i]) == keep_contained)
+                out[n++] = a.m_data[i];
+        }
+        return n;
+    }
+
+    static u64 const* c_as_bitmap(alloc_t* alloc, container_t const& c, u64*& scratch)
+    {
+        if (c.m_type == roaring_t::TYPE_BITMAP)
+            return c_words(c);
+        if (scratch == nullptr)
+            scratch = (u64*)alloc->allocate(sBitmapBytes, X_CACHE_LINE_SIZE);
+        c_fill_bitmap(c, scratch);
+        return scratch;
+    }
+
+    // out = a op b, @out can be empty
+    static void c_op(alloc_t* alloc, s32 op, container_t const& a, container_t const& b, container_t& out, u64*& scratch_a, u64*& scratch_b)
+    {
+        c_init(out, a.m_key);
+
+        bool const a_is_array = a.m_type == roaring_t::TYPE_ARRAY;
+        bool const b_is_array = b.m_type == roaring_t::TYPE_ARRAY;
+        if (a_is_array && b_is_array)
+        {
+            switch (op)
+            {
+                case OP_OR:
+                    if ((a.m_size + b.m_size) > sArrayMax)
+                        break;
+                    c_reserve(alloc, out, a.m_size + b.m_size);
+                    out.m_size = s_array_union(a.m_data, a.m_size, b.m_data, b.m_size, out.m_data);
+                    return;
+                case OP_AND:
+                    c_reserve(alloc, out, xmin(a.m_size, b.m_size));
+                    out.m_size = s_array_intersect(a.m_data, a.m_size, b.m_data, b.m_size, out.m_data);
+                    return;
+                case OP_ANDNOT:
+                    c_reserve(alloc, out, a.m_size);
+                    out.m_size = s_array_difference(a.m_data, a.m_size, b.m_data, b.m_size, out.m_data);
+                    return;
+            }
+        }
+        else if (op == OP_AND && (a_is_array || b_is_array))
+        {
+            container_t const& arr   = a_is_array ? a : b;
+            container_t const& other = a_is_array ? b : a;
+            c_reserve(alloc, out, arr.m_size);
+            out.m_size = s_array_filter(arr, other, true, out.m_data);
+            return;
+        }
+        else if (op == OP_ANDNOT && a_is_array)
+        {
+            c_reserve(alloc, out, a.m_size);
+            out.m_size = s_array_filter(a, b, false, out.m_data);
+            return;
+        }
+
+        u64 const* wa    = c_as_bitmap(alloc, a, scratch_a);
+        u64 const* wb    = c_as_bitmap(alloc, b, scratch_b);
+        u64*       words = (u64*)alloc->allocate(sBitmapBytes, X_CACHE_LINE_SIZE);
+        s_bitmap_op(op, words, wa, wb);
+
+        out.m_type = roaring_t::TYPE_BITMAP;
+        out.m_data = (u16*)words;
+        out.m_size = s_bitmap_cardinality(words);
+        if (out.m_size <= sArrayMax)
+            c_to_array(alloc, out);
+    }
+
+    // ----------------------------------------------------------------------------------------
+    // roaring_t
+
+    roaring_t::roaring_t(alloc_t* a) : m_allocator(a), m_containers(nullptr), m_size(0), m_capacity(0)
+    {
+        if (m_allocator == nullptr)
+        {
+            m_allocator = alloc_t::get_system();
+        }
+    }
+
+    roaring_t::~roaring_t() { release(); }
+
+    void roaring_t::release()
+    {
+        clear();
+        if (m_containers != nullptr)
+        {
+            m_allocator->deallocate(m_containers);
+        }
+        m_containers = nullptr;
+        m_capacity   = 0;
+    }
+
+    void roaring_t::clear()
+    {
+        for (u32 i = 0; i < m_size; ++i)
+            c_release(m_allocator, m_containers[i]);
+        m_size = 0;
+    }
+
+    void roaring_t::copy(roaring_t const& other)
+    {
+        if (&other == this)
+            return;
+        clear();
+        reserve(other.m_size);
+        for (u32 i = 0; i < other.m_size; ++i)
+            c_copy(m_allocator, m_containers[i], other.m_containers[i]);
+        m_size = other.m_size;
+    }
+
+    void roaring_t::reserve(u32 capacity)
+    {
+        if (capacity <= m_capacity)
+            return;
+        container_t* containers = (container_t*)m_allocator->allocate(capacity * sizeof(container_t), sizeof(void*));
+        if (m_containers != nullptr)
+        {
+            x_memcpy(containers, m_containers, m_size * sizeof(container_t));
+            m_allocator->deallocate(m_containers);
+        }
+        m_containers = containers;
+        m_capacity   = capacity;
+    }
+
+    s32 roaring_t::find(u16 key) const
+    {
+        s32 lo = 0;
+        s32 hi = (s32)m_size - 1;
+        while (lo <= hi)
+        {
+            s32 const mid = (lo + hi) >> 1;
+            if (m_containers[mid].m_key < key)
+                lo = mid + 1;
+            else if (m_containers[mid].m_key > key)
+                hi = mid - 1;
+            else
+                return mid;
+        }
+        return -(lo + 1);
+    }
+
+    u32 roaring_t::insert_at(u32 index, u16 key)
+    {
+        if (m_size == m_capacity)
+            reserve(m_capacity < 4 ? 4 : m_capacity * 2);
+        xmem::memmove(m_containers + index + 1, m_containers + index, (m_size - index) * sizeof(container_t));
+        c_init(m_containers[index], key);
+        m_size += 1;
+        return index;
+    }
+
+    void roaring_t::remove_at(u32 index)
+    {
+        c_release(m_allocator, m_containers[index]);
+        xmem::memmove(m_containers + index, m_containers + index + 1, (m_size - index - 1) * sizeof(container_t));
+        m_size -= 1;
+    }
+
+    bool roaring_t::add(u32 value)
+    {
+        u16 const key = (u16)(value >> 16);
+        s32       i   = find(key);
+        if (i < 0)
+            i = (s32)insert_at((u32)(-(i + 1)), key);
+        return c_add(m_allocator, m_containers[i], (u16)value);
+    }
+
+    bool roaring_t::remove(u32 value)
+    {
+        s32 const i = find((u16)(value >> 16));
+        if (i < 0)
+            return false;
+        bool const removed = c_remove(m_allocator, m_containers[i], (u16)value);
+        if (m_containers[i].m_size == 0)
+            remove_at((u32)i);
+        return removed;
+    }
+
+    bool roaring_t::contains(u32 value) const
+    {
+        s32 const i = find((u16)(value >> 16));
+        return i >= 0 && c_contains(m_containers[i], (u16)value);
+    }
+
+    u64 roaring_t::cardinality() const
+    {
+        u64 card = 0;
+        for (u32 i = 0; i < m_size; ++i)
+            card += c_cardinality(m_containers[i]);
+        return card;
+    }
+
+    bool roaring_t::run_optimize()
+    {
+        bool converted = false;
+        for (u32 i = 0; i < m_size; ++i)
+        {
+            container_t& c         = m_containers[i];
+            u32 const    card      = c_cardinality(c);
+            u32 const    numruns   = c_num_runs(c);
+            u32 const    run_bytes = numruns * 2 * sizeof(u16);
+            u32 const    alt_bytes = card <= sArrayMax ? card * sizeof(u16) : sBitmapBytes;
+            if (c.m_type == TYPE_RUN)
+            {
+                if (run_bytes >= alt_bytes)
+                    c_normalize(m_allocator, c);
+            }
+            else if (run_bytes < alt_bytes)
+            {
+                c_to_run(m_allocator, c, numruns);
+                converted = true;
+            }
+        }
+        return converted;
+    }
+
+    void roaring_t::set_union(roaring_t const& other)
+    {
+        if (&other != this)
+            set_op(OP_OR, other);
+    }
+
+    void roaring_t::set_intersection(roaring_t const& other)
+    {
+        if (&other != this)
+            set_op(OP_AND, other);
+    }
+
+    void roaring_t::set_difference(roaring_t const& other)
+    {
+        if (&other == this)
+            clear();
+        else
+            set_op(OP_ANDNOT, other);
+    }
+
+    void roaring_t::set_op(s32 op, roaring_t const& other)
+    {
+        u32 const    capacity   = m_size + other.m_size;
+        container_t* containers = capacity > 0 ? (container_t*)m_allocator->allocate(capacity * sizeof(container_t), sizeof(void*)) : nullptr;
+        u64*         scratch_a  = nullptr;
+        u64*         scratch_b  = nullptr;
+
+        u32 i = 0, j = 0, n = 0;
+        while (i < m_size || j < other.m_size)
+        {
+            if (j == other.m_size || (i < m_size && m_containers[i].m_key < other.m_containers[j].m_key))
+            {
+                // Only in this set
+                if (op == OP_AND)
+                    c_release(m_allocator, m_containers[i]);
+                else
+                    containers[n++] = m_containers[i];
+                i++;
+            }
+            else if (i == m_size || other.m_containers[j].m_key < m_containers[i].m_key)
+            {
+                // Only in the other set
+                if (op == OP_OR)
+                    c_copy(m_allocator, containers[n++], other.m_containers[j]);
+                j++;
+            }
+            else
+            {
+                container_t& out = containers[n];
+                c_op(m_allocator, op, m_containers[i], other.m_containers[j], out, scratch_a, scratch_b);
+                c_release(m_allocator, m_containers[i]);
+                if (out.m_size == 0)
+                    c_release(m_allocator, out);
+                else
+                    n++;
+                i++;
+                j++;
+            }
+        }
+
+        if (scratch_a != nullptr)
+            m_allocator->deallocate(scratch_a);
+        if (scratch_b != nullptr)
+            m_allocator->deallocate(scratch_b);
+        if (m_containers != nullptr)
+            m_allocator->deallocate(m_containers);
+
+        m_containers = containers;
+        m_size       = n;
+        m_capacity   = capacity;
+    }
+
+    // ----------------------------------------------------------------------------------------
+    // serialization
+
+    static u32 c_data_size(container_t const& c)
+    {
+        switch (c.m_type)
+        {
+            case roaring_t::TYPE_ARRAY: return c.m_size * sizeof(u16);
+            case roaring_t::TYPE_BITMAP: return sBitmapBytes;
+        }
+        return c.m_size * 2 * sizeof(u16);
+    }
+
+    u32 roaring_t::serialized_size() const
+    {
+        u32 size = sizeof(u32);
+        for (u32 i = 0; i < m_size; ++i)
+            size += sizeof(u16) + sizeof(u16) + sizeof(u32) + c_data_size(m_containers[i]);
+        return size;
+    }
+
+    s32 roaring_t::serialize(binary_writer_t& writer) const
+    {
+        u32 const size = serialized_size();
+        if (!writer.can_write(size))
+            return -1;
+
+        writer.write(m_size);
+        for (u32 i = 0; i < m_size; ++i)
+        {
+            container_t const& c = m_containers[i];
+            writer.write(c.m_key);
+            writer.write(c.m_type);
+            writer.write(c.m_size);
+            if (c.m_type == TYPE_BITMAP)
+            {
+                u64 const* words = c_words(c);
+                for (u32 w = 0; w < sBitmapWords; ++w)
+                    writer.write(words[w]);
+            }
+            else
+            {
+                u32 const used = c_used_u16(c);
+                for (u32 v = 0; v < used; ++v)
+                    writer.write(c.m_data[v]);
+            }
+        }
+        return (s32)size;
+    }
+
+    bool roaring_t::deserialize(binary_reader_t& reader)
+    {
+        clear();
+
+        u32 count;
+        if (reader.read(count) < 0 || count > 65536)
+            return false;
+        reserve(count);
+
+        s32 prev_key = -1;
+        u32 i        = 0;
+        for (; i < count; ++i)
+        {
+            u16 key, type;
+            u32 size;
+            if (reader.read(key) < 0 || reader.read(type) < 0 || reader.read(size) < 0)
+                break;
+            if ((s32)key <= prev_key || size == 0)
+                break;
+
+            container_t& c = m_containers[m_size];
+            c_init(c, key);
+            c.m_type = type;
+            c.m_size = size;
+
+            bool valid = false;
+            if (type == TYPE_BITMAP)
+            {
+                if (size <= sArrayMax || size > 65536 || !reader.can_read(sBitmapBytes))
+                    break;
+                u64* words = (u64*)m_allocator->allocate(sBitmapBytes, X_CACHE_LINE_SIZE);
+                for (u32 w = 0; w < sBitmapWords; ++w)
+                    reader.read(words[w]);
+                c.m_data = (u16*)words;
+                valid    = s_bitmap_cardinality(words) == size;
+            }
+            else if (type == TYPE_ARRAY || type == TYPE_RUN)
+            {
+                u32 const used = type == TYPE_RUN ? size * 2 : size;
+                if ((type == TYPE_ARRAY && size > sArrayMax) || (type == TYPE_RUN && size > 32768) || !reader.can_read(used * sizeof(u16)))
+                    break;
+                c_reserve(m_allocator, c, used);
+                for (u32 v = 0; v < used; ++v)
+                    reader.read(c.m_data[v]);
+
+                // Values (or runs) should be sorted and not overlap
+                valid = true;
+                if (type == TYPE_ARRAY)
+                {
+                    for (u32 v = 1; v < size && valid; ++v)
+                        valid = c.m_data[v - 1] < c.m_data[v];
+                }
+                else
+                {
+                    for (u32 r = 0; r < size && valid; ++r)
+                    {
+                        u32 const end = (u32)c.m_data[r * 2] + c.m_data[r * 2 + 1];
+                        valid         = end < 65536 && (r + 1 == size || end + 1 < c.m_data[r * 2 + 2]);
+                    }
+                }
+            }
+            else
+            {
+                break;
+            }
+
+            m_size += 1;
+            if (!valid)
+                break;
+            prev_key = key;
+        }
+
+        if (i != count)
+        {
+            clear();
+            return false;
+        }
+        return true;
+    }
+
+    // ----------------------------------------------------------------------------------------
+    // iterator
+
+    roaring_t::iter_t::iter_t(roaring_t const& set) : m_set(&set), m_container(0), m_pos(0), m_offset(0), m_word(0) { enter(); }
+
+    void roaring_t::iter_t::enter()
+    {
+        m_pos    = 0;
+        m_offset = 0;
+        m_word   = 0;
+        if (m_container < m_set->m_size && m_set->m_containers[m_container].m_type == TYPE_BITMAP)
+            m_word = c_words(m_set->m_containers[m_container])[0];
+    }
+
+    bool roaring_t::iter_t::next(u32& value)
+    {
+        while (m_container < m_set->m_size)
+        {
+            container_t const& c    = m_set->m_containers[m_container];
+            u32 const          high = (u32)c.m_key << 16;
+            if (c.m_type == TYPE_ARRAY)
+            {
+                if (m_pos < c.m_size)
+                {
+                    value = high | c.m_data[m_pos++];
+                    return true;
+                }
+            }
+            else if (c.m_type == TYPE_BITMAP)
+            {
+                u64 const* words = c_words(c);
+                while (m_word == 0 && ++m_pos < sBitmapWords)
+                    m_word = words[m_pos];
+                if (m_word != 0)
+                {
+                    value = high | ((m_pos << 6) + xcountTrailingZeros(m_word));
+                    m_word &= m_word - 1;
+                    return true;
+                }
+            }
+            else
+            {
+                if (m_pos < c.m_size)
+                {
+                    value = high | (c.m_data[m_pos * 2] + m_offset);
+                    if (m_offset == c.m_data[m_pos * 2 + 1])
+                    {
+                        m_pos += 1;
+                        m_offset = 0;
+                    }
+                    else
+                    {
+                        m_offset += 1;
+                    }
+                    return true;
+                }
+            }
+
+            m_container += 1;
+            enter();
+        }
+        return false;
+    }
+
+}; // namespace xcore
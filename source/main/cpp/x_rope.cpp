@@ -0,0 +1,386 @@
+#include "xbase/x_target.h"
+#include "xbase/x_allocator.h"
+#include "xbase/x_debug.h"
+#include "xbase/x_integer.h"
+#include "xbase/x_memory.h"
+
+#include "xbase/x_rope.h"
+
+namespace xcore
+{
+    static const s32 sChunkBytes = 1024;
+
+    // The text of a node follows the node in the same allocation
+    struct rope_t::node_t
+    {
+        node_t* m_left;
+        node_t* m_right;
+        u32     m_priority;
+        s32     m_size; // number of code units in this subtree
+        s32     m_len;  // number of code units in this chunk
+        s32     m_dummy;
+
+        inline xbyte*       data() { return (xbyte*)(this + 1); }
+        inline xbyte const* data() const { return (xbyte const*)(this + 1); }
+    };
+
+    static inline s32 s_size(rope_t::node_t const* node) { return node == nullptr ? 0 : node->m_size; }
+    static inline void s_update(rope_t::node_t* node) { node->m_size = s_size(node->m_left) + node->m_len + s_size(node->m_right); }
+
+    static s32 s_rune_size(s32 type)
+    {
+        switch (type)
+        {
+            case ascii::TYPE: return sizeof(ascii::rune);
+            case utf8::TYPE: return sizeof(utf8::rune);
+            case utf16::TYPE: return sizeof(utf16::rune);
+            case utf32::TYPE: return sizeof(utf32::rune);
+        }
+        ASSERT(false);
+        return 1;
+    }
+
+    static crunes_t s_make_crunes(s32 type, xbyte const* data, s32 len)
+    {
+        switch (type)
+        {
+            case utf8::TYPE: return crunes_t((utf8::pcrune)data, (utf8::pcrune)data + len);
+            case utf16::TYPE: return crunes_t((utf16::pcrune)data, (utf16::pcrune)data + len);
+            case utf32::TYPE: return crunes_t((utf32::pcrune)data, (utf32::pcrune)data + len);
+        }
+        return crunes_t((ascii::pcrune)data, (ascii::pcrune)data + len);
+    }
+
+    rope_t::rope_t(alloc_t* a, s32 type) : m_allocator(a), m_root(nullptr), m_type(type), m_rune_size(s_rune_size(type)), m_chunk_len(sChunkBytes / s_rune_size(type)), m_seed(0x9E3779B9)
+    {
+        if (m_allocator == nullptr)
+        {
+            m_allocator = alloc_t::get_system();
+        }
+    }
+
+    rope_t::~rope_t() { clear(); }
+
+    s32 rope_t::size() const { return s_size(m_root); }
+
+    void rope_t::clear()
+    {
+        free_tree(m_root);
+        m_root = nullptr;
+    }
+
+    rope_t::node_t* rope_t::new_node()
+    {
+        node_t* node = (node_t*)m_allocator->allocate(sizeof(node_t) + sChunkBytes, sizeof(void*));
+        node->m_left  = nullptr;
+        node->m_right = nullptr;
+
+        // xorshift32
+        m_seed ^= m_seed << 13;
+        m_seed ^= m_seed >> 17;
+        m_seed ^= m_seed << 5;
+        node->m_priority = m_seed;
+        node->m_size     = 0;
+        node->m_len      = 0;
+        node->m_dummy    = 0;
+        return node;
+    }
+
+    void rope_t::free_tree(node_t* node)
+    {
+        if (node == nullptr)
+            return;
+        free_tree(node->m_left);
+        free_tree(node->m_right);
+        m_allocator->deallocate(node);
+    }
+
+    // Build a tree out of full chunks holding @data
+    rope_t::node_t* rope_t::build(xbyte const* data, s32 len)
+    {
+        node_t* root = nullptr;
+        while (len > 0)
+        {
+            s32 const n    = xmin(len, m_chunk_len);
+            node_t*   node = new_node();
+            x_memcpy(node->data(), data, n * m_rune_size);
+            node->m_len  = n;
+            node->m_size = n;
+            root         = merge(root, node);
+            data += n * m_rune_size;
+            len -= n;
+        }
+        return root;
+    }
+
+    rope_t::node_t* rope_t::find(s32 pos, s32& offset) const
+    {
+        offset       = 0;
+        node_t* node = m_root;
+        while (node != nullptr)
+        {
+            s32 const lsize = s_size(node->m_left);
+            if (pos < lsize)
+            {
+                node = node->m_left;
+            }
+            else if (pos < (lsize + node->m_len))
+            {
+                offset = pos - lsize;
+                return node;
+            }
+            else
+            {
+                pos -= lsize + node->m_len;
+                node = node->m_right;
+            }
+        }
+        return nullptr;
+    }
+
+    // Split into [0, pos) and [pos, size), a chunk that contains @pos is cut in two
+    void rope_t::split(node_t* node, s32 pos, node_t*& left, node_t*& right)
+    {
+        if (node == nullptr)
+        {
+            left  = nullptr;
+            right = nullptr;
+            return;
+        }
+
+        s32 const lsize = s_size(node->m_left);
+        if (pos <= lsize)
+        {
+            split(node->m_left, pos, left, node->m_left);
+            s_update(node);
+            right = node;
+        }
+        else if (pos >= (lsize + node->m_len))
+        {
+            split(node->m_right, pos - lsize - node->m_len, node->m_right, right);
+            s_update(node);
+            left = node;
+        }
+        else
+        {
+            // Move the tail of this chunk into a new node that takes over the right
+            // subtree, same priority so the heap order still holds.
+            s32 const offset = pos - lsize;
+            node_t*   tail   = new_node();
+            tail->m_priority = node->m_priority;
+            tail->m_len      = node->m_len - offset;
+            x_memcpy(tail->data(), node->data() + offset * m_rune_size, tail->m_len * m_rune_size);
+            tail->m_right = node->m_right;
+            s_update(tail);
+
+            node->m_len   = offset;
+            node->m_right = nullptr;
+            s_update(node);
+
+            left  = node;
+            right = tail;
+        }
+    }
+
+    rope_t::node_t* rope_t::merge(node_t* left, node_t* right)
+    {
+        if (left == nullptr)
+            return right;
+        if (right == nullptr)
+            return left;
+        if (left->m_priority >= right->m_priority)
+        {
+            left->m_right = merge(left->m_right, right);
+            s_update(left);
+            return left;
+        }
+        right->m_left = merge(left, right->m_left);
+        s_update(right);
+        return right;
+    }
+
+    // Insert into the chunk at @pos when it has room, the sizes are updated on the way back up
+    bool rope_t::insert_in_place(node_t* node, s32 pos, xbyte const* data, s32 len)
+    {
+        if (node == nullptr)
+            return false;
+
+        s32 const lsize = s_size(node->m_left);
+        bool      done;
+        if (pos < lsize)
+        {
+            done = insert_in_place(node->m_left, pos, data, len);
+        }
+        else if (pos <= (lsize + node->m_len))
+        {
+            done = (node->m_len + len) <= m_chunk_len;
+            if (done)
+            {
+                s32 const    offset = pos - lsize;
+                xbyte* const at     = node->data() + offset * m_rune_size;
+                xmem::memmove(at + len * m_rune_size, at, (node->m_len - offset) * m_rune_size);
+                x_memcpy(at, data, len * m_rune_size);
+                node->m_len += len;
+            }
+        }
+        else
+        {
+            done = insert_in_place(node->m_right, pos - lsize - node->m_len, data, len);
+        }
+
+        if (done)
+            node->m_size += len;
+        return done;
+    }
+
+    // The chunks that end and start at @pos are joined when one of them is less
+    // than half full, or when they do not fit in one chunk their text is evened out
+    void rope_t::coalesce(s32 pos)
+    {
+        if (pos <= 0 || pos >= size())
+            return;
+
+        s32     offset;
+        node_t* head = find(pos - 1, offset);
+        node_t* tail = find(pos, offset);
+        if (offset != 0 || (head->m_len >= (m_chunk_len / 2) && tail->m_len >= (m_chunk_len / 2)))
+            return;
+
+        // Both splits are on chunk boundaries, @middle is the tail chunk alone
+        node_t *left, *middle, *right;
+        split(m_root, pos, left, middle);
+        split(middle, tail->m_len, middle, right);
+        ASSERT(middle == tail && tail->m_left == nullptr && tail->m_right == nullptr);
+
+        // Units that move from the tail chunk to the head chunk, negative the other way
+        s32 const total = head->m_len + tail->m_len;
+        s32 const move  = total <= m_chunk_len ? tail->m_len : (total / 2) - head->m_len;
+        if (move > 0)
+        {
+            x_memcpy(head->data() + head->m_len * m_rune_size, tail->data(), move * m_rune_size);
+            xmem::memmove(tail->data(), tail->data() + move * m_rune_size, (tail->m_len - move) * m_rune_size);
+        }
+        else
+        {
+            xmem::memmove(tail->data() - move * m_rune_size, tail->data(), tail->m_len * m_rune_size);
+            x_memcpy(tail->data(), head->data() + (head->m_len + move) * m_rune_size, -move * m_rune_size);
+        }
+        head->m_len += move;
+        tail->m_len -= move;
+        s_update(tail);
+
+        // The head chunk is the last node of @left
+        for (node_t* node = left; node != nullptr; node = node->m_right)
+            node->m_size += move;
+
+        if (tail->m_len == 0)
+        {
+            m_allocator->deallocate(tail);
+            m_root = merge(left, right);
+        }
+        else
+        {
+            m_root = merge(merge(left, tail), right);
+        }
+    }
+
+    void rope_t::append(crunes_t const& str) { insert(size(), str); }
+
+    void rope_t::insert(s32 pos, crunes_t const& str)
+    {
+        ASSERT(str.m_type == m_type);
+        ASSERT(pos >= 0 && pos <= size());
+
+        xbyte const* data = (xbyte const*)str.m_runes.m_ascii.m_str;
+        s32 const    len  = (s32)((xbyte const*)str.m_runes.m_ascii.m_end - data) / m_rune_size;
+        if (len <= 0)
+            return;
+
+        if (len <= m_chunk_len && insert_in_place(m_root, pos, data, len))
+            return;
+
+        node_t *left, *right;
+        split(m_root, pos, left, right);
+        m_root = merge(merge(left, build(data, len)), right);
+        coalesce(pos + len);
+        coalesce(pos);
+    }
+
+    void rope_t::remove(s32 from, s32 to)
+    {
+        ASSERT(from >= 0 && from <= to && to <= size());
+        if (from == to)
+            return;
+
+        node_t *left, *middle, *right;
+        split(m_root, from, left, middle);
+        split(middle, to - from, middle, right);
+        free_tree(middle);
+        m_root = merge(left, right);
+        coalesce(from);
+    }
+
+    void rope_t::replace(s32 from, s32 to, crunes_t const& str)
+    {
+        remove(from, to);
+        insert(from, str);
+    }
+
+    void rope_t::concat(rope_t& other)
+    {
+        ASSERT(other.m_type == m_type);
+        if (&other == this)
+            return;
+
+        if (other.m_allocator == m_allocator)
+        {
+            m_root       = merge(m_root, other.m_root);
+            other.m_root = nullptr;
+        }
+        else
+        {
+            other.substring(0, other.size(), *this);
+            other.clear();
+        }
+    }
+
+    void rope_t::substring(s32 from, s32 to, rope_t& out) const
+    {
+        ASSERT(out.m_type == m_type && &out != this);
+        iter_t   iter(*this, from, to);
+        crunes_t span;
+        while (iter.next(span))
+            out.append(span);
+    }
+
+    u32 rope_t::at(s32 pos) const
+    {
+        ASSERT(pos >= 0 && pos < size());
+        s32           offset;
+        node_t const* node = find(pos, offset);
+        xbyte const*  p    = node->data() + offset * m_rune_size;
+        switch (m_rune_size)
+        {
+            case 2: return *(u16 const*)p;
+            case 4: return *(u32 const*)p;
+        }
+        return *p;
+    }
+
+    rope_t::iter_t::iter_t(rope_t const& rope) : m_rope(&rope), m_pos(0), m_end(rope.size()) {}
+    rope_t::iter_t::iter_t(rope_t const& rope, s32 from, s32 to) : m_rope(&rope), m_pos(from), m_end(xmin(to, rope.size())) {}
+
+    bool rope_t::iter_t::next(crunes_t& span)
+    {
+        if (m_pos >= m_end)
+            return false;
+
+        s32           offset;
+        node_t const* node = m_rope->find(m_pos, offset);
+        s32 const     len  = xmin(node->m_len - offset, m_end - m_pos);
+        span               = s_make_crunes(m_rope->m_type, node->data() + offset * m_rope->m_rune_size, len);
+        m_pos += len;
+        return true;
+    }
+
+}; // namespace xcore
@@ -1,6 +1,7 @@
 #include "xbase/x_target.h"
 #include "xbase/x_slice.h"
 #include "xbase/x_integer.h"
+#include "xbase/x_memory.h"
 
 namespace xcore
 {
@@ -14,6 +15,7 @@ namespace xcore
 		mRefCount = 0;
 		mItemCount = 0;
 		mItemSize = 1;
+		mPolicy = slice_t::REFCOUNT_PLAIN;
 		mData = NULL;
 	}
 
@@ -23,6 +25,7 @@ namespace xcore
 		mRefCount = 0;
 		mItemCount = item_count;
 		mItemSize = item_size;
+		mPolicy = slice_t::REFCOUNT_PLAIN;
 		mData = NULL;
 	}
 
@@ -32,19 +35,23 @@ namespace xcore
 		mRefCount = 0;
 		mItemCount = item_count;
 		mItemSize = item_size;
+		mPolicy = slice_t::REFCOUNT_PLAIN;
 		mData = data;
 	}
 
 	slice_data_t *slice_data_t::incref()
 	{
-		if (mAllocator != nullptr)
-			mRefCount++;
-		return (slice_data_t *)this;
+		return ((slice_data_t const *)this)->incref();
 	}
 	slice_data_t *slice_data_t::incref() const
 	{
 		if (mAllocator != nullptr)
-			mRefCount++;
+		{
+			if (mPolicy == slice_t::REFCOUNT_ATOMIC)
+				mRefCount.fetch_add(1, std::memory_order_relaxed);
+			else
+				mRefCount.store(mRefCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
 		return (slice_data_t *)this;
 	}
 
@@ -53,18 +60,34 @@ namespace xcore
 		if (mAllocator == nullptr)
 			return this;
 
-		s32 const refs = mRefCount;
+		s32 const refs = mRefCount.load(std::memory_order_acquire);
 		if (refs == 0)
 			return &sNull;
-		if (refs == 1)
+
+		// When we hold the only reference nobody else can incref, so there is
+		// no need for an atomic decrement, even with REFCOUNT_ATOMIC.
+		if (refs > 1)
 		{
-			mAllocator->deallocate(this->mData);
-			mAllocator->deallocate(this);
-			return &sNull;
+			if (mPolicy != slice_t::REFCOUNT_ATOMIC)
+			{
+				mRefCount.store(refs - 1, std::memory_order_relaxed);
+				return this;
+			}
+			if (mRefCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+				return this;
 		}
 
-		mRefCount--;
-		return this;
+		mAllocator->deallocate(this->mData);
+		mAllocator->deallocate(this);
+		return &sNull;
+	}
+
+	// With REFCOUNT_ATOMIC the acquire pairs with the release in decref(), the
+	// reads that another thread did before releasing happen before any edit
+	// made by make_unique() after it found the block not shared anymore
+	s32 slice_data_t::refcount() const
+	{
+		return mRefCount.load(mPolicy == slice_t::REFCOUNT_ATOMIC ? std::memory_order_acquire : std::memory_order_relaxed);
 	}
 
 	slice_data_t *slice_data_t::copy(s32 from, s32 to)
@@ -74,10 +97,15 @@ namespace xcore
 		{
 			data = (slice_data_t *)mAllocator->allocate(sizeof(slice_data_t), sizeof(void *));
 			data->mAllocator = mAllocator;
-			data->mRefCount = 1;
+			data->mRefCount.store(1, std::memory_order_relaxed);
 			data->mItemCount = to-from;
 			data->mItemSize = mItemSize;
+			data->mPolicy = mPolicy;
 			data->mData = (xbyte*)mAllocator->allocate(data->mItemSize * data->mItemCount, sizeof(void *));
+			if (data->mItemCount > 0)
+			{
+				xmem::memcpy(data->mData, mData + from * mItemSize, data->mItemCount * mItemSize);
+			}
 		}
 		return data;
 	}
@@ -86,13 +114,17 @@ namespace xcore
 	{
 		if (mAllocator != nullptr)
 		{
-			if (to > mItemCount)
+			// Keep the items [from, to), the items beyond the current end are not initialized
+			s32 const to_itemcount = to - from;
+			xbyte* data = (xbyte *)mAllocator->allocate((to_itemcount * mItemSize), sizeof(void *));
+			s32 const items2copy = xmin(to, mItemCount) - from;
+			if (items2copy > 0)
 			{
-				s32 const to_itemcount = to;
-				xbyte* data = (xbyte *)mAllocator->allocate((to_itemcount * mItemSize), sizeof(void *));
-				xmem::memcpy(data, mData, to_itemcount * mItemSize);
-				mItemCount = to_itemcount;
+				xmem::memcpy(data, mData + from * mItemSize, items2copy * mItemSize);
 			}
+			mAllocator->deallocate(this->mData);
+			this->mData = data;
+			mItemCount = to_itemcount;
 		}
 	}
 
@@ -143,13 +175,14 @@ namespace xcore
 		}
 	}
 
-	slice_data_t *slice_data_t::alloc(alloc_t *allocator, s32 &to_itemcount, s32 &to_itemsize)
+	slice_data_t *slice_data_t::alloc(alloc_t *allocator, s32 &to_itemcount, s32 &to_itemsize, s32 refcount_policy)
 	{
 		slice_data_t *data = (slice_data_t *)allocator->allocate(sizeof(slice_data_t), sizeof(void *));
 		data->mData = (xbyte *)allocator->allocate((to_itemcount * to_itemsize), sizeof(void *));
-		data->mRefCount = 1;
+		data->mRefCount.store(1, std::memory_order_relaxed);
 		data->mItemCount = to_itemcount;
 		data->mItemSize = to_itemsize;
+		data->mPolicy = refcount_policy;
 		data->mAllocator = allocator;
 		return data;
 	}
@@ -174,23 +207,23 @@ namespace xcore
 		mTo = to;
 	}
 
-	slice_t::slice_t(alloc_t *allocator, s32 item_count, s32 item_size)
+	slice_t::slice_t(alloc_t *allocator, s32 item_count, s32 item_size, s32 refcount_policy)
 	{
-		mData = slice_data_t::alloc(allocator, item_count, item_size);
+		mData = slice_data_t::alloc(allocator, item_count, item_size, refcount_policy);
 		mFrom = 0;
 		mTo = item_count;
 	}
 
-	void slice_t::alloc(slice_t &slice_t, alloc_t *allocator, s32 item_count, s32 item_size)
+	void slice_t::alloc(slice_t &slice_t, alloc_t *allocator, s32 item_count, s32 item_size, s32 refcount_policy)
 	{
-		slice_t.mData = slice_data_t::alloc(allocator, item_count, item_size);
+		slice_t.mData = slice_data_t::alloc(allocator, item_count, item_size, refcount_policy);
 		slice_t.mFrom = 0;
 		slice_t.mTo = item_count;
 	}
 
 	slice_t slice_t::construct(s32 _item_count, s32 _item_size) const
 	{
-		return slice_t(mData->mAllocator, _item_count, _item_size);
+		return slice_t(mData->mAllocator, _item_count, _item_size, mData->mPolicy);
 	}
 
 	s32 slice_t::size() const
@@ -200,7 +233,7 @@ namespace xcore
 
 	s32 slice_t::refcnt() const
 	{
-		return mData->mRefCount;
+		return mData->refcount();
 	}
 
 	slice_t slice_t::obtain() const
@@ -216,8 +249,26 @@ namespace xcore
 		mTo = 0;
 	}
 
+	bool slice_t::is_shared() const
+	{
+		return mData->mAllocator != nullptr && mData->refcount() > 1;
+	}
+
+	void slice_t::make_unique()
+	{
+		if (is_shared())
+		{
+			slice_data_t *data = mData->copy(mFrom, mTo);
+			mData->decref();
+			mData = data;
+			mTo = mTo - mFrom;
+			mFrom = 0;
+		}
+	}
+
 	void slice_t::resize(s32 count)
 	{
+		make_unique();
 		mData->resize(mFrom, mFrom + count);
 		mFrom = 0;
 		mTo = count;
@@ -225,12 +276,14 @@ namespace xcore
 
 	void slice_t::insert(s32 count)
 	{
+		make_unique();
 		mData->insert(mFrom, count);
 		mTo += count;
 	}
 
 	void slice_t::remove(s32 count)
 	{
+		make_unique();
 		mData->remove(mFrom, count);
 		mTo -= count;
 	}
@@ -268,22 +321,22 @@ namespace xcore
 
 	void *slice_t::begin()
 	{
-		return at(mFrom);
+		return at(0);
 	}
 
 	void const *slice_t::begin() const
 	{
-		return at(mFrom);
+		return at(0);
 	}
 
 	void *slice_t::end()
 	{
-		return at(mTo);
+		return at(size());
 	}
 
 	void const *slice_t::end() const
 	{
-		return at(mTo);
+		return at(size());
 	}
 
 	void const *slice_t::eos() const
@@ -1,217 +1,44 @@
 namespace xcore
 {
-	// TODO: Optimize this using intrinsics
+	// The bit scan functions map to tzcnt/lzcnt (bsf/bsr) through the clang builtins,
+	// the builtins are undefined for 'v==0' so that case is handled explicitly.
 
 	// find the number of trailing zeros in 16-bit value
 	// if 'v==0' this function returns 0
 	inline s32 xcountTrailingZeros(u16 integer)
 	{
-		if (integer == 0)
-			return 0;
-
-		s32 count = 0;
-		if ((integer & 0x000000FF) == 0)
-		{
-			count += 8;
-			integer = integer >> 8;
-		}
-		if ((integer & 0x0000000F) == 0)
-		{
-			count += 4;
-			integer = integer >> 4;
-		}
-		if ((integer & 0x00000003) == 0)
-		{
-			count += 2;
-			integer = integer >> 2;
-		}
-		if ((integer & 0x00000001) == 0)
-		{
-			count += 1;
-		}
-
-		return count;
+		return integer == 0 ? 0 : __builtin_ctz((u32)integer);
 	}
-	 // find the number of trailing zeros in 32-bit value
-	 // if 'v==0' this function returns 0
+	// find the number of trailing zeros in 32-bit value
+	// if 'v==0' this function returns 0
 	inline s32 xcountTrailingZeros(u32 integer)
 	{
-        if (integer == 0)
-            return 0;
-
-		s32 count = 0;
-		if ((integer & 0x0000FFFF) == 0)
-		{
-			count += 16;
-			integer = integer >> 16;
-		}
-		if ((integer & 0x000000FF) == 0)
-		{
-			count += 8;
-			integer = integer >> 8;
-		}
-		if ((integer & 0x0000000F) == 0)
-		{
-			count += 4;
-			integer = integer >> 4;
-		}
-		if ((integer & 0x00000003) == 0)
-		{
-			count += 2;
-			integer = integer >> 2;
-		}
-		if ((integer & 0x00000001) == 0)
-		{
-			count += 1;
-		}
-
-		return count;
+		return integer == 0 ? 0 : __builtin_ctz(integer);
 	}
 	// find the number of trailing zeros in 64-bit value
 	// if 'v==0' this function returns 0
 	inline s32 xcountTrailingZeros(u64 integer)
 	{
-        if (integer == 0)
-            return 0;
-
-		s32 count = 0;
-		if ((integer & 0xFFFFFFFF) == 0)
-		{
-			count += 32;
-			integer = integer >> 32;
-		}
-		if ((integer & 0x0000FFFF) == 0)
-		{
-			count += 16;
-			integer = integer >> 16;
-		}
-		if ((integer & 0x000000FF) == 0)
-		{
-			count += 8;
-			integer = integer >> 8;
-		}
-		if ((integer & 0x0000000F) == 0)
-		{
-			count += 4;
-			integer = integer >> 4;
-		}
-		if ((integer & 0x00000003) == 0)
-		{
-			count += 2;
-			integer = integer >> 2;
-		}
-		if ((integer & 0x00000001) == 0)
-		{
-			count += 1;
-		}
-
-		return count;
+		return integer == 0 ? 0 : __builtin_ctzll(integer);
 	}
 
 	// find the number of leading zeros in 16-bit v
 	// if 'v==0' this function returns 16
 	inline s32 xcountLeadingZeros(u16 integer)
 	{
-		if (integer == 0)
-			return 16;
-
-		s32 count = 0;
-		if ((integer & 0xFF00) == 0)
-		{
-			count += 8;
-			integer = integer << 8;
-		}
-		if ((integer & 0xF000) == 0)
-		{
-			count += 4;
-			integer = integer << 4;
-		}
-		if ((integer & 0xC000) == 0)
-		{
-			count += 2;
-			integer = integer << 2;
-		}
-		if ((integer & 0x4000) == 0)
-		{
-			count += 1;
-		}
-
-		return count;
+		return integer == 0 ? 16 : (__builtin_clz((u32)integer) - 16);
 	}
 	// find the number of leading zeros in 32-bit v
 	// if 'v==0' this function returns 32
 	inline s32 xcountLeadingZeros(u32 integer)
 	{
-		if (integer == 0)
-			return 32;
-
-		s32 count = 0;
-		if ((integer & 0xFFFF0000) == 0)
-		{
-			count += 16;
-			integer = integer << 16;
-		}
-		if ((integer & 0xFF000000) == 0)
-		{
-			count += 8;
-			integer = integer << 8;
-		}
-		if ((integer & 0xF0000000) == 0)
-		{
-			count += 4;
-			integer = integer << 4;
-		}
-		if ((integer & 0xC0000000) == 0)
-		{
-			count += 2;
-			integer = integer << 2;
-		}
-		if ((integer & 0x40000000) == 0)
-		{
-			count += 1;
-		}
-
-		return count;
+		return integer == 0 ? 32 : __builtin_clz(integer);
 	}
 	// find the number of leading zeros in 64-bit v
 	// if 'v==0' this function returns 64
 	inline s32 xcountLeadingZeros(u64 integer)
 	{
-		if (integer == 0)
-			return 64;
-
-		s32 count = 0;
-		if ((integer & 0xFFFFFFFF00000000UL) == 0)
-		{
-			count += 32;
-			integer = integer << 32;
-		}
-		if ((integer & 0xFFFF000000000000UL) == 0)
-		{
-			count += 16;
-			integer = integer << 16;
-		}
-		if ((integer & 0xFF00000000000000UL) == 0)
-		{
-			count += 8;
-			integer = integer << 8;
-		}
-		if ((integer & 0xF000000000000000UL) == 0)
-		{
-			count += 4;
-			integer = integer << 4;
-		}
-		if ((integer & 0xC000000000000000UL) == 0)
-		{
-			count += 2;
-			integer = integer << 2;
-		}
-		if ((integer & 0x4000000000000000UL) == 0)
-		{
-			count += 1;
-		}
-
-		return count;
+		return integer == 0 ? 64 : __builtin_clzll(integer);
 	}
 
 
@@ -0,0 +1,101 @@
+#ifndef __XBASE_ART_H__
+#define __XBASE_ART_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "xbase/x_buffer.h"
+
+namespace xcore
+{
+    class alloc_t;
+
+    //==============================================================================
+    // Adaptive radix tree
+    //
+    // An ordered map from byte strings to values. Every inner node consumes one
+    // byte of the key and comes in four sizes (4, 16, 48 and 256 children) that
+    // adapt to the number of children, paths with a single child are collapsed
+    // into a prefix that is stored in the node. The depth of a lookup is bounded
+    // by the length of the key and not by the number of keys.
+    //
+    // Keys are compared as unsigned bytes, so a crunes_t key (ascii or utf8) is
+    // ordered the same as by memcmp. A key may be a prefix of another key.
+    //
+    // Unlike map_t the keys are ordered, iter_t visits them in ascending order
+    // and can be limited to the keys that start with a prefix.
+    //
+    // Example:
+    //     art_t tree(allocator);
+    //     tree.insert(crunes_t("net.rx"), rx);
+    //     tree.insert(crunes_t("net.tx"), tx);
+    //     art_t::iter_t iter(tree, crunes_t("net."));
+    //     cbuffer_t key; void* value;
+    //     while (iter.next(key, value)) { ... }
+    //==============================================================================
+    class art_t
+    {
+    public:
+        art_t(alloc_t* a = nullptr);
+        ~art_t();
+
+        enum
+        {
+            MAX_PREFIX = 8, // bytes of a collapsed prefix stored in a node
+        };
+
+        inline u32  size() const { return m_size; }
+        inline bool is_empty() const { return m_size == 0; }
+
+        void clear();
+
+        // Returns true when @key was added, false when the value of @key was replaced
+        bool insert(cbuffer_t const& key, void* value);
+        bool remove(cbuffer_t const& key);
+        bool remove(cbuffer_t const& key, void*& value);
+        bool find(cbuffer_t const& key, void*& value) const;
+        bool contains(cbuffer_t const& key) const;
+
+        struct node_t;
+        struct leaf_t;
+
+        // Iterate in ascending key order over all keys, or over the keys that
+        // start with @prefix. The key returned points into the tree, the tree
+        // should not be modified during the iteration.
+        class iter_t
+        {
+        public:
+            iter_t(art_t const& tree);
+            iter_t(art_t const& tree, cbuffer_t const& prefix);
+            ~iter_t();
+
+            bool next(cbuffer_t& key, void*& value);
+
+            struct frame_t;
+
+        private:
+            void push(node_t* node);
+
+            art_t const* m_tree;
+            frame_t*     m_stack;
+            s32          m_depth;
+            s32          m_capacity;
+        };
+
+    private:
+        bool insert(node_t** ref, u32 depth, cbuffer_t const& key, void* value);
+        bool remove(node_t** ref, u32 depth, cbuffer_t const& key, void*& value);
+        void free_node(node_t* node);
+
+        art_t(art_t const&);
+        art_t& operator=(art_t const&);
+
+        alloc_t* m_allocator;
+        node_t*  m_root;
+        u32      m_size;
+    };
+
+}; // namespace xcore
+
+#endif // __XBASE_ART_H__
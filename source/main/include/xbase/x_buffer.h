@@ -162,10 +162,10 @@ namespace xcore
     class binary_reader_t
     {
     public:
-        inline binary_reader_t() : m_len(0), m_cursor(0), m_buffer(nullptr) {}
-        inline binary_reader_t(buffer_t const& b) : m_len(b.size()), m_cursor(0), m_buffer(b.m_mutable) {}
-        inline binary_reader_t(cbuffer_t const& b) : m_len(b.size()), m_cursor(0), m_buffer(b.m_const) {}
-        inline binary_reader_t(xbyte const* _buffer, u32 _len) : m_len(_len), m_cursor(0), m_buffer(_buffer) {}
+        inline binary_reader_t() : m_len(0), m_cursor(0), m_frame(0), m_buffer(nullptr) {}
+        inline binary_reader_t(buffer_t const& b) : m_len(b.size()), m_cursor(0), m_frame(0), m_buffer(b.m_mutable) {}
+        inline binary_reader_t(cbuffer_t const& b) : m_len(b.size()), m_cursor(0), m_frame(0), m_buffer(b.m_const) {}
+        inline binary_reader_t(xbyte const* _buffer, u32 _len) : m_len(_len), m_cursor(0), m_frame(0), m_buffer(_buffer) {}
 
         u32       size() const;
         u32       length() const;
@@ -206,19 +206,26 @@ namespace xcore
         s32       view_buffer(cbuffer_t& buf);
         s32       view_crunes(crunes_t& out_str);
 
+        // Checksummed frames, see binary_writer_t::begin_frame. end_frame reads
+        // the checksum and returns false when it does not match the bytes read
+        // since begin_frame (or when there is no checksum to read).
+        void begin_frame();
+        bool end_frame();
+
     protected:
         u32          m_len;
         u32          m_cursor;
+        u32          m_frame;
         xbyte const* m_buffer;
     };
 
     class binary_writer_t
     {
     public:
-        inline binary_writer_t() : m_len(0), m_cursor(0), m_buffer() {}
-        inline binary_writer_t(buffer_t const& _buffer) : m_len(_buffer.size()), m_cursor(0), m_buffer(_buffer.m_mutable) {}
-        inline binary_writer_t(xbyte* _buffer, u32 _len) : m_len(_len), m_cursor(0), m_buffer(_buffer) {}
-        inline binary_writer_t(binary_writer_t const& other) : m_len(other.m_len), m_cursor(other.m_cursor), m_buffer(other.m_buffer) {}
+        inline binary_writer_t() : m_len(0), m_cursor(0), m_frame(0), m_buffer() {}
+        inline binary_writer_t(buffer_t const& _buffer) : m_len(_buffer.size()), m_cursor(0), m_frame(0), m_buffer(_buffer.m_mutable) {}
+        inline binary_writer_t(xbyte* _buffer, u32 _len) : m_len(_len), m_cursor(0), m_frame(0), m_buffer(_buffer) {}
+        inline binary_writer_t(binary_writer_t const& other) : m_len(other.m_len), m_cursor(other.m_cursor), m_frame(other.m_frame), m_buffer(other.m_buffer) {}
 
         u32 size() const;
         u32 length() const;
@@ -255,10 +262,19 @@ namespace xcore
         s32 write_buffer(cbuffer_t const& cbuf); // Will write [s32=Length][u8[]=Data]
         s32 write_string(crunes_t const& str);
 
+        // Checksummed frames, written as [data][u32=crc32c of data]. The
+        // checksum is computed once over the whole frame by end_frame, while
+        // the data is still in the cache, instead of on every write.
+        // end_frame returns the offset of the checksum or -1 when it does
+        // not fit.
+        void begin_frame();
+        s32  end_frame();
+
         binary_writer_t& operator=(const binary_writer_t& other)
         {
             m_len    = other.m_len;
             m_cursor = other.m_cursor;
+            m_frame  = other.m_frame;
             m_buffer = other.m_buffer;
             return *this;
         }
@@ -266,6 +282,7 @@ namespace xcore
     protected:
         u32    m_len;
         u32    m_cursor;
+        u32    m_frame;
         xbyte* m_buffer;
     };
 
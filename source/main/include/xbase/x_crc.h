@@ -0,0 +1,26 @@
+#ifndef __XBASE_CRC_H__
+#define __XBASE_CRC_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "xbase/x_buffer.h"
+
+namespace xcore
+{
+    //==============================================================================
+    // CRC-32C (Castagnoli), the checksum of iSCSI, ext4 and SSE4.2
+    //
+    // On x86-64 CPUs with SSE4.2 the crc32 instruction is used (selected at
+    // runtime), large inputs are processed as 3 interleaved streams to hide
+    // the latency of the instruction. Otherwise a slicing-by-8 table is used.
+    //
+    // Checksums can be continued, crc32c(b, crc32c(a)) equals crc32c(a + b).
+    //==============================================================================
+    u32        crc32c(xbyte const* data, u32 size, u32 crc = 0);
+    inline u32 crc32c(cbuffer_t const& data, u32 crc = 0) { return crc32c(data.m_const, data.m_len, crc); }
+
+}; // namespace xcore
+
+#endif // __XBASE_CRC_H__
@@ -7,6 +7,10 @@
 
 namespace xcore
 {
+    class alloc_t;
+    class cbuffer_t;
+    class jobs_t;
+
     // Using SipHash
     class hashing_t
     {
@@ -34,54 +38,156 @@ namespace xcore
         void reset(xbyte const* seed);
     };
 
+    struct hash128_t
+    {
+        u64 m_low;
+        u64 m_high;
+    };
+
+    // xxHash, compatible with the reference implementation (XXH64, XXH3_64bits
+    // and XXH3_128bits with a seed). Inputs longer than 240 bytes are hashed
+    // with an SSE2 or AVX2 kernel, selected at runtime.
+    u64       xxhash64(xbyte const* data, u32 size, u64 seed = 0);
+    u64       xxhash3_64(xbyte const* data, u32 size, u64 seed = 0);
+    hash128_t xxhash3_128(xbyte const* data, u32 size, u64 seed = 0);
+
+    // The default hash used by the containers for byte strings (xxhash3_64 with seed 0)
     u64 calchash(xbyte const* data, u32 size);
 
+    // Tree hash for large buffers. The input is split into chunks of HASH_CHUNK_SIZE
+    // bytes that are hashed as tasks on @jobs (on the calling thread when null),
+    // the result is the hash of the chunk hashes and the length. The result does
+    // not depend on the number of threads, and is calchash() for inputs of up
+    // to one chunk.
+    enum
+    {
+        HASH_CHUNK_SIZE = 1024 * 1024
+    };
+    u64 calchash_parallel(cbuffer_t const& data, jobs_t* jobs, alloc_t* allocator = nullptr);
+
+    // Integer mixer for fixed-width keys (Pelle Evensen's moremur). It is a
+    // bijection, distinct keys never collide, and every input bit affects
+    // every output bit, also the low bits the btree of map_t/set_t indexes on.
+    // The murmur3 finalizer has the same cost but fails bit independence, a
+    // flip of input bit i flips output bits j and j + 33 together.
+    constexpr u64 mixhash_shift(u64 v, s32 shift) { return v ^ (v >> shift); }
+    constexpr u64 mixhash(u64 k) { return mixhash_shift(mixhash_shift(mixhash_shift(k, 27) * 0x3C79AC492BA7B653ULL, 33) * 0x1C69B3F74AC4AE35ULL, 27); }
+
+    // Batched hashing, hashes[i] is mixhash(keys[i]) (as hasher_t<u32/u64>) or
+    // calchash(keys + i * key_size, key_size) for fixed-size byte keys. With
+    // AVX2 (selected at runtime) 4 keys are hashed per vector.
+    void calchash_batch(u32 const* keys, u64* hashes, u32 count);
+    void calchash_batch(u64 const* keys, u64* hashes, u32 count);
+    void calchash_batch(xbyte const* keys, u32 key_size, u64* hashes, u32 count);
+
+    // A hasher can have a batch hook, 'void hash_batch(K const* keys, u64* hashes,
+    // u32 count) const', that containers call through hash_batch() for bulk
+    // operations. Hashers without one are called for every key.
+    namespace nhash
+    {
+        template <typename H, typename K> inline auto batch(H const& hasher, K const* keys, u64* hashes, u32 count, s32) -> decltype(hasher.hash_batch(keys, hashes, count), void()) { hasher.hash_batch(keys, hashes, count); }
+        template <typename H, typename K> inline void batch(H const& hasher, K const* keys, u64* hashes, u32 count, long)
+        {
+            for (u32 i = 0; i < count; ++i)
+                hashes[i] = hasher.hash(keys[i]);
+        }
+    } // namespace nhash
+
+    template <typename H, typename K> inline void hash_batch(H const& hasher, K const* keys, u64* hashes, u32 count) { nhash::batch(hasher, keys, hashes, count, 0); }
+
     template <typename K> class hasher_t
     {
     public:
         u64 hash(K const& k) const { return 0; }
     };
 
+    template <> class hasher_t<s8>
+    {
+    public:
+        u64 hash(s8 const& k) const { return mixhash((u8)k); }
+    };
+
+    template <> class hasher_t<u8>
+    {
+    public:
+        u64 hash(u8 const& k) const { return mixhash(k); }
+    };
+
+    template <> class hasher_t<s16>
+    {
+    public:
+        u64 hash(s16 const& k) const { return mixhash((u16)k); }
+    };
+
+    template <> class hasher_t<u16>
+    {
+    public:
+        u64 hash(u16 const& k) const { return mixhash(k); }
+    };
+
     template <> class hasher_t<s32>
     {
     public:
-        u64 hash(s32 const& k) const { return calchash((const xbyte*)&k, sizeof(k)); }
+        u64 hash(s32 const& k) const { return mixhash((u32)k); }
+        void hash_batch(s32 const* k, u64* hashes, u32 count) const { calchash_batch((u32 const*)k, hashes, count); }
     };
 
     template <> class hasher_t<u32>
     {
     public:
-        u64 hash(u32 const& k) const { return calchash((const xbyte*)&k, sizeof(k)); }
+        u64 hash(u32 const& k) const { return mixhash(k); }
+        void hash_batch(u32 const* k, u64* hashes, u32 count) const { calchash_batch(k, hashes, count); }
     };
 
     template <> class hasher_t<s64>
     {
     public:
-        u64 hash(s64 const& k) const { return calchash((const xbyte*)&k, sizeof(k)); }
+        u64 hash(s64 const& k) const { return mixhash((u64)k); }
+        void hash_batch(s64 const* k, u64* hashes, u32 count) const { calchash_batch((u64 const*)k, hashes, count); }
     };
 
     template <> class hasher_t<u64>
     {
     public:
-        u64 hash(u64 const& k) const { return calchash((const xbyte*)&k, sizeof(k)); }
+        u64 hash(u64 const& k) const { return mixhash(k); }
+        void hash_batch(u64 const* k, u64* hashes, u32 count) const { calchash_batch(k, hashes, count); }
     };
 
+    // Floats hash their bit pattern, -0.0 hashes as 0.0 since the two compare equal
     template <> class hasher_t<f32>
     {
     public:
-        u64 hash(f32 const& k) const { return calchash((const xbyte*)&k, sizeof(k)); }
+        u64 hash(f32 const& k) const
+        {
+            union
+            {
+                f32 f;
+                u32 u;
+            } bits;
+            bits.f = (k == 0.0f) ? 0.0f : k;
+            return mixhash(bits.u);
+        }
     };
 
     template <> class hasher_t<f64>
     {
     public:
-        u64 hash(f64 const& k) const { return calchash((const xbyte*)&k, sizeof(k)); }
+        u64 hash(f64 const& k) const
+        {
+            union
+            {
+                f64 f;
+                u64 u;
+            } bits;
+            bits.f = (k == 0.0) ? 0.0 : k;
+            return mixhash(bits.u);
+        }
     };
 
     template <> class hasher_t<void*>
     {
     public:
-        u64 hash(void* const k) const { return calchash((const xbyte*)&k, sizeof(k)); }
+        u64 hash(void* const k) const { return mixhash((u64)(uptr)k); }
     };
 
     template <> class hasher_t<const char*>
@@ -0,0 +1,271 @@
+#ifndef __XBASE_HEAP_H__
+#define __XBASE_HEAP_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "xbase/x_debug.h"
+#include "xbase/x_allocator.h"
+#include "xbase/x_handle.h"
+
+namespace xcore
+{
+    template <typename T> struct heap_less_t
+    {
+        inline bool operator()(T const& a, T const& b) const { return a < b; }
+    };
+
+    //==============================================================================
+    // Indexed d-ary min-heap (priority queue).
+    //
+    // With D = 4 or 8 the children of a node are next to each other in memory, the
+    // tree is half/third the depth of a binary heap and sift-down touches far less
+    // cache-lines. The comparator L is a functor that is inlined by the compiler,
+    // the top of the heap is the item for which L(item, other) is true.
+    //
+    // Every item gets a handle_t on push, that handle can be used to change the
+    // priority (decrease/increase key) or to remove the item in O(log n). The heap
+    // array and the handle -> position table are allocated from an alloc_t and
+    // grow when the heap is full.
+    //==============================================================================
+    template <typename T, typename L = heap_less_t<T>, s32 D = 4> class heap_t
+    {
+    public:
+        inline heap_t(alloc_t* a = nullptr) : m_allocator(a), m_heap(nullptr), m_position(nullptr), m_size(0), m_capacity(0), m_freelist(FREE_END)
+        {
+            if (m_allocator == nullptr)
+            {
+                m_allocator = alloc_t::get_system();
+            }
+        }
+
+        inline ~heap_t() { release(); }
+
+        inline u32  size() const { return m_size; }
+        inline u32  capacity() const { return m_capacity; }
+        inline bool is_empty() const { return m_size == 0; }
+
+        void reserve(u32 capacity)
+        {
+            if (capacity <= m_capacity)
+                return;
+
+            entry_t* heap     = (entry_t*)m_allocator->allocate(capacity * sizeof(entry_t), X_CACHE_LINE_SIZE);
+            u32*     position = (u32*)m_allocator->allocate(capacity * sizeof(u32), sizeof(u32));
+            for (u32 i = 0; i < m_size; ++i)
+                heap[i] = m_heap[i];
+            for (u32 i = 0; i < m_capacity; ++i)
+                position[i] = m_position[i];
+
+            // New handles are added to the front of the free list
+            for (u32 i = capacity; i > m_capacity; --i)
+            {
+                position[i - 1] = m_freelist;
+                m_freelist      = FREE_BIT | (i - 1);
+            }
+
+            if (m_heap != nullptr)
+            {
+                m_allocator->deallocate(m_heap);
+                m_allocator->deallocate(m_position);
+            }
+            m_heap     = heap;
+            m_position = position;
+            m_capacity = capacity;
+        }
+
+        void release()
+        {
+            if (m_heap != nullptr)
+            {
+                m_allocator->deallocate(m_heap);
+                m_allocator->deallocate(m_position);
+                m_heap     = nullptr;
+                m_position = nullptr;
+            }
+            m_size     = 0;
+            m_capacity = 0;
+            m_freelist = FREE_END;
+        }
+
+        void clear()
+        {
+            u32 const capacity = m_capacity;
+            m_freelist         = FREE_END;
+            for (u32 i = capacity; i > 0; --i)
+            {
+                m_position[i - 1] = m_freelist;
+                m_freelist        = FREE_BIT | (i - 1);
+            }
+            m_size = 0;
+        }
+
+        handle_t push(T const& item)
+        {
+            if (m_size == m_capacity)
+                reserve(m_capacity < 16 ? 16 : m_capacity * 2);
+
+            u32 const h = m_freelist & ~FREE_BIT;
+            m_freelist  = m_position[h];
+
+            u32 const pos        = m_size++;
+            m_heap[pos].m_item   = item;
+            m_heap[pos].m_handle = h;
+            sift_up(pos);
+            return handle_t(h);
+        }
+
+        inline T const& top() const
+        {
+            ASSERT(m_size > 0);
+            return m_heap[0].m_item;
+        }
+
+        inline handle_t top_handle() const
+        {
+            ASSERT(m_size > 0);
+            return handle_t(m_heap[0].m_handle);
+        }
+
+        bool pop(T& item)
+        {
+            if (m_size == 0)
+                return false;
+            item = m_heap[0].m_item;
+            remove_at(0);
+            return true;
+        }
+
+        inline bool contains(handle_t h) const { return h.get() < m_capacity && (m_position[h.get()] & FREE_BIT) == 0; }
+
+        inline T const& get(handle_t h) const
+        {
+            ASSERT(contains(h));
+            return m_heap[m_position[h.get()]].m_item;
+        }
+
+        // Change the priority of the item, this handles both decrease- and increase-key
+        void update(handle_t h, T const& item)
+        {
+            ASSERT(contains(h));
+            u32 const pos = m_position[h.get()];
+            if (m_less(item, m_heap[pos].m_item))
+            {
+                m_heap[pos].m_item = item;
+                sift_up(pos);
+            }
+            else
+            {
+                m_heap[pos].m_item = item;
+                sift_down(pos);
+            }
+        }
+
+        // Decrease-key, the new item should not be 'greater' than the current one
+        void decrease(handle_t h, T const& item)
+        {
+            ASSERT(contains(h));
+            u32 const pos = m_position[h.get()];
+            ASSERT(!m_less(m_heap[pos].m_item, item));
+            m_heap[pos].m_item = item;
+            sift_up(pos);
+        }
+
+        bool remove(handle_t h, T& item)
+        {
+            if (!contains(h))
+                return false;
+            u32 const pos = m_position[h.get()];
+            item          = m_heap[pos].m_item;
+            remove_at(pos);
+            return true;
+        }
+
+    private:
+        enum
+        {
+            FREE_BIT = 0x80000000,
+            FREE_END = 0xffffffff,
+        };
+
+        struct entry_t
+        {
+            T   m_item;
+            u32 m_handle;
+        };
+
+        void remove_at(u32 pos)
+        {
+            u32 const h   = m_heap[pos].m_handle;
+            m_position[h] = m_freelist;
+            m_freelist    = FREE_BIT | h;
+
+            m_size -= 1;
+            if (pos < m_size)
+            {
+                m_heap[pos]                      = m_heap[m_size];
+                m_position[m_heap[pos].m_handle] = pos;
+                if (pos > 0 && m_less(m_heap[pos].m_item, m_heap[(pos - 1) / D].m_item))
+                    sift_up(pos);
+                else
+                    sift_down(pos);
+            }
+        }
+
+        void sift_up(u32 pos)
+        {
+            entry_t const e = m_heap[pos];
+            while (pos > 0)
+            {
+                u32 const parent = (pos - 1) / D;
+                if (!m_less(e.m_item, m_heap[parent].m_item))
+                    break;
+                m_heap[pos]                      = m_heap[parent];
+                m_position[m_heap[pos].m_handle] = pos;
+                pos                              = parent;
+            }
+            m_heap[pos]            = e;
+            m_position[e.m_handle] = pos;
+        }
+
+        void sift_down(u32 pos)
+        {
+            entry_t const e = m_heap[pos];
+            for (;;)
+            {
+                u32 const first = pos * D + 1;
+                if (first >= m_size)
+                    break;
+                u32 const last = (first + D) < m_size ? (first + D) : m_size;
+                u32       best = first;
+                for (u32 c = first + 1; c < last; ++c)
+                {
+                    if (m_less(m_heap[c].m_item, m_heap[best].m_item))
+                        best = c;
+                }
+                if (!m_less(m_heap[best].m_item, e.m_item))
+                    break;
+                m_heap[pos]                      = m_heap[best];
+                m_position[m_heap[pos].m_handle] = pos;
+                pos                              = best;
+            }
+            m_heap[pos]            = e;
+            m_position[e.m_handle] = pos;
+        }
+
+        heap_t(heap_t const&);
+        heap_t& operator=(heap_t const&);
+
+        alloc_t* m_allocator;
+        entry_t* m_heap;
+        u32*     m_position; // handle -> heap position, or the free-list link when the handle is not in use
+        u32      m_size;
+        u32      m_capacity;
+        u32      m_freelist;
+        L        m_less;
+    };
+
+}; // namespace xcore
+
+#endif // __XBASE_HEAP_H__
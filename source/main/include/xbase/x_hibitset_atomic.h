@@ -0,0 +1,59 @@
+#ifndef __X_HIERARCHICAL_BITSET_ATOMIC_H__
+#define __X_HIERARCHICAL_BITSET_ATOMIC_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include <atomic>
+
+namespace xcore
+{
+    class alloc_t;
+
+    // A thread-safe hierarchical bitset meant to be used as a lock-free
+    // index/slot allocator that can be shared by many threads.
+    //
+    // Level 0 holds the bits, a '1' means the index is in use. A bit on a
+    // level above is a hint that tells that the 64-bit word below is full,
+    // so find_and_set() can walk down to a word with a free bit without
+    // scanning. All updates are atomic fetch-or/fetch-and operations, the
+    // summary bits are propagated up (and repaired when a hint turns out
+    // to be stale) without taking a lock.
+    //
+    // Padding bits at the end of every level are set to '1' so that they
+    // are never handed out.
+    class hibitset_atomic_t
+    {
+    public:
+        inline hibitset_atomic_t() : m_numbits(0), m_maxlevel(0) {}
+
+        void init(alloc_t* alloc, u32 maxbits);
+        void release(alloc_t* alloc);
+
+        // Not thread-safe, clears all bits
+        void reset();
+
+        bool set(u32 bit); // Returns true when this call changed the bit from 0 to 1
+        bool clr(u32 bit); // Returns true when this call changed the bit from 1 to 0
+
+        bool is_set(u32 bit) const;
+        bool is_full() const;
+
+        // Atomically claim a free bit, returns false when all bits are in use.
+        // A bit that is freed by a clr() that has not returned yet may be missed.
+        bool find_and_set(u32& bit);
+
+        static u32 size_in_qwords(u32 maxbits);
+
+    private:
+        void mark_full(s32 level, u32 word);
+        void mark_not_full(s32 level, u32 word);
+
+        std::atomic<u64>* m_levels[6];
+        u32               m_numbits;
+        s32               m_maxlevel;
+    };
+}; // namespace xcore
+
+#endif /// __X_HIERARCHICAL_BITSET_ATOMIC_H__
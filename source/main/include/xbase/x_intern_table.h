@@ -0,0 +1,97 @@
+#ifndef __XBASE_INTERN_TABLE_H__
+#define __XBASE_INTERN_TABLE_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include <atomic>
+
+#include "xbase/x_handle.h"
+#include "xbase/x_runes.h"
+
+namespace xcore
+{
+    class alloc_t;
+
+    //==============================================================================
+    // String interning table
+    //
+    // Every unique string is copied once into an arena and identified by a
+    // 32-bit handle, two interned strings are equal when their handles are
+    // equal. The hash of a string is computed once, when it is interned, so
+    // names and keys that are compared and hashed many times only pay for it
+    // once.
+    //
+    // Strings of a different rune type are different strings, even when they
+    // hold the same text. An interned string is followed by a terminating zero
+    // so an ascii or utf8 view can also be used as a C string.
+    //
+    // Thread safety:
+    //   - find(), view(), hash() and size() do not lock and can be called from
+    //     any thread, also while another thread is interning.
+    //   - intern() serializes the insertion of new strings with a spin lock,
+    //     strings that are already in the table are found without locking.
+    //   - The returned views stay valid until release().
+    //
+    // Example:
+    //     intern_table_t names(allocator);
+    //     handle_t a = names.intern(crunes_t("channel.main"));
+    //     handle_t b = names.intern(crunes_t("channel.main"));
+    //     ASSERT(a == b);
+    //==============================================================================
+    class intern_table_t
+    {
+    public:
+        intern_table_t(alloc_t* a = nullptr);
+        ~intern_table_t();
+
+        enum
+        {
+            PAGE_ENTRIES = 4096, // entries per page, pages never move
+            MAX_PAGES    = 4096, // so at most 16M unique strings
+            ARENA_BYTES  = 65536,
+        };
+
+        void release();
+
+        // Returns the handle of @str, adds it to the table when it is not there
+        handle_t intern(crunes_t const& str);
+
+        // Intern @count strings, the lock is taken at most once for the batch
+        void intern(crunes_t const* strs, u32 count, handle_t* handles);
+
+        // Returns the handle of @str or a null handle when it was never interned
+        handle_t find(crunes_t const& str) const;
+
+        crunes_t view(handle_t h) const;
+        u64      hash(handle_t h) const;
+        u32      size() const;
+
+        struct entry_t;
+        struct table_t;
+
+    private:
+        handle_t lookup(u64 hash, s32 type, xbyte const* data, u32 len) const;
+        handle_t insert(u64 hash, s32 type, xbyte const* data, u32 len);
+        xbyte*   store(xbyte const* data, u32 len, u32 rune_size);
+        void     grow();
+        void     lock();
+        void     unlock();
+
+        intern_table_t(intern_table_t const&);
+        intern_table_t& operator=(intern_table_t const&);
+
+        alloc_t*               m_allocator;
+        std::atomic<table_t*>  m_table;   // published hash table, old tables are kept in a list
+        entry_t**              m_pages;   // MAX_PAGES page pointers
+        std::atomic<u32>       m_size;    // number of published entries
+        std::atomic<s32>       m_lock;
+        xbyte*                 m_arena;   // current arena block
+        u32                    m_arena_used;
+        u32                    m_arena_size;
+    };
+
+}; // namespace xcore
+
+#endif // __XBASE_INTERN_TABLE_H__
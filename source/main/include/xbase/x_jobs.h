@@ -0,0 +1,59 @@
+#ifndef __XBASE_JOBS_H__
+#define __XBASE_JOBS_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+namespace xcore
+{
+    //==============================================================================
+    // The Jobs API
+    //
+    // xbase does not create threads, functions that can use more than one core
+    // (e.g. calchash_parallel) hand their work to a jobs_t that is implemented
+    // by the application or the xthread package on top of a thread pool or a
+    // job system.
+    //
+    // A job is split into @count tasks that are independent of each other,
+    // run() executes job->execute(i) for every i in [0, count) in any order on
+    // any number of threads and returns when all of them are done.
+    //==============================================================================
+    class job_t
+    {
+    public:
+        virtual void execute(u32 index) = 0;
+
+    protected:
+        virtual ~job_t() {}
+    };
+
+    class jobs_t
+    {
+    public:
+        inline u32  concurrency() const { return v_concurrency(); } // Number of threads that execute tasks
+        inline void run(job_t* job, u32 count) { v_run(job, count); }
+
+    protected:
+        virtual u32  v_concurrency() const      = 0;
+        virtual void v_run(job_t* job, u32 count) = 0;
+
+        virtual ~jobs_t() {}
+    };
+
+    // Runs the tasks of a job on @jobs, or one by one on the calling thread
+    // when @jobs is null
+    inline void run_job(jobs_t* jobs, job_t* job, u32 count)
+    {
+        if (jobs != nullptr && count > 1)
+        {
+            jobs->run(job, count);
+            return;
+        }
+        for (u32 i = 0; i < count; ++i)
+            job->execute(i);
+    }
+
+}; // namespace xcore
+
+#endif // __XBASE_JOBS_H__
@@ -0,0 +1,320 @@
+#ifndef __XBASE_LOCKFREE_QUEUE_H__
+#define __XBASE_LOCKFREE_QUEUE_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include <atomic>
+
+#include "xbase/x_debug.h"
+#include "xbase/x_allocator.h"
+#include "xbase/x_integer.h"
+
+namespace xcore
+{
+    //==============================================================================
+    // Bounded single-producer / single-consumer ring buffer.
+    //
+    // The producer only writes 'tail' and the consumer only writes 'head', both
+    // live on their own cache-line together with a cached copy of the other
+    // side's index so that the shared index is only re-read when the queue looks
+    // full (producer) or empty (consumer).
+    //
+    // Items are copied with operator=, capacity is rounded up to a power of two.
+    //==============================================================================
+    template <typename T> class spsc_queue_t
+    {
+    public:
+        inline spsc_queue_t() : m_allocator(nullptr), m_items(nullptr), m_mask(0), m_tail(0), m_head_cache(0), m_head(0), m_tail_cache(0) {}
+        inline ~spsc_queue_t() { release(); }
+
+        void init(alloc_t* allocator, u32 capacity)
+        {
+            ASSERT(m_items == nullptr);
+            ASSERT(capacity > 0 && capacity <= 0x80000000);
+            capacity    = xispo2(capacity) ? capacity : xceilpo2(capacity);
+            m_allocator = allocator;
+            m_items     = (T*)m_allocator->allocate(capacity * sizeof(T), X_CACHE_LINE_SIZE);
+            m_mask      = capacity - 1;
+            m_tail.store(0, std::memory_order_relaxed);
+            m_head.store(0, std::memory_order_relaxed);
+            m_head_cache = 0;
+            m_tail_cache = 0;
+        }
+
+        void release()
+        {
+            if (m_items != nullptr)
+            {
+                m_allocator->deallocate(m_items);
+                m_items = nullptr;
+            }
+            m_mask = 0;
+        }
+
+        inline u32 capacity() const { return m_mask + 1; }
+
+        // Approximation when called while the other side is active
+        inline u32 size() const { return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire); }
+
+        // Producer side
+        bool push(T const& item) { return push(&item, 1) == 1; }
+        u32  push(T const* items, u32 count)
+        {
+            u32 const tail = m_tail.load(std::memory_order_relaxed);
+            u32       free = capacity() - (tail - m_head_cache);
+            if (free < count)
+            {
+                m_head_cache = m_head.load(std::memory_order_acquire);
+                free         = capacity() - (tail - m_head_cache);
+            }
+            count = xmin(count, free);
+            for (u32 i = 0; i < count; ++i)
+                m_items[(tail + i) & m_mask] = items[i];
+            m_tail.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+        // Consumer side
+        bool pop(T& item) { return pop(&item, 1) == 1; }
+        u32  pop(T* items, u32 count)
+        {
+            u32 const head  = m_head.load(std::memory_order_relaxed);
+            u32       avail = m_tail_cache - head;
+            if (avail < count)
+            {
+                m_tail_cache = m_tail.load(std::memory_order_acquire);
+                avail        = m_tail_cache - head;
+            }
+            count = xmin(count, avail);
+            for (u32 i = 0; i < count; ++i)
+                items[i] = m_items[(head + i) & m_mask];
+            m_head.store(head + count, std::memory_order_release);
+            return count;
+        }
+
+    private:
+        spsc_queue_t(spsc_queue_t const&);
+        spsc_queue_t& operator=(spsc_queue_t const&);
+
+        alloc_t* m_allocator;
+        T*       m_items;
+        u32      m_mask;
+        xbyte    m_pad0[X_CACHE_LINE_SIZE];
+
+        std::atomic<u32> m_tail; // written by the producer
+        u32              m_head_cache;
+        xbyte            m_pad1[X_CACHE_LINE_SIZE - sizeof(u32) * 2];
+
+        std::atomic<u32> m_head; // written by the consumer
+        u32              m_tail_cache;
+        xbyte            m_pad2[X_CACHE_LINE_SIZE - sizeof(u32) * 2];
+    };
+
+    //==============================================================================
+    // Bounded multi-producer / multi-consumer ring buffer (Dmitry Vyukov).
+    //
+    // Every cell carries a sequence number that tells a producer or a consumer if
+    // the cell is ready for them, claiming a cell is a single CAS on the enqueue
+    // or dequeue position which are kept on separate cache-lines.
+    //
+    // The batch functions claim a contiguous range of cells with one CAS, this
+    // keeps the contention on the positions at one CAS per batch instead of one
+    // per item. Only the cells that are already ready are claimed, so a batch
+    // stops at a cell that another (maybe preempted) thread is still completing
+    // and never waits for it, a batch may return less than is in the queue.
+    //
+    // Items are copied with operator=, capacity is rounded up to a power of two.
+    //==============================================================================
+    template <typename T> class mpmc_queue_t
+    {
+    public:
+        inline mpmc_queue_t() : m_allocator(nullptr), m_cells(nullptr), m_mask(0), m_enqueue_pos(0), m_dequeue_pos(0) {}
+        inline ~mpmc_queue_t() { release(); }
+
+        void init(alloc_t* allocator, u32 capacity)
+        {
+            ASSERT(m_cells == nullptr);
+            ASSERT(capacity >= 2 && capacity <= 0x80000000);
+            capacity    = xispo2(capacity) ? capacity : xceilpo2(capacity);
+            m_allocator = allocator;
+            m_cells     = (cell_t*)m_allocator->allocate(capacity * sizeof(cell_t), X_CACHE_LINE_SIZE);
+            m_mask      = capacity - 1;
+            for (u32 i = 0; i < capacity; ++i)
+                m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+            m_enqueue_pos.store(0, std::memory_order_relaxed);
+            m_dequeue_pos.store(0, std::memory_order_relaxed);
+        }
+
+        void release()
+        {
+            if (m_cells != nullptr)
+            {
+                m_allocator->deallocate(m_cells);
+                m_cells = nullptr;
+            }
+            m_mask = 0;
+        }
+
+        inline u32 capacity() const { return m_mask + 1; }
+
+        // Approximation when called while other threads are active
+        inline u32 size() const
+        {
+            u32 const head = m_dequeue_pos.load(std::memory_order_acquire);
+            u32 const tail = m_enqueue_pos.load(std::memory_order_acquire);
+            return (s32)(tail - head) > 0 ? (tail - head) : 0;
+        }
+
+        bool push(T const& item)
+        {
+            cell_t* cell;
+            u32     pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell           = &m_cells[pos & m_mask];
+                u32 const seq  = cell->m_sequence.load(std::memory_order_acquire);
+                s32 const diff = (s32)(seq - pos);
+                if (diff == 0)
+                {
+                    if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    return false; // full
+                }
+                else
+                {
+                    pos = m_enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            cell->m_item = item;
+            cell->m_sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop(T& item)
+        {
+            cell_t* cell;
+            u32     pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell           = &m_cells[pos & m_mask];
+                u32 const seq  = cell->m_sequence.load(std::memory_order_acquire);
+                s32 const diff = (s32)(seq - (pos + 1));
+                if (diff == 0)
+                {
+                    if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    return false; // empty
+                }
+                else
+                {
+                    pos = m_dequeue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            item = cell->m_item;
+            cell->m_sequence.store(pos + m_mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        u32 push(T const* items, u32 count)
+        {
+            u32 pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            u32 n;
+            for (;;)
+            {
+                // The free cells from pos on, a cell is free when its sequence
+                // equals its position and nobody can claim it before pos does
+                count = xmin(count, capacity());
+                for (n = 0; n < count; ++n)
+                {
+                    if (m_cells[(pos + n) & m_mask].m_sequence.load(std::memory_order_acquire) != (pos + n))
+                        break;
+                }
+                if (n == 0)
+                {
+                    s32 const diff = (s32)(m_cells[pos & m_mask].m_sequence.load(std::memory_order_acquire) - pos);
+                    if (diff < 0 || count == 0)
+                        return 0; // full
+                    pos = m_enqueue_pos.load(std::memory_order_relaxed);
+                }
+                else if (m_enqueue_pos.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            for (u32 i = 0; i < n; ++i)
+            {
+                cell_t* cell = &m_cells[(pos + i) & m_mask];
+                cell->m_item = items[i];
+                cell->m_sequence.store(pos + i + 1, std::memory_order_release);
+            }
+            return n;
+        }
+
+        u32 pop(T* items, u32 count)
+        {
+            u32 pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            u32 n;
+            for (;;)
+            {
+                // The filled cells from pos on, a cell is filled when its
+                // sequence is one past its position
+                count = xmin(count, capacity());
+                for (n = 0; n < count; ++n)
+                {
+                    if (m_cells[(pos + n) & m_mask].m_sequence.load(std::memory_order_acquire) != (pos + n + 1))
+                        break;
+                }
+                if (n == 0)
+                {
+                    s32 const diff = (s32)(m_cells[pos & m_mask].m_sequence.load(std::memory_order_acquire) - (pos + 1));
+                    if (diff < 0 || count == 0)
+                        return 0; // empty
+                    pos = m_dequeue_pos.load(std::memory_order_relaxed);
+                }
+                else if (m_dequeue_pos.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            for (u32 i = 0; i < n; ++i)
+            {
+                cell_t* cell = &m_cells[(pos + i) & m_mask];
+                items[i]     = cell->m_item;
+                cell->m_sequence.store(pos + i + m_mask + 1, std::memory_order_release);
+            }
+            return n;
+        }
+
+    private:
+        struct cell_t
+        {
+            std::atomic<u32> m_sequence;
+            T                m_item;
+        };
+
+        mpmc_queue_t(mpmc_queue_t const&);
+        mpmc_queue_t& operator=(mpmc_queue_t const&);
+
+        alloc_t* m_allocator;
+        cell_t*  m_cells;
+        u32      m_mask;
+        xbyte    m_pad0[X_CACHE_LINE_SIZE];
+
+        std::atomic<u32> m_enqueue_pos;
+        xbyte            m_pad1[X_CACHE_LINE_SIZE - sizeof(u32)];
+
+        std::atomic<u32> m_dequeue_pos;
+        xbyte            m_pad2[X_CACHE_LINE_SIZE - sizeof(u32)];
+    };
+
+}; // namespace xcore
+
+#endif // __XBASE_LOCKFREE_QUEUE_H__
@@ -0,0 +1,354 @@
+#ifndef __XBASE_LRU_CACHE_H__
+#define __XBASE_LRU_CACHE_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "xbase/x_allocator.h"
+#include "xbase/x_debug.h"
+#include "xbase/x_hash.h"
+#include "xbase/x_memory.h"
+
+namespace xcore
+{
+    //==============================================================================
+    // Bounded key/value cache
+    //
+    // Every entry is a single node that holds the key, the value, the hash chain
+    // link and the recency links, so an entry costs one allocation and a hit is
+    // a single hash lookup. When the cache is full the node of the evicted entry
+    // is re-used for the new entry.
+    //
+    // The capacity can be limited by the number of entries, by the total number
+    // of bytes (as given to insert()) or both, a limit of 0 means 'no limit'.
+    //
+    // Eviction modes:
+    //   - MODE_LRU   : a hit moves the entry to the front of the recency list,
+    //                  the least recently used entry is evicted.
+    //   - MODE_CLOCK : a hit only sets a 'referenced' flag, the list is a ring
+    //                  that is swept by a clock hand that gives referenced
+    //                  entries a second chance. A hit writes a single flag
+    //                  instead of relinking four pointers.
+    //
+    // Example:
+    //     lru_cache_t<u64, result_t> cache(allocator);
+    //     cache.init(4096);
+    //     result_t* r = cache.get(key);
+    //     if (r == nullptr) cache.insert(key, compute(key));
+    //==============================================================================
+    template <typename K, typename V, typename H = hasher_t<K>> class lru_cache_t
+    {
+    public:
+        enum
+        {
+            MODE_LRU   = 0,
+            MODE_CLOCK = 1,
+        };
+
+        inline lru_cache_t(alloc_t* a = nullptr) : m_allocator(a), m_buckets(nullptr), m_bucket_mask(0), m_head(nullptr), m_size(0), m_max_count(1024), m_bytes(0), m_max_bytes(0), m_mode(MODE_LRU)
+        {
+            if (m_allocator == nullptr)
+            {
+                m_allocator = alloc_t::get_system();
+            }
+        }
+
+        inline ~lru_cache_t() { release(); }
+
+        // Set the capacity and eviction mode, entries are evicted when the cache
+        // holds more than the new capacity allows.
+        void init(u32 max_count, u64 max_bytes = 0, s32 mode = MODE_LRU)
+        {
+            ASSERT(max_count > 0 || max_bytes > 0);
+            m_max_count = max_count;
+            m_max_bytes = max_bytes;
+            m_mode      = mode;
+            while (m_size > 0 && is_over(0, 0))
+                m_allocator->destruct(detach(victim()));
+        }
+
+        inline u32  size() const { return m_size; }
+        inline u64  bytes() const { return m_bytes; }
+        inline bool is_empty() const { return m_size == 0; }
+        inline s32  mode() const { return m_mode; }
+
+        // Returns true when @k was added, false when the value of @k was replaced
+        bool insert(K const& k, V const& v, u32 bytes = 0)
+        {
+            u64 const hash = m_hasher.hash(k);
+            node_t*   node = find_node(hash, k);
+            if (node != nullptr)
+            {
+                node->m_value = v;
+                m_bytes       = m_bytes - node->m_bytes + bytes;
+                node->m_bytes = bytes;
+                touch(node);
+                while (m_size > 1 && is_over(0, 0))
+                {
+                    node_t* evict = victim();
+                    if (evict == node)
+                        break;
+                    m_allocator->destruct(detach(evict));
+                }
+                return false;
+            }
+
+            // Make room, the node of the last evicted entry is re-used
+            node_t* reuse = nullptr;
+            while (m_size > 0 && is_over(1, bytes))
+            {
+                if (reuse != nullptr)
+                    m_allocator->destruct(reuse);
+                reuse = detach(victim());
+            }
+
+            if (reuse != nullptr)
+            {
+                node               = reuse;
+                node->m_hash       = hash;
+                node->m_key        = k;
+                node->m_value      = v;
+                node->m_bytes      = bytes;
+                node->m_referenced = 0;
+            }
+            else
+            {
+                node = m_allocator->construct<node_t>(hash, k, v, bytes);
+            }
+
+            if (m_size >= m_bucket_mask)
+                grow();
+            attach(node);
+            return true;
+        }
+
+        // Lookup, counts as a use of the entry
+        V* get(K const& k)
+        {
+            node_t* node = find_node(m_hasher.hash(k), k);
+            if (node == nullptr)
+                return nullptr;
+            touch(node);
+            return &node->m_value;
+        }
+
+        bool find(K const& k, V& v)
+        {
+            V* pv = get(k);
+            if (pv == nullptr)
+                return false;
+            v = *pv;
+            return true;
+        }
+
+        // Lookup without marking the entry as used
+        inline bool contains(K const& k) const { return find_node(m_hasher.hash(k), k) != nullptr; }
+
+        bool remove(K const& k)
+        {
+            node_t* node = find_node(m_hasher.hash(k), k);
+            if (node == nullptr)
+                return false;
+            m_allocator->destruct(detach(node));
+            return true;
+        }
+
+        bool remove(K const& k, V& v)
+        {
+            node_t* node = find_node(m_hasher.hash(k), k);
+            if (node == nullptr)
+                return false;
+            v = node->m_value;
+            m_allocator->destruct(detach(node));
+            return true;
+        }
+
+        // Evict the entry that the eviction mode selects
+        bool evict(K& k, V& v)
+        {
+            if (m_size == 0)
+                return false;
+            node_t* node = detach(victim());
+            k            = node->m_key;
+            v            = node->m_value;
+            m_allocator->destruct(node);
+            return true;
+        }
+
+        void clear()
+        {
+            while (m_head != nullptr)
+                m_allocator->destruct(detach(m_head));
+        }
+
+        void release()
+        {
+            clear();
+            if (m_buckets != nullptr)
+            {
+                m_allocator->deallocate(m_buckets);
+            }
+            m_buckets     = nullptr;
+            m_bucket_mask = 0;
+        }
+
+    private:
+        struct node_t
+        {
+            inline node_t(u64 hash, K const& key, V const& value, u32 bytes) : m_hash(hash), m_chain(nullptr), m_prev(nullptr), m_next(nullptr), m_bytes(bytes), m_referenced(0), m_key(key), m_value(value) {}
+            u64     m_hash;
+            node_t* m_chain; // next node in the same bucket
+            node_t* m_prev;  // recency ring
+            node_t* m_next;
+            u32     m_bytes;
+            u32     m_referenced;
+            K       m_key;
+            V       m_value;
+            XCORE_CLASS_PLACEMENT_NEW_DELETE
+        };
+
+        // Would the cache be over capacity when @extra_count entries of @extra_bytes are added
+        inline bool is_over(u32 extra_count, u32 extra_bytes) const
+        {
+            return (m_max_count > 0 && (m_size + extra_count) > m_max_count) || (m_max_bytes > 0 && (m_bytes + extra_bytes) > m_max_bytes);
+        }
+
+        node_t* find_node(u64 hash, K const& k) const
+        {
+            if (m_buckets == nullptr)
+                return nullptr;
+            node_t* node = m_buckets[hash & m_bucket_mask];
+            while (node != nullptr)
+            {
+                if (node->m_hash == hash && node->m_key == k)
+                    return node;
+                node = node->m_chain;
+            }
+            return nullptr;
+        }
+
+        // The head is the most recently used entry (LRU) or the clock hand (CLOCK)
+        node_t* victim()
+        {
+            if (m_mode == MODE_LRU)
+                return m_head->m_prev;
+            while (m_head->m_referenced != 0)
+            {
+                m_head->m_referenced = 0;
+                m_head               = m_head->m_next;
+            }
+            return m_head;
+        }
+
+        void touch(node_t* node)
+        {
+            if (m_mode == MODE_CLOCK)
+            {
+                node->m_referenced = 1;
+            }
+            else if (node != m_head)
+            {
+                unlink(node);
+                link(node);
+                m_head = node;
+            }
+        }
+
+        // Insert in front of the head, in LRU mode the node becomes the head, in
+        // CLOCK mode it is the last one the hand will visit.
+        void link(node_t* node)
+        {
+            if (m_head == nullptr)
+            {
+                node->m_prev = node;
+                node->m_next = node;
+                m_head       = node;
+                return;
+            }
+            node->m_next           = m_head;
+            node->m_prev           = m_head->m_prev;
+            m_head->m_prev->m_next = node;
+            m_head->m_prev         = node;
+        }
+
+        void unlink(node_t* node)
+        {
+            if (node->m_next == node)
+            {
+                m_head = nullptr;
+                return;
+            }
+            node->m_prev->m_next = node->m_next;
+            node->m_next->m_prev = node->m_prev;
+            if (m_head == node)
+                m_head = node->m_next;
+        }
+
+        void attach(node_t* node)
+        {
+            node_t** bucket = &m_buckets[node->m_hash & m_bucket_mask];
+            node->m_chain   = *bucket;
+            *bucket         = node;
+            link(node);
+            if (m_mode == MODE_LRU)
+                m_head = node;
+            m_size += 1;
+            m_bytes += node->m_bytes;
+        }
+
+        node_t* detach(node_t* node)
+        {
+            node_t** pnode = &m_buckets[node->m_hash & m_bucket_mask];
+            while (*pnode != node)
+                pnode = &(*pnode)->m_chain;
+            *pnode = node->m_chain;
+            unlink(node);
+            m_size -= 1;
+            m_bytes -= node->m_bytes;
+            return node;
+        }
+
+        void grow()
+        {
+            u32 const      num_buckets = m_buckets == nullptr ? 16 : (m_bucket_mask + 1) * 2;
+            node_t** const buckets     = (node_t**)m_allocator->allocate(num_buckets * sizeof(node_t*), sizeof(void*));
+            x_memclr(buckets, num_buckets * sizeof(node_t*));
+            if (m_buckets != nullptr)
+            {
+                for (u32 i = 0; i <= m_bucket_mask; ++i)
+                {
+                    node_t* node = m_buckets[i];
+                    while (node != nullptr)
+                    {
+                        node_t*  next   = node->m_chain;
+                        node_t** bucket = &buckets[node->m_hash & (num_buckets - 1)];
+                        node->m_chain   = *bucket;
+                        *bucket         = node;
+                        node            = next;
+                    }
+                }
+                m_allocator->deallocate(m_buckets);
+            }
+            m_buckets     = buckets;
+            m_bucket_mask = num_buckets - 1;
+        }
+
+        lru_cache_t(lru_cache_t const&);
+        lru_cache_t& operator=(lru_cache_t const&);
+
+        alloc_t* m_allocator;
+        H        m_hasher;
+        node_t** m_buckets;
+        u32      m_bucket_mask;
+        node_t*  m_head;
+        u32      m_size;
+        u32      m_max_count;
+        u64      m_bytes;
+        u64      m_max_bytes;
+        s32      m_mode;
+    };
+
+}; // namespace xcore
+
+#endif // __XBASE_LRU_CACHE_H__
@@ -63,25 +63,26 @@ namespace xcore
             return true;
         }
 
-        bool find(K const& k, V& v) const
-        {
-            u64 const hash = m_hasher.hash(k);
+        bool find(K const& k, V& v) const { return find_hashed(m_hasher.hash(k), k, v); }
 
-            void* vvalue = nullptr;
-            if (m_tree.find(m_root, hash, vvalue))
+        // Bulk lookup, the keys are hashed in batches through the batch hook of
+        // the hasher (see hash_batch). found[i] tells if values[i] was set,
+        // returns the number of keys found.
+        u32 find(K const* keys, u32 count, V* values, bool* found) const
+        {
+            u64 hashes[64];
+            u32 num_found = 0;
+            for (u32 base = 0; base < count; base += 64)
             {
-                value_t* iter = (value_t*)vvalue;
-                while (iter != nullptr)
+                u32 const n = xmin(count - base, (u32)64);
+                hash_batch(m_hasher, keys + base, hashes, n);
+                for (u32 i = 0; i < n; ++i)
                 {
-                    if (iter->m_key == k)
-                    {
-                        v = iter->m_value;
-                        return true;
-                    }
-                    iter = iter->m_next;
+                    found[base + i] = find_hashed(hashes[i], keys[base + i], values[base + i]);
+                    num_found += found[base + i] ? 1 : 0;
                 }
             }
-            return false;
+            return num_found;
         }
 
         bool remove(K const& k, V& v)
@@ -125,6 +126,25 @@ namespace xcore
         }
 
     private:
+        bool find_hashed(u64 hash, K const& k, V& v) const
+        {
+            void* vvalue = nullptr;
+            if (m_tree.find(m_root, hash, vvalue))
+            {
+                value_t* iter = (value_t*)vvalue;
+                while (iter != nullptr)
+                {
+                    if (iter->m_key == k)
+                    {
+                        v = iter->m_value;
+                        return true;
+                    }
+                    iter = iter->m_next;
+                }
+            }
+            return false;
+        }
+
         struct value_t
         {
             inline value_t(u64 hash, const K& key, const V& value) : m_hash(hash), m_key(key), m_value(value), m_next(nullptr) {}
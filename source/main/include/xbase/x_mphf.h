@@ -0,0 +1,93 @@
+#ifndef __XBASE_MPHF_H__
+#define __XBASE_MPHF_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "xbase/x_buffer.h"
+
+namespace xcore
+{
+    class alloc_t;
+
+    //==============================================================================
+    // Minimal perfect hash function
+    //
+    // Maps every key of a static set of N keys to a unique index in [0, N), so
+    // a table of N values can be indexed with a single probe. The function is
+    // built once (offline or at startup) from the 64-bit hashes of the keys as
+    // given by calchash, the keys themselves are not stored.
+    //
+    // The construction is the one of BBHash: every level is a bit array of
+    // gamma x (keys left) bits, a key that lands on a bit that no other key of
+    // that level lands on is placed there, the keys that collide move to the
+    // next level. The index of a key is the rank of its bit over all levels.
+    // With gamma = 1.0 this takes about 3 bits per key, a larger gamma builds
+    // faster and makes lookups probe fewer levels but takes more memory.
+    //
+    // A key that is not in the set maps to an arbitrary index or INVALID, so
+    // when such keys can be looked up the key stored at the index has to be
+    // compared.
+    //
+    // Example:
+    //     mphf_t mphf(allocator);
+    //     mphf.build(names, count);
+    //     u32 index = mphf.lookup(cbuffer_t(crunes_t("volume")));
+    //     if (index != mphf_t::INVALID && names[index] == ...) ...
+    //==============================================================================
+    class mphf_t
+    {
+    public:
+        mphf_t(alloc_t* a = nullptr);
+        ~mphf_t();
+
+        enum
+        {
+            INVALID    = 0xffffffff,
+            MAX_LEVELS = 32, // keys left after the last level go to a sorted fallback list
+        };
+
+        void release();
+
+        // Build from unique key hashes, @gamma is the bit array size per key in
+        // percent (100 = 1.0). Returns false when two hashes are equal.
+        bool build(u64 const* hashes, u32 count, u32 gamma = 100);
+        bool build(cbuffer_t const* keys, u32 count, u32 gamma = 100);
+
+        u32        lookup(u64 hash) const;
+        inline u32 lookup(cbuffer_t const& key) const { return lookup(hash(key)); }
+
+        inline u32 size() const { return m_count; }
+        u32        size_in_bytes() const;
+
+        // Serialize as [u32 count][u32 levels][u32 fallback count]
+        // [levels + 1 x u32 level offset in bits][words x u64][fallback x u64]
+        u32  serialized_size() const;
+        s32  serialize(binary_writer_t& writer) const; // Returns the number of bytes written or -1
+        bool deserialize(binary_reader_t& reader);
+
+        // The hash of a key as used by build(keys) and lookup(key)
+        static u64 hash(cbuffer_t const& key);
+
+    private:
+        void build_ranks();
+        u32  rank(u32 bit) const;
+
+        mphf_t(mphf_t const&);
+        mphf_t& operator=(mphf_t const&);
+
+        alloc_t* m_allocator;
+        u64*     m_words;    // the bit arrays of all levels
+        u32*     m_ranks;    // number of set bits before every block of 8 words
+        u64*     m_fallback; // sorted hashes of the keys left after the last level
+        u32      m_count;
+        u32      m_levels;
+        u32      m_fallback_count;
+        u32      m_ranked;   // number of set bits in all levels
+        u32      m_offsets[MAX_LEVELS + 1];
+    };
+
+}; // namespace xcore
+
+#endif // __XBASE_MPHF_H__
@@ -11,6 +11,7 @@ namespace xcore
 {
 	//----------------------------------------------------------------------------------------------------------------
 	// Custom QuickSort
+	// For typed arrays use sort<T, L> (x_sort.h), it inlines the comparator and moves whole items
 
 	extern void xqsort(void *a,	// element_array
 		s32 n,					// element_count
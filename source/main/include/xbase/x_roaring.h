@@ -0,0 +1,122 @@
+#ifndef __X_ROARING_BITMAP_H__
+#define __X_ROARING_BITMAP_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+namespace xcore
+{
+    class alloc_t;
+    class binary_reader_t;
+    class binary_writer_t;
+
+    //==============================================================================
+    // Roaring compressed bitmap
+    //
+    // The 32-bit value space is split into chunks of 65536 values keyed by the
+    // upper 16 bits, every non-empty chunk is stored in a container that fits
+    // its density:
+    //   - array  : sorted u16 values, used up to 4096 values (8 KB)
+    //   - bitmap : 1024 x u64 words (8 KB), used above 4096 values
+    //   - run    : sorted [start, length] u16 pairs, created by run_optimize()
+    //
+    // So unlike hibitset_t the memory used depends on the number of values and
+    // not on the range they are in, which makes it a good fit for sparse sets
+    // like posting lists.
+    //
+    // Set operations work in-place (this = this op other). Bitmap containers
+    // are combined with SSE2 when available, array containers are merged or
+    // filtered against the other container.
+    //
+    // Example:
+    //     roaring_t a(allocator), b(allocator);
+    //     a.add(10); a.add(100000);
+    //     b.add(10);
+    //     a.set_intersection(b);  // a = { 10 }
+    //==============================================================================
+    class roaring_t
+    {
+    public:
+        roaring_t(alloc_t* a = nullptr);
+        ~roaring_t();
+
+        enum
+        {
+            TYPE_ARRAY     = 0,
+            TYPE_BITMAP    = 1,
+            TYPE_RUN       = 2,
+            ARRAY_MAX_SIZE = 4096,
+            BITMAP_WORDS   = 1024,
+        };
+
+        void release();
+        void clear();
+        void copy(roaring_t const& other);
+
+        bool add(u32 value);    // Returns true when @value was not in the set
+        bool remove(u32 value); // Returns true when @value was in the set
+        bool contains(u32 value) const;
+
+        inline bool is_empty() const { return m_size == 0; }
+        u64         cardinality() const;
+
+        // Convert containers to run containers where that is smaller,
+        // returns true when at least one container was converted.
+        bool run_optimize();
+
+        void set_union(roaring_t const& other);        // this = this | other
+        void set_intersection(roaring_t const& other); // this = this & other
+        void set_difference(roaring_t const& other);   // this = this & ~other
+
+        // Serialize as [u32 count] { [u16 key][u16 type][u32 size][data] }
+        u32  serialized_size() const;
+        s32  serialize(binary_writer_t& writer) const; // Returns the number of bytes written or -1
+        bool deserialize(binary_reader_t& reader);
+
+        // Iterate over all values from low to high, the set should not be
+        // modified during the iteration.
+        class iter_t
+        {
+        public:
+            iter_t(roaring_t const& set);
+            bool next(u32& value);
+
+        private:
+            void enter();
+
+            roaring_t const* m_set;
+            u32              m_container;
+            u32              m_pos;
+            u32              m_offset;
+            u64              m_word;
+        };
+
+        struct container_t
+        {
+            u16  m_key;
+            u16  m_type;
+            u32  m_size;     // array: number of values, bitmap: cardinality, run: number of runs
+            u32  m_capacity; // array and run: number of u16 that m_data can hold
+            u16* m_data;     // bitmap: BITMAP_WORDS x u64
+        };
+
+    private:
+        s32  find(u16 key) const; // Index of the container or -(insert position + 1)
+        u32  insert_at(u32 index, u16 key);
+        void remove_at(u32 index);
+        void reserve(u32 capacity);
+        void set_op(s32 op, roaring_t const& other);
+
+        roaring_t(roaring_t const&);
+        roaring_t& operator=(roaring_t const&);
+
+        alloc_t*     m_allocator;
+        container_t* m_containers;
+        u32          m_size;
+        u32          m_capacity;
+    };
+
+}; // namespace xcore
+
+#endif // __X_ROARING_BITMAP_H__
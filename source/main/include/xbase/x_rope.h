@@ -0,0 +1,101 @@
+#ifndef __XBASE_ROPE_H__
+#define __XBASE_ROPE_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "xbase/x_runes.h"
+
+namespace xcore
+{
+    class alloc_t;
+
+    //==============================================================================
+    // Rope, text stored as a balanced tree of chunks
+    //
+    // Editing a large runes_t (insert, replaceSelection, removeSelection) moves
+    // the whole tail of the buffer. A rope keeps the text in chunks of at most
+    // 1 KB that are the nodes of an implicit treap (ordered by position), so
+    // insert, remove and concat are O(log n) plus the size of the inserted text.
+    // An edit that cuts chunks joins a chunk that is less than half full with
+    // its neighbour, many small edits do not leave many near-empty chunks.
+    //
+    // All text in a rope has the same rune type (ascii, utf8, utf16 or utf32),
+    // positions and sizes are in code units of that type.
+    //
+    // Example:
+    //     rope_t rope(allocator);
+    //     rope.append(crunes_t("hello world"));
+    //     rope.replace(0, 5, crunes_t("goodbye"));
+    //     rope_t::iter_t iter(rope);
+    //     crunes_t span;
+    //     while (iter.next(span)) { ... }
+    //==============================================================================
+    class rope_t
+    {
+    public:
+        rope_t(alloc_t* a = nullptr, s32 type = ascii::TYPE);
+        ~rope_t();
+
+        inline s32  type() const { return m_type; }
+        s32         size() const;
+        inline bool is_empty() const { return size() == 0; }
+
+        void clear();
+
+        void append(crunes_t const& str);
+        void insert(s32 pos, crunes_t const& str);
+        void remove(s32 from, s32 to);
+        void replace(s32 from, s32 to, crunes_t const& str);
+
+        // Move all the text of @other to the end of this rope, @other will be empty
+        void concat(rope_t& other);
+
+        // Append the text in [from, to) to @out
+        void substring(s32 from, s32 to, rope_t& out) const;
+
+        // The code unit at @pos
+        u32 at(s32 pos) const;
+
+        // Iterate over the text in [from, to) as spans that point into the chunks,
+        // the rope should not be modified during the iteration.
+        class iter_t
+        {
+        public:
+            iter_t(rope_t const& rope);
+            iter_t(rope_t const& rope, s32 from, s32 to);
+            bool next(crunes_t& span);
+
+        private:
+            rope_t const* m_rope;
+            s32           m_pos;
+            s32           m_end;
+        };
+
+        struct node_t;
+
+    private:
+        node_t* new_node();
+        void    free_tree(node_t* node);
+        node_t* build(xbyte const* data, s32 len);
+        node_t* find(s32 pos, s32& offset) const;
+        void    split(node_t* node, s32 pos, node_t*& left, node_t*& right);
+        node_t* merge(node_t* left, node_t* right);
+        bool    insert_in_place(node_t* node, s32 pos, xbyte const* data, s32 len);
+        void    coalesce(s32 pos);
+
+        rope_t(rope_t const&);
+        rope_t& operator=(rope_t const&);
+
+        alloc_t* m_allocator;
+        node_t*  m_root;
+        s32      m_type;
+        s32      m_rune_size;
+        s32      m_chunk_len;
+        u32      m_seed;
+    };
+
+}; // namespace xcore
+
+#endif // __XBASE_ROPE_H__
@@ -8,25 +8,40 @@
 #include "xbase/x_allocator.h"
 #include "xbase/x_debug.h"
 
+#include <atomic>
+
 namespace xcore
 {
     struct slice_data_t;
 
     //==============================================================================
     // A reference counted slice_t owning a memory block with a view/window (from,to).
+    //
+    // Slices obtained from each other share the memory block, insert, remove and
+    // resize first copy the view into a new block when the block is shared
+    // (copy-on-write). With REFCOUNT_ATOMIC the slices that share a block can be
+    // obtained and released from different threads.
     //==============================================================================
     struct slice_t
     {
+        enum
+        {
+            REFCOUNT_PLAIN  = 0, // Single threaded use
+            REFCOUNT_ATOMIC = 1, // Shared slices can be handed to other threads
+        };
+
         slice_t();
-        slice_t(alloc_t* allocator, s32 item_count, s32 item_size);
+        slice_t(alloc_t* allocator, s32 item_count, s32 item_size, s32 refcount_policy = REFCOUNT_PLAIN);
         slice_t(slice_data_t* data, s32 from, s32 to);
 
-        static void alloc(slice_t& slice_t, alloc_t* allocator, s32 item_count, s32 item_size);
+        static void alloc(slice_t& slice_t, alloc_t* allocator, s32 item_count, s32 item_size, s32 refcount_policy = REFCOUNT_PLAIN);
         slice_t     construct(s32 _item_count, s32 _item_size) const;
         s32         size() const;
         s32         refcnt() const;
         slice_t     obtain() const;
         void        release();
+        bool        is_shared() const;
+        void        make_unique(); // Copy the view to a new block when the block is shared
         void        resize(s32 count);
         void        insert(s32 count);
         void        remove(s32 count);
@@ -61,6 +76,7 @@ namespace xcore
         slice_data_t* incref();
         slice_data_t* incref() const;
         slice_data_t* decref();
+        s32           refcount() const;
 
         // This function makes a new 'slice_data_t' with content copied from this
         slice_data_t* copy(s32 from, s32 to);
@@ -70,14 +86,14 @@ namespace xcore
         void insert(s32 at, s32 count);
         void remove(s32 at, s32 count);
 
-        static slice_data_t* alloc(alloc_t* allocator, s32& to_itemcount, s32& to_itemsize);
+        static slice_data_t* alloc(alloc_t* allocator, s32& to_itemcount, s32& to_itemsize, s32 refcount_policy);
 
-        mutable s32 mRefCount;
-        s32         mItemCount; /// Count of total items
-        s32         mItemSize;  /// Size of one item
-        s32         mDummy;
-        alloc_t*    mAllocator;
-        xbyte*      mData;
+        mutable std::atomic<s32> mRefCount;
+        s32                      mItemCount; /// Count of total items
+        s32                      mItemSize;  /// Size of one item
+        s32                      mPolicy;    /// slice_t::REFCOUNT_PLAIN or slice_t::REFCOUNT_ATOMIC
+        alloc_t*                 mAllocator;
+        xbyte*                   mData;
     };
 } // namespace xcore
 
@@ -0,0 +1,228 @@
+#ifndef __XBASE_SLOT_MAP_H__
+#define __XBASE_SLOT_MAP_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "xbase/x_debug.h"
+#include "xbase/x_memory.h"
+#include "xbase/x_allocator.h"
+#include "xbase/x_handle.h"
+
+namespace xcore
+{
+    //==============================================================================
+    // Generational slot map
+    //
+    // A handle_t returned by insert() packs a slot index (lower INDEX_BITS) and the
+    // generation of that slot (upper bits). Removing an item bumps the generation
+    // of its slot, so a stale handle no longer matches and get() returns nullptr
+    // instead of silently aliasing the item that re-used the slot.
+    //
+    // The items themselves are kept densely packed (removal moves the last item
+    // into the hole) so iterating over all live items is a linear walk over an
+    // array. Free slots are linked in an intrusive free list, both insert and
+    // remove are O(1).
+    //
+    // Items are moved with x_memcpy, so T is expected to be plain-old-data.
+    //
+    // Example:
+    //     slot_map_t<entity_t> entities(allocator);
+    //     handle_t h = entities.insert(e);
+    //     entity_t* pe = entities.get(h);
+    //     for (entity_t* it = entities.begin(); it != entities.end(); ++it) { ... }
+    //==============================================================================
+    template <typename T, s32 INDEX_BITS = 24> class slot_map_t
+    {
+    public:
+        enum
+        {
+            INDEX_MASK   = (1 << INDEX_BITS) - 1,
+            GEN_BITS     = 32 - INDEX_BITS,
+            MAX_ITEMS    = INDEX_MASK, // index INDEX_MASK is never used so a handle can never be H_NULL
+            FREELIST_END = 0xffffffff
+        };
+
+        inline slot_map_t(alloc_t* a = nullptr) : m_allocator(a), m_items(nullptr), m_dense_to_slot(nullptr), m_slots(nullptr), m_size(0), m_capacity(0), m_freelist(FREELIST_END)
+        {
+            if (m_allocator == nullptr)
+            {
+                m_allocator = alloc_t::get_system();
+            }
+        }
+
+        inline ~slot_map_t() { release(); }
+
+        inline u32  size() const { return m_size; }
+        inline u32  capacity() const { return m_capacity; }
+        inline bool is_empty() const { return m_size == 0; }
+
+        void reserve(u32 capacity)
+        {
+            if (capacity <= m_capacity)
+                return;
+            if (capacity > (u32)MAX_ITEMS)
+                capacity = (u32)MAX_ITEMS;
+
+            T*      items         = (T*)m_allocator->allocate(capacity * sizeof(T), X_CACHE_LINE_SIZE);
+            u32*    dense_to_slot = (u32*)m_allocator->allocate(capacity * sizeof(u32), sizeof(u32));
+            slot_t* slots         = (slot_t*)m_allocator->allocate(capacity * sizeof(slot_t), sizeof(u32));
+            if (m_capacity > 0)
+            {
+                x_memcpy(items, m_items, m_size * sizeof(T));
+                x_memcpy(dense_to_slot, m_dense_to_slot, m_size * sizeof(u32));
+                x_memcpy(slots, m_slots, m_capacity * sizeof(slot_t));
+                m_allocator->deallocate(m_items);
+                m_allocator->deallocate(m_dense_to_slot);
+                m_allocator->deallocate(m_slots);
+            }
+
+            // Link the new slots in front of the free list, lowest index first
+            for (u32 i = capacity; i > m_capacity; --i)
+            {
+                slots[i - 1].m_index      = m_freelist;
+                slots[i - 1].m_generation = 0;
+                m_freelist                = i - 1;
+            }
+
+            m_items         = items;
+            m_dense_to_slot = dense_to_slot;
+            m_slots         = slots;
+            m_capacity      = capacity;
+        }
+
+        void release()
+        {
+            if (m_capacity > 0)
+            {
+                m_allocator->deallocate(m_items);
+                m_allocator->deallocate(m_dense_to_slot);
+                m_allocator->deallocate(m_slots);
+            }
+            m_items         = nullptr;
+            m_dense_to_slot = nullptr;
+            m_slots         = nullptr;
+            m_size          = 0;
+            m_capacity      = 0;
+            m_freelist      = FREELIST_END;
+        }
+
+        // Remove all items, every outstanding handle becomes stale
+        void clear()
+        {
+            while (m_size > 0)
+                remove_dense(m_size - 1);
+        }
+
+        handle_t insert(T const& item)
+        {
+            if (m_freelist == FREELIST_END)
+            {
+                if (m_capacity == (u32)MAX_ITEMS)
+                    return handle_t();
+                reserve(m_capacity < 16 ? 16 : m_capacity * 2);
+            }
+
+            u32 const index         = m_freelist;
+            slot_t&   slot          = m_slots[index];
+            m_freelist              = slot.m_index;
+            slot.m_index            = m_size;
+            m_items[m_size]         = item;
+            m_dense_to_slot[m_size] = index;
+            m_size += 1;
+            return make_handle(index, slot.m_generation);
+        }
+
+        bool remove(handle_t h)
+        {
+            u32 const index = h.get() & INDEX_MASK;
+            if (!is_live(h, index))
+                return false;
+            remove_dense(m_slots[index].m_index);
+            return true;
+        }
+
+        inline bool contains(handle_t h) const { return is_live(h, h.get() & INDEX_MASK); }
+
+        inline T* get(handle_t h)
+        {
+            u32 const index = h.get() & INDEX_MASK;
+            return is_live(h, index) ? &m_items[m_slots[index].m_index] : nullptr;
+        }
+        inline T const* get(handle_t h) const
+        {
+            u32 const index = h.get() & INDEX_MASK;
+            return is_live(h, index) ? &m_items[m_slots[index].m_index] : nullptr;
+        }
+
+        // Dense iteration, the order changes when items are removed
+        inline T*       begin() { return m_items; }
+        inline T*       end() { return m_items + m_size; }
+        inline T const* begin() const { return m_items; }
+        inline T const* end() const { return m_items + m_size; }
+
+        inline T& at(u32 dense_index)
+        {
+            ASSERT(dense_index < m_size);
+            return m_items[dense_index];
+        }
+        inline handle_t handle_at(u32 dense_index) const
+        {
+            ASSERT(dense_index < m_size);
+            u32 const index = m_dense_to_slot[dense_index];
+            return make_handle(index, m_slots[index].m_generation);
+        }
+
+    private:
+        struct slot_t
+        {
+            u32 m_index;      // dense index when live, next free slot when free
+            u32 m_generation;
+        };
+
+        static inline handle_t make_handle(u32 index, u32 generation) { return handle_t(((generation << INDEX_BITS) & ~(u32)INDEX_MASK) | index); }
+
+        inline bool is_live(handle_t h, u32 index) const
+        {
+            if (h.isNull() || index >= m_capacity)
+                return false;
+            slot_t const& slot = m_slots[index];
+            return make_handle(index, slot.m_generation) == h && slot.m_index < m_size && m_dense_to_slot[slot.m_index] == index;
+        }
+
+        void remove_dense(u32 dense)
+        {
+            u32 const index = m_dense_to_slot[dense];
+            slot_t&   slot  = m_slots[index];
+
+            // Move the last item into the hole
+            m_size -= 1;
+            if (dense < m_size)
+            {
+                u32 const moved = m_dense_to_slot[m_size];
+                x_memcpy(&m_items[dense], &m_items[m_size], sizeof(T));
+                m_dense_to_slot[dense] = moved;
+                m_slots[moved].m_index = dense;
+            }
+
+            slot.m_generation += 1;
+            slot.m_index = m_freelist;
+            m_freelist   = index;
+        }
+
+        slot_map_t(slot_map_t const&);
+        slot_map_t& operator=(slot_map_t const&);
+
+        alloc_t* m_allocator;
+        T*       m_items;
+        u32*     m_dense_to_slot;
+        slot_t*  m_slots;
+        u32      m_size;
+        u32      m_capacity;
+        u32      m_freelist;
+    };
+
+}; // namespace xcore
+
+#endif // __XBASE_SLOT_MAP_H__
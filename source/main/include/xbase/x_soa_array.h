@@ -0,0 +1,238 @@
+#ifndef __XBASE_SOA_ARRAY_H__
+#define __XBASE_SOA_ARRAY_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "xbase/x_debug.h"
+#include "xbase/x_memory.h"
+#include "xbase/x_allocator.h"
+#include "xbase/x_integer.h"
+
+namespace xcore
+{
+    // A view on one column of a soa_array_t, the pointer is aligned to the column
+    // alignment so that loops over it can be vectorized by the compiler.
+    template <typename T> class soa_column_t
+    {
+    public:
+        inline soa_column_t() : m_data(nullptr), m_size(0) {}
+        inline soa_column_t(T* data, u32 size) : m_data(data), m_size(size) {}
+
+        inline u32  size() const { return m_size; }
+        inline bool is_empty() const { return m_size == 0; }
+
+        inline T* begin() const { return m_data; }
+        inline T* end() const { return m_data + m_size; }
+
+        inline T&       operator[](u32 index) { ASSERT(index < m_size); return m_data[index]; }
+        inline T const& operator[](u32 index) const { ASSERT(index < m_size); return m_data[index]; }
+
+    private:
+        T*  m_data;
+        u32 m_size;
+    };
+
+    namespace xsoa
+    {
+        template <s32 N, typename T, typename... Rest> struct type_at
+        {
+            typedef typename type_at<N - 1, Rest...>::type type;
+        };
+        template <typename T, typename... Rest> struct type_at<0, T, Rest...>
+        {
+            typedef T type;
+        };
+    } // namespace xsoa
+
+    //==============================================================================
+    // Structure-of-arrays container, every field of a 'record' is stored in its own
+    // contiguous column. All columns share the same size and capacity and live in a
+    // single allocation, each column starts on a X_CACHE_LINE_SIZE boundary.
+    //
+    // Like carray_t the items are moved around with x_memcpy, so the field types are
+    // expected to be plain-old-data.
+    //
+    // Example:
+    //     soa_array_t<f32, f32, u32> particles(allocator);
+    //     particles.reserve(1024);
+    //     particles.push_back(1.0f, 2.0f, 3);
+    //     soa_column_t<f32> xs = particles.column<0>();
+    //==============================================================================
+    template <typename... Ts> class soa_array_t
+    {
+    public:
+        enum
+        {
+            COLUMNS = sizeof...(Ts),
+            ALIGNMENT = X_CACHE_LINE_SIZE
+        };
+
+        template <s32 N> struct column_type
+        {
+            typedef typename xsoa::type_at<N, Ts...>::type type;
+        };
+
+        inline soa_array_t(alloc_t* a = nullptr) : m_allocator(a), m_memory(nullptr), m_size(0), m_capacity(0)
+        {
+            if (m_allocator == nullptr)
+            {
+                m_allocator = alloc_t::get_system();
+            }
+            for (s32 i = 0; i < COLUMNS; ++i)
+                m_columns[i] = nullptr;
+        }
+
+        inline ~soa_array_t() { release(); }
+
+        inline u32  size() const { return m_size; }
+        inline u32  capacity() const { return m_capacity; }
+        inline bool is_empty() const { return m_size == 0; }
+        inline bool is_full() const { return m_size == m_capacity; }
+        inline void clear() { m_size = 0; }
+
+        void release()
+        {
+            if (m_memory != nullptr)
+            {
+                m_allocator->deallocate(m_memory);
+                m_memory = nullptr;
+            }
+            for (s32 i = 0; i < COLUMNS; ++i)
+                m_columns[i] = nullptr;
+            m_size     = 0;
+            m_capacity = 0;
+        }
+
+        // Grow all the columns to hold at least @capacity items, this is one allocation
+        // and one copy per column.
+        void reserve(u32 capacity)
+        {
+            if (capacity <= m_capacity)
+                return;
+
+            u32 total = 0;
+            for (s32 i = 0; i < COLUMNS; ++i)
+                total += xalignUp(capacity * sizeof_column(i), (u32)ALIGNMENT);
+
+            xbyte* memory = (xbyte*)m_allocator->allocate(total, ALIGNMENT);
+            xbyte* column = memory;
+            for (s32 i = 0; i < COLUMNS; ++i)
+            {
+                if (m_size > 0)
+                    x_memcpy(column, m_columns[i], m_size * sizeof_column(i));
+                m_columns[i] = column;
+                column += xalignUp(capacity * sizeof_column(i), (u32)ALIGNMENT);
+            }
+
+            if (m_memory != nullptr)
+                m_allocator->deallocate(m_memory);
+            m_memory   = memory;
+            m_capacity = capacity;
+        }
+
+        // Set the size, new items are not initialized
+        void resize(u32 size)
+        {
+            if (size > m_capacity)
+                reserve(size);
+            m_size = size;
+        }
+
+        void push_back(Ts const&... values)
+        {
+            if (m_size == m_capacity)
+                reserve(m_capacity < 16 ? 16 : (m_capacity + (m_capacity >> 1)));
+            store<0>(m_size, values...);
+            m_size += 1;
+        }
+
+        bool pop_back()
+        {
+            if (m_size == 0)
+                return false;
+            m_size -= 1;
+            return true;
+        }
+
+        // Remove the item at @index by moving the last item into its place
+        void swap_remove(u32 index)
+        {
+            ASSERT(index < m_size);
+            m_size -= 1;
+            if (index < m_size)
+            {
+                for (s32 i = 0; i < COLUMNS; ++i)
+                {
+                    u32 const s = sizeof_column(i);
+                    x_memcpy(m_columns[i] + (index * s), m_columns[i] + (m_size * s), s);
+                }
+            }
+        }
+
+        // Remove the item at @index, keeps the order of the items
+        void remove(u32 index)
+        {
+            ASSERT(index < m_size);
+            m_size -= 1;
+            if (index < m_size)
+            {
+                for (s32 i = 0; i < COLUMNS; ++i)
+                {
+                    u32 const s = sizeof_column(i);
+                    x_memmove(m_columns[i] + (index * s), m_columns[i] + ((index + 1) * s), (m_size - index) * s);
+                }
+            }
+        }
+
+        void set(u32 index, Ts const&... values)
+        {
+            ASSERT(index < m_size);
+            store<0>(index, values...);
+        }
+
+        template <s32 N> inline typename column_type<N>::type& get(u32 index)
+        {
+            ASSERT(index < m_size);
+            return data<N>()[index];
+        }
+        template <s32 N> inline typename column_type<N>::type const& get(u32 index) const
+        {
+            ASSERT(index < m_size);
+            return data<N>()[index];
+        }
+
+        template <s32 N> inline typename column_type<N>::type* data() { return (typename column_type<N>::type*)m_columns[N]; }
+        template <s32 N> inline typename column_type<N>::type const* data() const { return (typename column_type<N>::type const*)m_columns[N]; }
+
+        template <s32 N> inline soa_column_t<typename column_type<N>::type> column() { return soa_column_t<typename column_type<N>::type>(data<N>(), m_size); }
+        template <s32 N> inline soa_column_t<typename column_type<N>::type const> column() const { return soa_column_t<typename column_type<N>::type const>(data<N>(), m_size); }
+
+    private:
+        static inline u32 sizeof_column(s32 i)
+        {
+            static const u32 s_sizeof[] = {sizeof(Ts)...};
+            return s_sizeof[i];
+        }
+
+        template <s32 I, typename T, typename... Rest> inline void store(u32 index, T const& value, Rest const&... rest)
+        {
+            ((T*)m_columns[I])[index] = value;
+            store<I + 1>(index, rest...);
+        }
+        template <s32 I> inline void store(u32) {}
+
+        soa_array_t(soa_array_t const&);
+        soa_array_t& operator=(soa_array_t const&);
+
+        alloc_t* m_allocator;
+        xbyte*   m_memory;
+        xbyte*   m_columns[sizeof...(Ts)];
+        u32      m_size;
+        u32      m_capacity;
+    };
+
+}; // namespace xcore
+
+#endif // __XBASE_SOA_ARRAY_H__
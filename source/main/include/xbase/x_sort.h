@@ -0,0 +1,1484 @@
+#ifndef __XBASE_SORT_H__
+#define __XBASE_SORT_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#    pragma once
+#endif
+
+#include "xbase/x_debug.h"
+#include "xbase/x_allocator.h"
+#include "xbase/x_buffer.h"
+#include "xbase/x_integer.h"
+#include "xbase/x_jobs.h"
+#include "xbase/x_memory.h"
+
+namespace xcore
+{
+    template <typename T> struct sort_less_t
+    {
+        inline bool operator()(T const& a, T const& b) const { return a < b; }
+    };
+
+    // Sort uses a branchless partition for comparators that compile to a
+    // conditional move (by default sort_less_t on numbers), it can be
+    // specialized for other cheap comparators
+    template <typename T, typename L> struct sort_branchless_t
+    {
+        enum
+        {
+            VALUE = 0
+        };
+    };
+
+#define X_SORT_BRANCHLESS(T)                          \
+    template <> struct sort_branchless_t<T, sort_less_t<T> > \
+    {                                                 \
+        enum                                          \
+        {                                             \
+            VALUE = 1                                 \
+        };                                            \
+    }
+    X_SORT_BRANCHLESS(s8);
+    X_SORT_BRANCHLESS(u8);
+    X_SORT_BRANCHLESS(s16);
+    X_SORT_BRANCHLESS(u16);
+    X_SORT_BRANCHLESS(s32);
+    X_SORT_BRANCHLESS(u32);
+    X_SORT_BRANCHLESS(s64);
+    X_SORT_BRANCHLESS(u64);
+    X_SORT_BRANCHLESS(f32);
+    X_SORT_BRANCHLESS(f64);
+#undef X_SORT_BRANCHLESS
+
+    namespace nsort
+    {
+        enum
+        {
+            INSERTION_SORT_THRESHOLD     = 24,  // partitions smaller than this are insertion sorted
+            NINTHER_THRESHOLD            = 128, // partitions larger than this pick the pivot with a median of 3 medians
+            PARTIAL_INSERTION_SORT_LIMIT = 8,   // moves before an optimistic insertion sort gives up
+            BLOCK_SIZE                   = 64   // items per block of the branchless partition
+        };
+
+        template <typename T> inline void swap(T& a, T& b)
+        {
+            T t = a;
+            a   = b;
+            b   = t;
+        }
+
+        template <typename T, typename L> void insertion_sort(T* items, u32 count, L const& less)
+        {
+            for (u32 i = 1; i < count; ++i)
+            {
+                if (!less(items[i], items[i - 1]))
+                    continue;
+                T   item = items[i];
+                u32 j    = i;
+                do
+                {
+                    items[j] = items[j - 1];
+                    --j;
+                } while (j > 0 && less(item, items[j - 1]));
+                items[j] = item;
+            }
+        }
+
+        // Insertion sort without a bounds check, @begin[-1] is not greater
+        // than any item in [begin, end)
+        template <typename T, typename L> void unguarded_insertion_sort(T* begin, T* end, L const& less)
+        {
+            for (T* cur = begin + 1; cur < end; ++cur)
+            {
+                if (!less(*cur, *(cur - 1)))
+                    continue;
+                T  item = *cur;
+                T* sift = cur;
+                do
+                {
+                    *sift = *(sift - 1);
+                    --sift;
+                } while (less(item, *(sift - 1)));
+                *sift = item;
+            }
+        }
+
+        // Insertion sort that gives up after PARTIAL_INSERTION_SORT_LIMIT moves,
+        // returns true when [begin, end) is sorted
+        template <typename T, typename L> bool partial_insertion_sort(T* begin, T* end, L const& less)
+        {
+            u32 moves = 0;
+            for (T* cur = begin + 1; cur < end; ++cur)
+            {
+                if (!less(*cur, *(cur - 1)))
+                    continue;
+                T  item = *cur;
+                T* sift = cur;
+                do
+                {
+                    *sift = *(sift - 1);
+                    --sift;
+                } while (sift != begin && less(item, *(sift - 1)));
+                *sift = item;
+                moves += (u32)(cur - sift);
+                if (moves > PARTIAL_INSERTION_SORT_LIMIT)
+                    return false;
+            }
+            return true;
+        }
+
+        template <typename T, typename L> void sift_down(T* items, u32 root, u32 count, L const& less)
+        {
+            T item = items[root];
+            for (;;)
+            {
+                u32 child = 2 * root + 1;
+                if (child >= count)
+                    break;
+                if ((child + 1) < count && less(items[child], items[child + 1]))
+                    ++child;
+                if (!less(item, items[child]))
+                    break;
+                items[root] = items[child];
+                root        = child;
+            }
+            items[root] = item;
+        }
+
+        template <typename T, typename L> void heap_sort(T* items, u32 count, L const& less)
+        {
+            for (u32 i = count / 2; i > 0; --i)
+                sift_down(items, i - 1, count, less);
+            for (u32 i = count - 1; i > 0; --i)
+            {
+                swap(items[0], items[i]);
+                sift_down(items, 0, i, less);
+            }
+        }
+
+        // Orders the items at a, b and c, the median ends up at b
+        template <typename T, typename L> inline void sort3(T* a, T* b, T* c, L const& less)
+        {
+            if (less(*b, *a))
+                swap(*a, *b);
+            if (less(*c, *b))
+            {
+                swap(*b, *c);
+                if (less(*b, *a))
+                    swap(*a, *b);
+            }
+        }
+
+        // Partitions [begin, end) around the pivot at @begin, items equal to
+        // the pivot go to the right. Returns the final position of the pivot,
+        // @already_partitioned is set when no item had to be moved.
+        template <typename T, typename L> T* partition_right(T* begin, T* end, L const& less, bool& already_partitioned)
+        {
+            T const pivot = *begin;
+            T*      first = begin;
+            T*      last  = end;
+
+            // The median of 3 guarantees an item not less than the pivot, the
+            // search from the right needs a guard when the first one is at begin + 1
+            while (less(*++first, pivot))
+                ;
+            if ((first - 1) == begin)
+            {
+                while (first < last && !less(*--last, pivot))
+                    ;
+            }
+            else
+            {
+                while (!less(*--last, pivot))
+                    ;
+            }
+
+            already_partitioned = first >= last;
+            while (first < last)
+            {
+                swap(*first, *last);
+                while (less(*++first, pivot))
+                    ;
+                while (!less(*--last, pivot))
+                    ;
+            }
+
+            T* pivot_pos = first - 1;
+            *begin       = *pivot_pos;
+            *pivot_pos   = pivot;
+            return pivot_pos;
+        }
+
+        // Moves the items at the left offsets and the right offsets to the
+        // other side, as a cycle instead of swaps unless the counts are equal
+        // (needed to stay O(n) on descending input)
+        template <typename T> inline void swap_offsets(T* first, T* last, u8 const* offsets_l, u8 const* offsets_r, u32 num, bool use_swaps)
+        {
+            if (use_swaps)
+            {
+                for (u32 i = 0; i < num; ++i)
+                    swap(*(first + offsets_l[i]), *(last - offsets_r[i]));
+            }
+            else if (num > 0)
+            {
+                T* l   = first + offsets_l[0];
+                T* r   = last - offsets_r[0];
+                T  tmp = *l;
+                *l     = *r;
+                for (u32 i = 1; i < num; ++i)
+                {
+                    l  = first + offsets_l[i];
+                    *r = *l;
+                    r  = last - offsets_r[i];
+                    *l = *r;
+                }
+                *r = tmp;
+            }
+        }
+
+        // partition_right without branches on the comparisons (BlockQuicksort,
+        // Edelkamp and Weiss), the offsets of the items that are on the wrong
+        // side are collected per block of 64 items on both ends and then
+        // swapped. The comparison result is only used as an integer.
+        template <typename T, typename L> T* partition_right_branchless(T* begin, T* end, L const& less, bool& already_partitioned)
+        {
+            T const pivot = *begin;
+            T*      first = begin;
+            T*      last  = end;
+
+            while (less(*++first, pivot))
+                ;
+            if ((first - 1) == begin)
+            {
+                while (first < last && !less(*--last, pivot))
+                    ;
+            }
+            else
+            {
+                while (!less(*--last, pivot))
+                    ;
+            }
+
+            already_partitioned = first >= last;
+            if (!already_partitioned)
+            {
+                swap(*first, *last);
+                ++first;
+
+                u8  offsets_l[BLOCK_SIZE];
+                u8  offsets_r[BLOCK_SIZE];
+                T*  offsets_l_base = first;
+                T*  offsets_r_base = last;
+                u32 num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+                while (first < last)
+                {
+                    // Fill the blocks that are empty, when both are empty the
+                    // unknown items are split between them
+                    u32 const num_unknown = (u32)(last - first);
+                    u32 const left_split  = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+                    u32 const right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+                    u32 const fill_l = left_split < BLOCK_SIZE ? left_split : (u32)BLOCK_SIZE;
+                    for (u32 i = 0; i < fill_l;)
+                    {
+                        offsets_l[num_l] = (u8)i++;
+                        num_l += !less(*first, pivot);
+                        ++first;
+                    }
+                    u32 const fill_r = right_split < BLOCK_SIZE ? right_split : (u32)BLOCK_SIZE;
+                    for (u32 i = 0; i < fill_r;)
+                    {
+                        offsets_r[num_r] = (u8)++i;
+                        num_r += less(*--last, pivot);
+                    }
+
+                    u32 const num = num_l < num_r ? num_l : num_r;
+                    swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r, num, num_l == num_r);
+                    num_l -= num;
+                    num_r -= num;
+                    start_l += num;
+                    start_r += num;
+                    if (num_l == 0)
+                    {
+                        start_l        = 0;
+                        offsets_l_base = first;
+                    }
+                    if (num_r == 0)
+                    {
+                        start_r        = 0;
+                        offsets_r_base = last;
+                    }
+                }
+
+                // One of the blocks still has items, they go to the other end
+                // of the remaining range
+                if (num_l > 0)
+                {
+                    while (num_l-- > 0)
+                        swap(*(offsets_l_base + offsets_l[start_l + num_l]), *--last);
+                    first = last;
+                }
+                if (num_r > 0)
+                {
+                    while (num_r-- > 0)
+                    {
+                        swap(*(offsets_r_base - offsets_r[start_r + num_r]), *first);
+                        ++first;
+                    }
+                    last = first;
+                }
+            }
+
+            T* pivot_pos = first - 1;
+            *begin       = *pivot_pos;
+            *pivot_pos   = pivot;
+            return pivot_pos;
+        }
+
+        // Partitions [begin, end) around the pivot at @begin with the items
+        // equal to the pivot on the left, used when the pivot equals the item
+        // before @begin, the left part then needs no more sorting
+        template <typename T, typename L> T* partition_left(T* begin, T* end, L const& less)
+        {
+            T const pivot = *begin;
+            T*      first = begin;
+            T*      last  = end;
+
+            while (less(pivot, *--last))
+                ;
+            if ((last + 1) == end)
+            {
+                while (first < last && !less(pivot, *++first))
+                    ;
+            }
+            else
+            {
+                while (!less(pivot, *++first))
+                    ;
+            }
+
+            while (first < last)
+            {
+                swap(*first, *last);
+                while (less(pivot, *--last))
+                    ;
+                while (!less(pivot, *++first))
+                    ;
+            }
+
+            T* pivot_pos = last;
+            *begin       = *pivot_pos;
+            *pivot_pos   = pivot;
+            return pivot_pos;
+        }
+
+        template <bool B, typename T, typename L> void pdqsort(T* begin, T* end, L const& less, s32 bad_allowed, bool leftmost)
+        {
+            for (;;)
+            {
+                u32 const size = (u32)(end - begin);
+                if (size < INSERTION_SORT_THRESHOLD)
+                {
+                    if (leftmost)
+                        insertion_sort(begin, size, less);
+                    else
+                        unguarded_insertion_sort(begin, end, less);
+                    return;
+                }
+
+                // The pivot is moved to begin
+                u32 const s2 = size / 2;
+                if (size > NINTHER_THRESHOLD)
+                {
+                    sort3(begin, begin + s2, end - 1, less);
+                    sort3(begin + 1, begin + (s2 - 1), end - 2, less);
+                    sort3(begin + 2, begin + (s2 + 1), end - 3, less);
+                    sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), less);
+                    swap(*begin, *(begin + s2));
+                }
+                else
+                {
+                    sort3(begin + s2, begin, end - 1, less);
+                }
+
+                // The item before this range is not greater than any item in
+                // it, when it equals the pivot every item equal to the pivot is
+                // put on the left and only the greater items need sorting
+                if (!leftmost && !less(*(begin - 1), *begin))
+                {
+                    begin = partition_left(begin, end, less) + 1;
+                    continue;
+                }
+
+                bool      already_partitioned;
+                T* const  pivot_pos = B ? partition_right_branchless(begin, end, less, already_partitioned) : partition_right(begin, end, less, already_partitioned);
+                u32 const l_size    = (u32)(pivot_pos - begin);
+                u32 const r_size    = (u32)(end - (pivot_pos + 1));
+
+                if (l_size < (size / 8) || r_size < (size / 8))
+                {
+                    // Too many bad partitions, the rest is heap sorted
+                    if (--bad_allowed == 0)
+                    {
+                        heap_sort(begin, size, less);
+                        return;
+                    }
+
+                    // Break up patterns that made the pivot bad
+                    if (l_size >= INSERTION_SORT_THRESHOLD)
+                    {
+                        swap(*begin, *(begin + l_size / 4));
+                        swap(*(pivot_pos - 1), *(pivot_pos - l_size / 4));
+                        if (l_size > NINTHER_THRESHOLD)
+                        {
+                            swap(*(begin + 1), *(begin + (l_size / 4 + 1)));
+                            swap(*(begin + 2), *(begin + (l_size / 4 + 2)));
+                            swap(*(pivot_pos - 2), *(pivot_pos - (l_size / 4 + 1)));
+                            swap(*(pivot_pos - 3), *(pivot_pos - (l_size / 4 + 2)));
+                        }
+                    }
+                    if (r_size >= INSERTION_SORT_THRESHOLD)
+                    {
+                        swap(*(pivot_pos + 1), *(pivot_pos + (1 + r_size / 4)));
+                        swap(*(end - 1), *(end - r_size / 4));
+                        if (r_size > NINTHER_THRESHOLD)
+                        {
+                            swap(*(pivot_pos + 2), *(pivot_pos + (2 + r_size / 4)));
+                            swap(*(pivot_pos + 3), *(pivot_pos + (3 + r_size / 4)));
+                            swap(*(end - 2), *(end - (1 + r_size / 4)));
+                            swap(*(end - 3), *(end - (2 + r_size / 4)));
+                        }
+                    }
+                }
+                else if (already_partitioned && partial_insertion_sort(begin, pivot_pos, less) && partial_insertion_sort(pivot_pos + 1, end, less))
+                {
+                    // A balanced partition that moved nothing, the input is
+                    // probably (nearly) sorted
+                    return;
+                }
+
+                pdqsort<B>(begin, pivot_pos, less, bad_allowed, leftmost);
+                begin    = pivot_pos + 1;
+                leftmost = false;
+            }
+        }
+    } // namespace nsort
+
+    //==============================================================================
+    // Sort an array of T in place with a comparator L that is inlined by the
+    // compiler, L(a, b) returns true when a should be ordered before b.
+    //
+    // Pattern-defeating quicksort (after Orson Peters' pdqsort): quicksort
+    // with a median of 3 (or of 3 medians) pivot and insertion sort for small
+    // partitions, plus
+    // - a partition that moved no items is checked with an insertion sort
+    //   that gives up quickly, sorted input takes O(n)
+    // - descending input becomes ascending after the first partition
+    // - runs of equal items are put aside in one partition, many duplicates
+    //   take O(n log k) for k distinct values
+    // - after log2(count) unbalanced partitions the items that made the
+    //   pivot bad are shuffled, and when that does not help the partition is
+    //   heap sorted, so the worst case stays O(n log n)
+    // - numbers compared with sort_less_t are partitioned without branches on
+    //   the comparisons (see sort_branchless_t)
+    //
+    // Items are moved as whole objects with their copy constructor and
+    // assignment. The sort is not stable.
+    //
+    // For untyped arrays with a comparison callback see xqsort (x_qsort.h).
+    //
+    // Example:
+    //     sort(values, count);
+    //     sort(records, count, record_by_time_t());
+    //==============================================================================
+    template <typename T, typename L> inline void sort(T* items, u32 count, L const& less)
+    {
+        if (count > 1)
+            nsort::pdqsort<sort_branchless_t<T, L>::VALUE != 0>(items, items + count, less, xilog2(count), true);
+    }
+
+    template <typename T> inline void sort(T* items, u32 count) { sort(items, count, sort_less_t<T>()); }
+
+    namespace nsort
+    {
+        // Radix sort keys as unsigned integers with the same order, signed
+        // integers have their sign bit flipped, negative floats have all bits
+        // flipped and positive floats only the sign bit
+        inline u32 radix_bits(u32 k) { return k; }
+        inline u32 radix_bits(s32 k) { return (u32)k ^ 0x80000000u; }
+        inline u64 radix_bits(u64 k) { return k; }
+        inline u64 radix_bits(s64 k) { return (u64)k ^ ((u64)1 << 63); }
+        inline u32 radix_bits(f32 k)
+        {
+            union
+            {
+                f32 f;
+                u32 u;
+            } bits;
+            bits.f = k;
+            return bits.u ^ ((u32)((s32)bits.u >> 31) | 0x80000000u);
+        }
+        inline u64 radix_bits(f64 k)
+        {
+            union
+            {
+                f64 f;
+                u64 u;
+            } bits;
+            bits.f = k;
+            return bits.u ^ ((u64)((s64)bits.u >> 63) | ((u64)1 << 63));
+        }
+
+        template <typename T> struct radix_identity_t
+        {
+            inline T const& operator()(T const& item) const { return item; }
+        };
+
+        template <typename T, typename K> struct radix_less_t
+        {
+            inline radix_less_t(K const& key) : m_key(key) {}
+            inline bool operator()(T const& a, T const& b) const { return radix_bits(m_key(a)) < radix_bits(m_key(b)); }
+            K const& m_key;
+        };
+
+        enum
+        {
+            RADIX_DIGIT_BITS  = 11,
+            RADIX_BUCKETS     = 1 << RADIX_DIGIT_BITS,
+            RADIX_MAX_PASSES  = (64 + RADIX_DIGIT_BITS - 1) / RADIX_DIGIT_BITS,
+            RADIX_SMALL       = 64, // this many items or less are insertion sorted
+            RADIX_WC_MAX_ITEM = 16  // items up to this size are scattered through write-combining buffers
+        };
+
+        // Scratch memory layout: [write-combining buffers][items][histograms]
+        template <typename T> inline u32 radix_wc_size() { return sizeof(T) <= RADIX_WC_MAX_ITEM ? RADIX_BUCKETS * X_CACHE_LINE_SIZE : 0; }
+        template <typename T> inline u64 radix_items_size(u32 count) { return ((u64)count * sizeof(T) + 3) & ~(u64)3; }
+        template <typename T> inline u64 radix_scratch_size(u32 count) { return X_CACHE_LINE_SIZE + radix_wc_size<T>() + radix_items_size<T>(count) + RADIX_MAX_PASSES * RADIX_BUCKETS * sizeof(u32); }
+
+        // Moves the items to the bucket of their digit. Every bucket first
+        // collects a cache line of items, a full line is written to the
+        // destination at once instead of touching 2048 lines at random.
+        template <typename T, typename K> void radix_scatter_wc(T const* src, T* dst, u32 count, K const& key, s32 shift, u32* offsets, T* lines)
+        {
+            u32 const line_items = X_CACHE_LINE_SIZE / sizeof(T);
+            u8        fill[RADIX_BUCKETS];
+            x_memclr(fill, sizeof(fill));
+            for (u32 i = 0; i < count; ++i)
+            {
+                u32 const digit = (u32)(radix_bits(key(src[i])) >> shift) & (RADIX_BUCKETS - 1);
+                T*        line  = lines + digit * line_items;
+                u32       f     = fill[digit];
+                line[f++]       = src[i];
+                if (f == line_items)
+                {
+                    T* out = dst + offsets[digit];
+                    for (u32 j = 0; j < line_items; ++j)
+                        out[j] = line[j];
+                    offsets[digit] += line_items;
+                    f = 0;
+                }
+                fill[digit] = (u8)f;
+            }
+            for (u32 digit = 0; digit < RADIX_BUCKETS; ++digit)
+            {
+                T const* line = lines + digit * line_items;
+                T*       out  = dst + offsets[digit];
+                for (u32 j = 0; j < fill[digit]; ++j)
+                    out[j] = line[j];
+            }
+        }
+
+        template <typename T, typename K> void radix_scatter(T const* src, T* dst, u32 count, K const& key, s32 shift, u32* offsets)
+        {
+            for (u32 i = 0; i < count; ++i)
+            {
+                u32 const digit      = (u32)(radix_bits(key(src[i])) >> shift) & (RADIX_BUCKETS - 1);
+                dst[offsets[digit]++] = src[i];
+            }
+        }
+
+        // LSD radix sort, @scratch is radix_scratch_size<T>(count) bytes
+        template <typename T, typename K> void radix_sort(T* items, u32 count, K const& key, xbyte* scratch)
+        {
+            typedef decltype(radix_bits(key(items[0]))) bits_t;
+            u32 const passes = (sizeof(bits_t) * 8 + RADIX_DIGIT_BITS - 1) / RADIX_DIGIT_BITS;
+
+            xbyte* base   = (xbyte*)(((uptr)scratch + X_CACHE_LINE_SIZE - 1) & ~(uptr)(X_CACHE_LINE_SIZE - 1));
+            T*     lines  = (T*)base;
+            T*     temp   = (T*)(base + radix_wc_size<T>());
+            u32*   counts = (u32*)(base + radix_wc_size<T>() + radix_items_size<T>(count));
+
+            // The histograms of all digits in one pass over the keys
+            x_memclr(counts, passes * RADIX_BUCKETS * sizeof(u32));
+            for (u32 i = 0; i < count; ++i)
+            {
+                bits_t const k = radix_bits(key(items[i]));
+                for (u32 p = 0; p < passes; ++p)
+                    counts[p * RADIX_BUCKETS + ((u32)(k >> (p * RADIX_DIGIT_BITS)) & (RADIX_BUCKETS - 1))] += 1;
+            }
+
+            T* src = items;
+            T* dst = temp;
+            for (u32 p = 0; p < passes; ++p)
+            {
+                s32 const shift   = p * RADIX_DIGIT_BITS;
+                u32*      offsets = counts + p * RADIX_BUCKETS;
+
+                // A digit that is the same for all keys (e.g. the high bits of
+                // timestamps) does not change the order
+                if (offsets[(u32)(radix_bits(key(src[0])) >> shift) & (RADIX_BUCKETS - 1)] == count)
+                    continue;
+
+                u32 sum = 0;
+                for (u32 d = 0; d < RADIX_BUCKETS; ++d)
+                {
+                    u32 const c = offsets[d];
+                    offsets[d]  = sum;
+                    sum += c;
+                }
+
+                if (radix_wc_size<T>() > 0)
+                    radix_scatter_wc(src, dst, count, key, shift, offsets, lines);
+                else
+                    radix_scatter(src, dst, count, key, shift, offsets);
+
+                T* t = src;
+                src  = dst;
+                dst  = t;
+            }
+            if (src != items)
+            {
+                for (u32 i = 0; i < count; ++i)
+                    items[i] = src[i];
+            }
+        }
+    } // namespace nsort
+
+    //==============================================================================
+    // Radix sort for u32, s32, u64, s64, f32 and f64 keys, or for items that
+    // are sorted on such a key given by the functor K (key(item) returns it).
+    //
+    // LSD with 11-bit digits, so 3 passes for 32-bit keys and 6 for 64-bit
+    // keys. All histograms are counted in one pass over the keys, a digit that
+    // is the same for all keys is skipped. Items of 16 bytes or smaller are
+    // scattered through write-combining buffers. The sort is stable and takes
+    // O(n) time, floats are ordered -inf < .. < -0.0 < 0.0 < .. < inf. Every
+    // pass moves the items, large records with wide keys can sort faster with
+    // sort() or by radix sorting (key, index) pairs.
+    //
+    // The scratch memory holds a copy of the items plus about 180 KB, it is
+    // taken from @allocator (the system allocator by default) or from a
+    // caller-supplied buffer of radix_sort_scratch_size<T>(count) bytes. Items
+    // are copied into the scratch memory by assignment, T should be plain data.
+    // alloc_t takes a u32 size, when the scratch memory of the allocator
+    // overloads does not fit in one they return false and leave @items as is.
+    //
+    // Example:
+    //     radix_sort(timestamps, count);
+    //     radix_sort_by(records, count, record_time_t(), scratch);
+    //==============================================================================
+    template <typename T> inline u64 radix_sort_scratch_size(u32 count) { return nsort::radix_scratch_size<T>(count); }
+
+    template <typename T, typename K> bool radix_sort_by(T* items, u32 count, K const& key, alloc_t* allocator = nullptr)
+    {
+        if (count <= nsort::RADIX_SMALL)
+        {
+            nsort::insertion_sort(items, count, nsort::radix_less_t<T, K>(key));
+            return true;
+        }
+        u64 const size = nsort::radix_scratch_size<T>(count);
+        ASSERT(size <= (u64)0xffffffff);
+        if (size > (u64)0xffffffff)
+            return false;
+        if (allocator == nullptr)
+            allocator = alloc_t::get_system();
+        xbyte* scratch = (xbyte*)allocator->allocate((u32)size, X_CACHE_LINE_SIZE);
+        nsort::radix_sort(items, count, key, scratch);
+        allocator->deallocate(scratch);
+        return true;
+    }
+
+    // Returns false when @scratch is smaller than radix_sort_scratch_size<T>(count)
+    template <typename T, typename K> bool radix_sort_by(T* items, u32 count, K const& key, buffer_t const& scratch)
+    {
+        if (count <= nsort::RADIX_SMALL)
+        {
+            nsort::insertion_sort(items, count, nsort::radix_less_t<T, K>(key));
+            return true;
+        }
+        if ((u64)scratch.m_len < nsort::radix_scratch_size<T>(count))
+            return false;
+        nsort::radix_sort(items, count, key, scratch.m_mutable);
+        return true;
+    }
+
+    template <typename T> inline bool radix_sort(T* items, u32 count, alloc_t* allocator = nullptr) { return radix_sort_by(items, count, nsort::radix_identity_t<T>(), allocator); }
+    template <typename T> inline bool radix_sort(T* items, u32 count, buffer_t const& scratch) { return radix_sort_by(items, count, nsort::radix_identity_t<T>(), scratch); }
+
+    namespace nsort
+    {
+        enum
+        {
+            PARALLEL_SORT_MIN_CHUNK = 16384, // smaller arrays are sorted on the calling thread
+            PARALLEL_MERGE_TASKS    = 4      // merge tasks per thread in every round
+        };
+
+        // The number of items of run @a that are among the first @k items of
+        // the stable merge of @a and @b (items of @a go first on ties)
+        template <typename T, typename L> u32 merge_corank(T const* a, u32 na, T const* b, u32 nb, u32 k, L const& less)
+        {
+            u32 lo = k > nb ? k - nb : 0;
+            u32 hi = k < na ? k : na;
+            while (lo < hi)
+            {
+                u32 const i = (lo + hi) / 2;
+                if (less(b[k - i - 1], a[i]))
+                    hi = i;
+                else
+                    lo = i + 1;
+            }
+            return lo;
+        }
+
+        template <typename T, typename L> void merge(T const* a, u32 na, T const* b, u32 nb, T* dst, L const& less)
+        {
+            u32 i = 0, j = 0;
+            while (i < na && j < nb)
+            {
+                if (less(b[j], a[i]))
+                    *dst++ = b[j++];
+                else
+                    *dst++ = a[i++];
+            }
+            while (i < na)
+                *dst++ = a[i++];
+            while (j < nb)
+                *dst++ = b[j++];
+        }
+
+        template <typename T, typename L> class sort_chunks_job_t : public job_t
+        {
+        public:
+            inline sort_chunks_job_t(T* items, u32 const* runs, L const& less) : m_items(items), m_runs(runs), m_less(less) {}
+
+            virtual void execute(u32 index) { sort(m_items + m_runs[index], m_runs[index + 1] - m_runs[index], m_less); }
+
+            T*         m_items;
+            u32 const* m_runs;
+            L const&   m_less;
+        };
+
+        // Merges runs 2p and 2p + 1 of @m_src into @m_dst, every pair is split
+        // into @m_parts tasks that each write a range of the output
+        template <typename T, typename L> class merge_runs_job_t : public job_t
+        {
+        public:
+            inline merge_runs_job_t(T const* src, T* dst, u32 const* runs, u32 num_runs, u32 parts, L const& less) : m_src(src), m_dst(dst), m_runs(runs), m_num_runs(num_runs), m_parts(parts), m_less(less) {}
+
+            virtual void execute(u32 index)
+            {
+                u32 const pair  = index / m_parts;
+                u32 const part  = index % m_parts;
+                u32 const begin = m_runs[2 * pair];
+                u32 const mid   = m_runs[xmin(2 * pair + 1, m_num_runs)];
+                u32 const end   = m_runs[xmin(2 * pair + 2, m_num_runs)];
+
+                T const*  a  = m_src + begin;
+                T const*  b  = m_src + mid;
+                u32 const na = mid - begin;
+                u32 const nb = end - mid;
+                u32 const k0 = (u32)(((u64)(na + nb) * part) / m_parts);
+                u32 const k1 = (u32)(((u64)(na + nb) * (part + 1)) / m_parts);
+                u32 const i0 = merge_corank(a, na, b, nb, k0, m_less);
+                u32 const i1 = merge_corank(a, na, b, nb, k1, m_less);
+                merge(a + i0, i1 - i0, b + (k0 - i0), (k1 - i1) - (k0 - i0), m_dst + begin + k0, m_less);
+            }
+
+            T const*   m_src;
+            T*         m_dst;
+            u32 const* m_runs;
+            u32        m_num_runs;
+            u32        m_parts;
+            L const&   m_less;
+        };
+    } // namespace nsort
+
+    //==============================================================================
+    // Sort an array on the threads of @jobs (see x_jobs.h). The array is split
+    // in one chunk per thread that is sorted with sort(), after that pairs of
+    // sorted runs are merged in log2(threads) rounds. Every merge is split in
+    // tasks that write a part of the output, the split points are found with
+    // a binary search on both runs (merge path), so also the last rounds use
+    // all threads.
+    //
+    // The merges ping-pong between the array and a scratch copy of @count
+    // items taken from @allocator (the system allocator by default), items are
+    // copied into it by assignment, T should be plain data. An array of more
+    // than 4 GB is first split in slices around pivots so that the scratch
+    // copy of every slice fits in a u32 size. Arrays smaller than 2 chunks of
+    // PARALLEL_SORT_MIN_CHUNK items, or when @jobs is null, are sorted on the
+    // calling thread. The sort is not stable.
+    //
+    // Example:
+    //     parallel_sort(records, count, record_by_time_t(), jobs);
+    //==============================================================================
+    template <typename T, typename L> void parallel_sort(T* items, u32 count, L const& less, jobs_t* jobs, alloc_t* allocator = nullptr);
+
+    namespace nsort
+    {
+        // parallel_sort with a scratch copy of at most @max_scratch bytes, a
+        // larger array is first partitioned around pivots on the calling thread
+        // until every slice fits, the slices are then sorted one after another
+        template <typename T, typename L> void parallel_sort(T* items, u32 count, L const& less, jobs_t* jobs, alloc_t* allocator, u64 max_scratch)
+        {
+            while (jobs != nullptr && (u64)count * sizeof(T) > max_scratch)
+            {
+                T* const  begin = items;
+                T* const  end   = items + count;
+                u32 const s2    = count / 2;
+                if (count > NINTHER_THRESHOLD)
+                {
+                    sort3(begin, begin + s2, end - 1, less);
+                    sort3(begin + 1, begin + (s2 - 1), end - 2, less);
+                    sort3(begin + 2, begin + (s2 + 1), end - 3, less);
+                    sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), less);
+                    swap(*begin, *(begin + s2));
+                }
+                else
+                {
+                    sort3(begin + s2, begin, end - 1, less);
+                }
+
+                bool      already_partitioned;
+                T* const  pivot_pos = partition_right(begin, end, less, already_partitioned);
+                u32 const l_size    = (u32)(pivot_pos - begin);
+                if (l_size == 0)
+                {
+                    // The pivot is the smallest item, the items equal to it are done
+                    T* const equal_end = partition_left(begin, end, less) + 1;
+                    count -= (u32)(equal_end - begin);
+                    items = equal_end;
+                    continue;
+                }
+
+                parallel_sort(begin, l_size, less, jobs, allocator, max_scratch);
+                items = pivot_pos + 1;
+                count -= l_size + 1;
+            }
+
+            u32 num_runs = jobs != nullptr ? xmin(jobs->concurrency(), count / (u32)PARALLEL_SORT_MIN_CHUNK) : 1;
+            if (num_runs <= 1)
+            {
+                xcore::sort(items, count, less);
+                return;
+            }
+
+            if (allocator == nullptr)
+                allocator = alloc_t::get_system();
+            ASSERT((u64)count * sizeof(T) <= (u64)0xffffffff);
+            u32* runs    = (u32*)allocator->allocate((num_runs + 1) * sizeof(u32), sizeof(u32));
+            T*   scratch = (T*)allocator->allocate((u32)((u64)count * sizeof(T)), X_CACHE_LINE_SIZE);
+            for (u32 i = 0; i <= num_runs; ++i)
+                runs[i] = (u32)(((u64)count * i) / num_runs);
+
+            sort_chunks_job_t<T, L> sort_job(items, runs, less);
+            jobs->run(&sort_job, num_runs);
+
+            u32 const tasks = jobs->concurrency() * PARALLEL_MERGE_TASKS;
+            T*        src   = items;
+            T*        dst   = scratch;
+            while (num_runs > 1)
+            {
+                // An odd run at the end is merged with an empty run (copied)
+                u32 const pairs = (num_runs + 1) / 2;
+                u32 const parts = xmax(tasks / pairs, 1u);
+                runs[num_runs]  = count;
+
+                merge_runs_job_t<T, L> merge_job(src, dst, runs, num_runs, parts, less);
+                jobs->run(&merge_job, pairs * parts);
+
+                for (u32 i = 0; i < pairs; ++i)
+                    runs[i] = runs[2 * i];
+                runs[pairs] = count;
+                num_runs    = pairs;
+
+                T* t = src;
+                src  = dst;
+                dst  = t;
+            }
+
+            // The sorted items are in the scratch copy after an odd number of rounds
+            if (src != items)
+            {
+                merge_runs_job_t<T, L> copy_job(src, items, runs, 1, tasks, less);
+                jobs->run(&copy_job, tasks);
+            }
+
+            allocator->deallocate(scratch);
+            allocator->deallocate(runs);
+        }
+    } // namespace nsort
+
+    // The scratch copy comes from alloc_t::allocate which takes a u32 size
+    template <typename T, typename L> inline void parallel_sort(T* items, u32 count, L const& less, jobs_t* jobs, alloc_t* allocator) { nsort::parallel_sort(items, count, less, jobs, allocator, (u64)0xffffffff); }
+    template <typename T> inline void parallel_sort(T* items, u32 count, jobs_t* jobs, alloc_t* allocator = nullptr) { parallel_sort(items, count, sort_less_t<T>(), jobs, allocator); }
+
+    namespace nsort
+    {
+        enum
+        {
+            MERGE_SORT_THRESHOLD = 24, // parts of this size or smaller are insertion sorted
+            TIM_MIN_MERGE        = 64, // arrays smaller than this are one binary insertion sorted run
+            TIM_MIN_GALLOP       = 7,  // wins in a row after which a merge starts galloping
+            TIM_MAX_RUNS         = 64  // the run lengths grow faster than fibonacci, 64 is plenty for 2^32 items
+        };
+
+        // Top-down merge sort, the left half is copied to @scratch and merged
+        // back with the right half. Halves that are already in order are not
+        // merged.
+        template <typename T, typename L> void merge_sort(T* items, u32 count, L const& less, T* scratch)
+        {
+            if (count <= MERGE_SORT_THRESHOLD)
+            {
+                insertion_sort(items, count, less);
+                return;
+            }
+
+            u32 const mid = count / 2;
+            merge_sort(items, mid, less, scratch);
+            merge_sort(items + mid, count - mid, less, scratch);
+            if (!less(items[mid], items[mid - 1]))
+                return;
+
+            for (u32 i = 0; i < mid; ++i)
+                scratch[i] = items[i];
+            u32 i = 0, j = mid, k = 0;
+            while (i < mid && j < count)
+            {
+                if (less(items[j], scratch[i]))
+                    items[k++] = items[j++];
+                else
+                    items[k++] = scratch[i++];
+            }
+            while (i < mid)
+                items[k++] = scratch[i++];
+        }
+
+        // Binary insertion sort of [start, count), [0, start) is sorted. Equal
+        // items are inserted after the ones already there.
+        template <typename T, typename L> void binary_insertion_sort(T* items, u32 count, u32 start, L const& less)
+        {
+            for (u32 i = start; i < count; ++i)
+            {
+                T   item = items[i];
+                u32 lo   = 0;
+                u32 hi   = i;
+                while (lo < hi)
+                {
+                    u32 const m = lo + (hi - lo) / 2;
+                    if (less(item, items[m]))
+                        hi = m;
+                    else
+                        lo = m + 1;
+                }
+                for (u32 j = i; j > lo; --j)
+                    items[j] = items[j - 1];
+                items[lo] = item;
+            }
+        }
+
+        // Length of the run that starts at @items, a strictly descending run
+        // is reversed (strictly, so equal items keep their order)
+        template <typename T, typename L> u32 count_run(T* items, u32 count, L const& less)
+        {
+            if (count <= 1)
+                return count;
+            u32 n = 2;
+            if (less(items[1], items[0]))
+            {
+                while (n < count && less(items[n], items[n - 1]))
+                    ++n;
+                for (u32 lo = 0, hi = n - 1; lo < hi; ++lo, --hi)
+                    swap(items[lo], items[hi]);
+            }
+            else
+            {
+                while (n < count && !less(items[n], items[n - 1]))
+                    ++n;
+            }
+            return n;
+        }
+
+        // Position of @key in the sorted @items, before the items equal to it
+        // (gallop_left) or after them (gallop_right). The search starts at
+        // @hint with steps of 1, 3, 7, 15, .. and ends with a binary search.
+        template <typename T, typename L> u32 gallop_left(T const& key, T const* items, u32 count, u32 hint, L const& less)
+        {
+            s64 last = 0;
+            s64 ofs  = 1;
+            if (less(items[hint], key))
+            {
+                s64 const max = count - hint;
+                while (ofs < max && less(items[hint + ofs], key))
+                {
+                    last = ofs;
+                    ofs  = (ofs << 1) + 1;
+                }
+                ofs = ofs < max ? ofs : max;
+                last += hint;
+                ofs += hint;
+            }
+            else
+            {
+                s64 const max = hint + 1;
+                while (ofs < max && !less(items[hint - ofs], key))
+                {
+                    last = ofs;
+                    ofs  = (ofs << 1) + 1;
+                }
+                ofs         = ofs < max ? ofs : max;
+                s64 const k = last;
+                last        = hint - ofs;
+                ofs         = hint - k;
+            }
+
+            // items[last] < key <= items[ofs]
+            ++last;
+            while (last < ofs)
+            {
+                s64 const m = last + ((ofs - last) >> 1);
+                if (less(items[m], key))
+                    last = m + 1;
+                else
+                    ofs = m;
+            }
+            return (u32)ofs;
+        }
+
+        template <typename T, typename L> u32 gallop_right(T const& key, T const* items, u32 count, u32 hint, L const& less)
+        {
+            s64 last = 0;
+            s64 ofs  = 1;
+            if (less(key, items[hint]))
+            {
+                s64 const max = hint + 1;
+                while (ofs < max && less(key, items[hint - ofs]))
+                {
+                    last = ofs;
+                    ofs  = (ofs << 1) + 1;
+                }
+                ofs         = ofs < max ? ofs : max;
+                s64 const k = last;
+                last        = hint - ofs;
+                ofs         = hint - k;
+            }
+            else
+            {
+                s64 const max = count - hint;
+                while (ofs < max && !less(key, items[hint + ofs]))
+                {
+                    last = ofs;
+                    ofs  = (ofs << 1) + 1;
+                }
+                ofs = ofs < max ? ofs : max;
+                last += hint;
+                ofs += hint;
+            }
+
+            // items[last] <= key < items[ofs]
+            ++last;
+            while (last < ofs)
+            {
+                s64 const m = last + ((ofs - last) >> 1);
+                if (less(key, items[m]))
+                    ofs = m;
+                else
+                    last = m + 1;
+            }
+            return (u32)ofs;
+        }
+
+        template <typename T, typename L> class tim_sort_t
+        {
+        public:
+            inline tim_sort_t(T* items, T* scratch, L const& less) : m_items(items), m_scratch(scratch), m_less(less), m_min_gallop(TIM_MIN_GALLOP), m_num_runs(0) {}
+
+            void sort(u32 count)
+            {
+                u32 const min_run = s_min_run(count);
+                u32       lo      = 0;
+                while (lo < count)
+                {
+                    // Short runs are extended to min_run items
+                    u32 n = count_run(m_items + lo, count - lo, m_less);
+                    if (n < min_run)
+                    {
+                        u32 const forced = xmin(min_run, count - lo);
+                        binary_insertion_sort(m_items + lo, forced, n, m_less);
+                        n = forced;
+                    }
+
+                    m_base[m_num_runs] = lo;
+                    m_len[m_num_runs]  = n;
+                    m_num_runs += 1;
+                    merge_collapse();
+                    lo += n;
+                }
+                while (m_num_runs > 1)
+                {
+                    u32 i = m_num_runs - 2;
+                    if (i > 0 && m_len[i - 1] < m_len[i + 1])
+                        --i;
+                    merge_at(i);
+                }
+            }
+
+        private:
+            // A number in [32, 64] so that count / min_run is (close to) a
+            // power of 2 and the merges stay balanced
+            static u32 s_min_run(u32 n)
+            {
+                u32 r = 0;
+                while (n >= TIM_MIN_MERGE)
+                {
+                    r |= n & 1;
+                    n >>= 1;
+                }
+                return n + r;
+            }
+
+            // Keeps the run lengths on the stack growing faster than fibonacci
+            // from top to bottom, including the run 3 below the top
+            void merge_collapse()
+            {
+                while (m_num_runs > 1)
+                {
+                    u32 i = m_num_runs - 2;
+                    if ((i > 0 && m_len[i - 1] <= (m_len[i] + m_len[i + 1])) || (i > 1 && m_len[i - 2] <= (m_len[i - 1] + m_len[i])))
+                    {
+                        if (m_len[i - 1] < m_len[i + 1])
+                            --i;
+                    }
+                    else if (m_len[i] > m_len[i + 1])
+                    {
+                        break;
+                    }
+                    merge_at(i);
+                }
+            }
+
+            // Merges run i and i + 1
+            void merge_at(u32 i)
+            {
+                T*  a  = m_items + m_base[i];
+                u32 na = m_len[i];
+                T*  b  = m_items + m_base[i + 1];
+                u32 nb = m_len[i + 1];
+
+                m_len[i] = na + nb;
+                if (i == (m_num_runs - 3))
+                {
+                    m_base[i + 1] = m_base[i + 2];
+                    m_len[i + 1]  = m_len[i + 2];
+                }
+                m_num_runs -= 1;
+
+                // Items of a that are not greater than b[0] and items of b
+                // that are not less than the last item of a are in place
+                u32 const k = gallop_right(b[0], a, na, 0, m_less);
+                a += k;
+                na -= k;
+                if (na == 0)
+                    return;
+                nb = gallop_left(a[na - 1], b, nb, nb - 1, m_less);
+                if (nb == 0)
+                    return;
+
+                if (na <= nb)
+                    merge_lo(a, na, b, nb);
+                else
+                    merge_hi(a, na, b, nb);
+            }
+
+            // Merges a and b from the front with a in scratch, b[0] < a[0] and
+            // a[na - 1] > b[nb - 1]. When one run keeps winning the merge
+            // switches to galloping.
+            void merge_lo(T* a, u32 na, T* b, u32 nb)
+            {
+                T* pa   = m_scratch;
+                T* pb   = b;
+                T* dest = a;
+                for (u32 i = 0; i < na; ++i)
+                    pa[i] = a[i];
+
+                *dest++ = *pb++;
+                if (--nb == 0)
+                    goto succeed;
+                if (na == 1)
+                    goto copy_a;
+
+                for (;;)
+                {
+                    u32 acount = 0;
+                    u32 bcount = 0;
+                    for (;;)
+                    {
+                        if (m_less(*pb, *pa))
+                        {
+                            *dest++ = *pb++;
+                            ++bcount;
+                            acount = 0;
+                            if (--nb == 0)
+                                goto succeed;
+                            if (bcount >= m_min_gallop)
+                                break;
+                        }
+                        else
+                        {
+                            *dest++ = *pa++;
+                            ++acount;
+                            bcount = 0;
+                            if (--na == 1)
+                                goto copy_a;
+                            if (acount >= m_min_gallop)
+                                break;
+                        }
+                    }
+
+                    m_min_gallop += 1;
+                    do
+                    {
+                        m_min_gallop -= m_min_gallop > 1 ? 1 : 0;
+
+                        acount = gallop_right(*pb, pa, na, 0, m_less);
+                        for (u32 i = 0; i < acount; ++i)
+                            *dest++ = *pa++;
+                        na -= acount;
+                        if (na == 1)
+                            goto copy_a;
+                        if (na == 0)
+                            goto succeed;
+                        *dest++ = *pb++;
+                        if (--nb == 0)
+                            goto succeed;
+
+                        bcount = gallop_left(*pa, pb, nb, 0, m_less);
+                        for (u32 i = 0; i < bcount; ++i)
+                            *dest++ = *pb++;
+                        nb -= bcount;
+                        if (nb == 0)
+                            goto succeed;
+                        *dest++ = *pa++;
+                        if (--na == 1)
+                            goto copy_a;
+                    } while (acount >= TIM_MIN_GALLOP || bcount >= TIM_MIN_GALLOP);
+                    m_min_gallop += 1;
+                }
+
+            succeed:
+                for (u32 i = 0; i < na; ++i)
+                    *dest++ = *pa++;
+                return;
+
+            copy_a:
+                // The last item of a goes after the rest of b
+                for (u32 i = 0; i < nb; ++i)
+                    *dest++ = *pb++;
+                *dest = *pa;
+            }
+
+            // Merges a and b from the back with b in scratch, same conditions
+            // as merge_lo
+            void merge_hi(T* a, u32 na, T* b, u32 nb)
+            {
+                for (u32 i = 0; i < nb; ++i)
+                    m_scratch[i] = b[i];
+                T* const base_a = a;
+                T* const base_b = m_scratch;
+                T*       pa     = a + na - 1;
+                T*       pb     = m_scratch + nb - 1;
+                T*       dest   = b + nb - 1;
+
+                *dest-- = *pa--;
+                if (--na == 0)
+                    goto succeed;
+                if (nb == 1)
+                    goto copy_b;
+
+                for (;;)
+                {
+                    u32 acount = 0;
+                    u32 bcount = 0;
+                    for (;;)
+                    {
+                        if (m_less(*pb, *pa))
+                        {
+                            *dest-- = *pa--;
+                            ++acount;
+                            bcount = 0;
+                            if (--na == 0)
+                                goto succeed;
+                            if (acount >= m_min_gallop)
+                                break;
+                        }
+                        else
+                        {
+                            *dest-- = *pb--;
+                            ++bcount;
+                            acount = 0;
+                            if (--nb == 1)
+                                goto copy_b;
+                            if (bcount >= m_min_gallop)
+                                break;
+                        }
+                    }
+
+                    m_min_gallop += 1;
+                    do
+                    {
+                        m_min_gallop -= m_min_gallop > 1 ? 1 : 0;
+
+                        acount = na - gallop_right(*pb, base_a, na, na - 1, m_less);
+                        for (u32 i = 0; i < acount; ++i)
+                            *dest-- = *pa--;
+                        na -= acount;
+                        if (na == 0)
+                            goto succeed;
+                        *dest-- = *pb--;
+                        if (--nb == 1)
+                            goto copy_b;
+
+                        bcount = nb - gallop_left(*pa, base_b, nb, nb - 1, m_less);
+                        for (u32 i = 0; i < bcount; ++i)
+                            *dest-- = *pb--;
+                        nb -= bcount;
+                        if (nb == 1)
+                            goto copy_b;
+                        if (nb == 0)
+                            goto succeed;
+                        *dest-- = *pa--;
+                        if (--na == 0)
+                            goto succeed;
+                    } while (acount >= TIM_MIN_GALLOP || bcount >= TIM_MIN_GALLOP);
+                    m_min_gallop += 1;
+                }
+
+            succeed:
+                for (u32 i = 0; i < nb; ++i)
+                    *dest-- = *pb--;
+                return;
+
+            copy_b:
+                // The first item of b goes before the rest of a
+                for (u32 i = 0; i < na; ++i)
+                    *dest-- = *pa--;
+                *dest = *pb;
+            }
+
+            T*       m_items;
+            T*       m_scratch;
+            L const& m_less;
+            u32      m_min_gallop;
+            u32      m_num_runs;
+            u32      m_base[TIM_MAX_RUNS];
+            u32      m_len[TIM_MAX_RUNS];
+        };
+
+        template <typename T, typename L> void tim_sort(T* items, u32 count, L const& less, T* scratch)
+        {
+            if (count < TIM_MIN_MERGE)
+            {
+                binary_insertion_sort(items, count, count_run(items, count, less), less);
+                return;
+            }
+            tim_sort_t<T, L> sorter(items, scratch, less);
+            sorter.sort(count);
+        }
+    } // namespace nsort
+
+    //==============================================================================
+    // Stable sorts, items that are equal keep their order.
+    //
+    // merge_sort: top-down merge sort, small parts are insertion sorted and
+    // halves that are already in order are not merged. O(n log n).
+    //
+    // tim_sort: adaptive merge sort (after Tim Peters' timsort) for data that
+    // is partly ordered. Ascending and strictly descending runs are found and
+    // extended to 32..64 items with a binary insertion sort, the runs are
+    // merged in a balanced order. When one run keeps winning during a merge
+    // the merge gallops: it searches where the next item of the other run goes
+    // with steps of 1, 3, 7, .. instead of comparing one item at a time.
+    // Sorted input takes n - 1 comparisons, appending a few items to a sorted
+    // array and sorting again takes O(n + k log n).
+    //
+    // Both need scratch memory for half of the items, taken from @allocator
+    // (the system allocator by default) or from a caller-supplied buffer of
+    // stable_sort_scratch_size<T>(count) bytes. Items are copied into the
+    // scratch memory by assignment, T should be plain data. alloc_t takes a u32
+    // size, when the scratch memory of the allocator overloads does not fit in
+    // one (more than 8 GB of items) they return false and leave @items as is.
+    //
+    // Example:
+    //     tim_sort(log_records, count, record_by_time_t());
+    //==============================================================================
+    template <typename T> inline u64 stable_sort_scratch_size(u32 count) { return (u64)(count / 2) * sizeof(T); }
+
+    template <typename T, typename L> bool merge_sort(T* items, u32 count, L const& less, alloc_t* allocator = nullptr)
+    {
+        if (count <= nsort::MERGE_SORT_THRESHOLD)
+        {
+            nsort::insertion_sort(items, count, less);
+            return true;
+        }
+        u64 const size = stable_sort_scratch_size<T>(count);
+        ASSERT(size <= (u64)0xffffffff);
+        if (size > (u64)0xffffffff)
+            return false;
+        if (allocator == nullptr)
+            allocator = alloc_t::get_system();
+        T* scratch = (T*)allocator->allocate((u32)size, sizeof(void*));
+        nsort::merge_sort(items, count, less, scratch);
+        allocator->deallocate(scratch);
+        return true;
+    }
+
+    // Returns false when @scratch is smaller than stable_sort_scratch_size<T>(count)
+    template <typename T, typename L> bool merge_sort(T* items, u32 count, L const& less, buffer_t const& scratch)
+    {
+        if ((u64)scratch.m_len < stable_sort_scratch_size<T>(count))
+            return false;
+        nsort::merge_sort(items, count, less, (T*)scratch.m_mutable);
+        return true;
+    }
+
+    template <typename T, typename L> bool tim_sort(T* items, u32 count, L const& less, alloc_t* allocator = nullptr)
+    {
+        if (count < nsort::TIM_MIN_MERGE)
+        {
+            nsort::tim_sort(items, count, less, (T*)nullptr);
+            return true;
+        }
+        u64 const size = stable_sort_scratch_size<T>(count);
+        ASSERT(size <= (u64)0xffffffff);
+        if (size > (u64)0xffffffff)
+            return false;
+        if (allocator == nullptr)
+            allocator = alloc_t::get_system();
+        T* scratch = (T*)allocator->allocate((u32)size, sizeof(void*));
+        nsort::tim_sort(items, count, less, scratch);
+        allocator->deallocate(scratch);
+        return true;
+    }
+
+    // Returns false when @scratch is smaller than stable_sort_scratch_size<T>(count)
+    template <typename T, typename L> bool tim_sort(T* items, u32 count, L const& less, buffer_t const& scratch)
+    {
+        if ((u64)scratch.m_len < stable_sort_scratch_size<T>(count))
+            return false;
+        nsort::tim_sort(items, count, less, (T*)scratch.m_mutable);
+        return true;
+    }
+
+}; // namespace xcore
+
+#endif // __XBASE_SORT_H__
@@ -953,7 +953,7 @@ namespace xcore
     };
 
 //#define X_NO_PARTIAL_TEMPLATE
-#    define X_CACHE_LINE_SIZE 32
+#    define X_CACHE_LINE_SIZE 64
 #    define X_CHAR_BIT        8
 #    define X_IEEE_FLOATS
 #    define X_USE_PRAGMA_ONCE
@@ -1010,7 +1010,7 @@ namespace xcore
     class __xuint256;
 
 #    define __NO_PARTIAL_TEMPLATE__
-#    define X_CACHE_LINE_SIZE 32
+#    define X_CACHE_LINE_SIZE 64
 #    define X_CHAR_BIT        8
 #    define X_USE_PRAGMA_ONCE
 #    define X_STD_CALL         __stdcall
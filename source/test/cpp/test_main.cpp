@@ -10,23 +10,37 @@ UNITTEST_SUITE_LIST(xCoreUnitTest);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xinteger);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xtypes);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xallocator);
+UNITTEST_SUITE_DECLARE(xCoreUnitTest, art_t);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xbinary_search);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xbitfield);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xbtree);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, buffer_t);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, carray_t);
+UNITTEST_SUITE_DECLARE(xCoreUnitTest, xcrc);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xcontainers);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xdouble);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xdtrie);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xendian);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xfloat);
+UNITTEST_SUITE_DECLARE(xCoreUnitTest, xhash);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, guid_t);
+UNITTEST_SUITE_DECLARE(xCoreUnitTest, heap_t);
+UNITTEST_SUITE_DECLARE(xCoreUnitTest, lru_cache_t);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, hibitset_t);
+UNITTEST_SUITE_DECLARE(xCoreUnitTest, hibitset_atomic_t);
+UNITTEST_SUITE_DECLARE(xCoreUnitTest, intern_table_t);
+UNITTEST_SUITE_DECLARE(xCoreUnitTest, roaring_t);
+UNITTEST_SUITE_DECLARE(xCoreUnitTest, rope_t);
+UNITTEST_SUITE_DECLARE(xCoreUnitTest, lockfree_queue);
+UNITTEST_SUITE_DECLARE(xCoreUnitTest, mphf_t);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xmap_and_set);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xmemory_std);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xqsort);
+UNITTEST_SUITE_DECLARE(xCoreUnitTest, xsort);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xrange);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, singleton_t);
+UNITTEST_SUITE_DECLARE(xCoreUnitTest, slot_map_t);
+UNITTEST_SUITE_DECLARE(xCoreUnitTest, soa_array_t);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xslice);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xsprintf);
 UNITTEST_SUITE_DECLARE(xCoreUnitTest, xsscanf);
@@ -0,0 +1,201 @@
+#include "xbase/x_allocator.h"
+#include "xbase/x_art.h"
+#include "xbase/x_integer.h"
+#include "xbase/x_memory.h"
+#include "xbase/x_runes.h"
+
+#include "xunittest/xunittest.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t* gTestAllocator;
+
+namespace xcore
+{
+    static void* art_value(u32 i) { return (void*)(uptr)(i + 1); }
+
+    // Keys of the form "<prefix><a>/<b>" with 3 to 4 digit numbers, many
+    // share long prefixes and some are a prefix of another key
+    static cbuffer_t art_key(char* dst, const char* prefix, u32 a, u32 b)
+    {
+        char* p = dst;
+        while (*prefix != '\0')
+            *p++ = *prefix++;
+        *p++ = (char)('0' + (a / 100) % 10);
+        *p++ = (char)('0' + (a / 10) % 10);
+        *p++ = (char)('0' + a % 10);
+        if (b > 0)
+        {
+            *p++ = '/';
+            *p++ = (char)('0' + (b / 10) % 10);
+            *p++ = (char)('0' + b % 10);
+        }
+        return cbuffer_t((u32)(p - dst), (xbyte const*)dst);
+    }
+
+    // Byte order as used by the tree (cbuffer_t::compare orders by length first)
+    static bool art_less(cbuffer_t const& a, cbuffer_t const& b)
+    {
+        s32 const c = x_memcmp(a.m_const, b.m_const, xmin(a.m_len, b.m_len));
+        return c < 0 || (c == 0 && a.m_len < b.m_len);
+    }
+}
+
+UNITTEST_SUITE_BEGIN(art_t)
+{
+    UNITTEST_FIXTURE(main)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(insert_find_remove)
+        {
+            art_t tree(gTestAllocator);
+            void* value;
+            CHECK_FALSE(tree.find(crunes_t("a"), value));
+
+            CHECK_TRUE(tree.insert(crunes_t("net.rx"), art_value(1)));
+            CHECK_TRUE(tree.insert(crunes_t("net.tx"), art_value(2)));
+            CHECK_TRUE(tree.insert(crunes_t("net"), art_value(3)));
+            CHECK_TRUE(tree.insert(crunes_t(""), art_value(4)));
+            CHECK_FALSE(tree.insert(crunes_t("net.rx"), art_value(5)));
+            CHECK_EQUAL(4, tree.size());
+
+            CHECK_TRUE(tree.find(crunes_t("net.rx"), value));
+            CHECK_TRUE(value == art_value(5));
+            CHECK_TRUE(tree.find(crunes_t("net"), value));
+            CHECK_TRUE(value == art_value(3));
+            CHECK_TRUE(tree.contains(crunes_t("")));
+            CHECK_FALSE(tree.contains(crunes_t("ne")));
+            CHECK_FALSE(tree.contains(crunes_t("net.")));
+            CHECK_FALSE(tree.contains(crunes_t("net.rxx")));
+
+            CHECK_TRUE(tree.remove(crunes_t("net"), value));
+            CHECK_TRUE(value == art_value(3));
+            CHECK_FALSE(tree.remove(crunes_t("net")));
+            CHECK_TRUE(tree.contains(crunes_t("net.tx")));
+            CHECK_TRUE(tree.remove(crunes_t("net.tx")));
+            CHECK_TRUE(tree.remove(crunes_t("net.rx")));
+            CHECK_TRUE(tree.remove(crunes_t("")));
+            CHECK_TRUE(tree.is_empty());
+        }
+
+        UNITTEST_TEST(long_prefix)
+        {
+            art_t tree(gTestAllocator);
+
+            // Prefixes longer than MAX_PREFIX are split at different depths
+            tree.insert(crunes_t("channel.audio.main.left"), art_value(1));
+            tree.insert(crunes_t("channel.audio.main.right"), art_value(2));
+            tree.insert(crunes_t("channel.audio.side"), art_value(3));
+            tree.insert(crunes_t("channel.video"), art_value(4));
+            tree.insert(crunes_t("channel.audio.main"), art_value(5));
+
+            void* value;
+            CHECK_TRUE(tree.find(crunes_t("channel.audio.main.right"), value));
+            CHECK_TRUE(value == art_value(2));
+            CHECK_TRUE(tree.find(crunes_t("channel.audio.main"), value));
+            CHECK_TRUE(value == art_value(5));
+            CHECK_FALSE(tree.contains(crunes_t("channel.audio.main.lefT")));
+            CHECK_FALSE(tree.contains(crunes_t("channel.audio")));
+
+            CHECK_TRUE(tree.remove(crunes_t("channel.video")));
+            CHECK_TRUE(tree.remove(crunes_t("channel.audio.side")));
+            CHECK_TRUE(tree.find(crunes_t("channel.audio.main.left"), value));
+            CHECK_TRUE(value == art_value(1));
+        }
+
+        UNITTEST_TEST(ordered_and_prefix_iteration)
+        {
+            art_t tree(gTestAllocator);
+            const char* keys[] = {"b", "a/2", "a", "a/10", "c/x", "a/1", "ab"};
+            for (u32 i = 0; i < 7; ++i)
+                tree.insert(crunes_t(keys[i]), art_value(i));
+
+            const char* sorted[] = {"a", "a/1", "a/10", "a/2", "ab", "b", "c/x"};
+            art_t::iter_t iter(tree);
+            cbuffer_t     key;
+            void*         value;
+            u32           n = 0;
+            while (iter.next(key, value))
+            {
+                CHECK_TRUE(key == cbuffer_t(crunes_t(sorted[n])));
+                ++n;
+            }
+            CHECK_EQUAL(7, n);
+
+            const char*   prefixed[] = {"a/1", "a/10", "a/2"};
+            art_t::iter_t piter(tree, crunes_t("a/"));
+            n = 0;
+            while (piter.next(key, value))
+            {
+                CHECK_TRUE(key == cbuffer_t(crunes_t(prefixed[n])));
+                ++n;
+            }
+            CHECK_EQUAL(3, n);
+
+            art_t::iter_t none(tree, crunes_t("a/3"));
+            CHECK_FALSE(none.next(key, value));
+            art_t::iter_t exact(tree, crunes_t("c/x"));
+            CHECK_TRUE(exact.next(key, value));
+            CHECK_FALSE(exact.next(key, value));
+        }
+
+        UNITTEST_TEST(grow_and_shrink)
+        {
+            art_t tree(gTestAllocator);
+            char  name[64];
+
+            // 1000 x 4 keys, the first level grows to node256 and the leaves
+            // below it go through node4, node16 and node48 on the way down
+            for (u32 a = 0; a < 1000; ++a)
+            {
+                for (u32 b = 0; b < 4; ++b)
+                    CHECK_TRUE(tree.insert(art_key(name, "metrics.counter.", a, b * 17), art_value(a * 4 + b)));
+            }
+            CHECK_EQUAL(4000, tree.size());
+
+            // Ascending order, "x" < "x/00" < "x/17" ...
+            art_t::iter_t iter(tree);
+            cbuffer_t     key, prev;
+            void*         value;
+            u32           n = 0;
+            while (iter.next(key, value))
+            {
+                if (n > 0)
+                    CHECK_TRUE(art_less(prev, key));
+                prev = key;
+                ++n;
+            }
+            CHECK_EQUAL(4000, n);
+
+            art_t::iter_t piter(tree, art_key(name, "metrics.counter.", 42, 0));
+            n = 0;
+            while (piter.next(key, value))
+                ++n;
+            CHECK_EQUAL(4, n);
+
+            for (u32 a = 0; a < 1000; a += 2)
+            {
+                for (u32 b = 0; b < 4; ++b)
+                    CHECK_TRUE(tree.remove(art_key(name, "metrics.counter.", a, b * 17)));
+            }
+            CHECK_EQUAL(2000, tree.size());
+
+            for (u32 a = 0; a < 1000; ++a)
+            {
+                for (u32 b = 0; b < 4; ++b)
+                {
+                    bool const found = tree.find(art_key(name, "metrics.counter.", a, b * 17), value);
+                    CHECK_EQUAL((a & 1) == 1, found);
+                    if (found)
+                        CHECK_TRUE(value == art_value(a * 4 + b));
+                }
+            }
+
+            tree.clear();
+            CHECK_TRUE(tree.is_empty());
+        }
+    }
+}
+UNITTEST_SUITE_END
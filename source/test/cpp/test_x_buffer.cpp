@@ -113,6 +113,47 @@ UNITTEST_SUITE_BEGIN(buffer_t)
             reader.view_crunes(viewstr);
             CHECK_TRUE(chars == viewstr);
         }
+
+        UNITTEST_TEST(test_checksum_frames)
+        {
+            xbytes<256>     buffer;
+            binary_writer_t writer = buffer.writer();
+
+            writer.begin_frame();
+            writer.write((u32)0x12345678);
+            writer.write_string(crunes_t("frame one"));
+            CHECK_EQUAL(21, writer.end_frame());
+
+            writer.begin_frame();
+            writer.write((u64)42);
+            CHECK_EQUAL(33, writer.end_frame());
+
+            // The frame is the data followed by its crc32c
+            binary_reader_t reader = buffer.reader();
+            reader.begin_frame();
+            CHECK_EQUAL(0x12345678, reader.read_u32());
+            crunes_t str;
+            reader.view_crunes(str);
+            CHECK_TRUE(str == crunes_t("frame one"));
+            CHECK_TRUE(reader.end_frame());
+
+            reader.begin_frame();
+            CHECK_EQUAL(42, reader.read_u64());
+            CHECK_TRUE(reader.end_frame());
+
+            // A flipped bit in the data fails the frame
+            buffer.m_mutable[27] ^= 0x10;
+            reader.seek(25);
+            reader.begin_frame();
+            reader.read_u64();
+            CHECK_FALSE(reader.end_frame());
+
+            // No room for the checksum
+            binary_writer_t small(buffer.m_mutable, 10);
+            small.begin_frame();
+            small.write((u64)1);
+            CHECK_EQUAL(-1, small.end_frame());
+        }
     }
 }
 UNITTEST_SUITE_END
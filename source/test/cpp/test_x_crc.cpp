@@ -0,0 +1,78 @@
+#include "xbase/x_allocator.h"
+#include "xbase/x_crc.h"
+#include "xbase/x_runes.h"
+
+#include "xunittest/xunittest.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t* gTestAllocator;
+
+namespace xcore
+{
+    // Bit by bit, the definition of the checksum
+    static u32 crc32c_bitwise(xbyte const* data, u32 size)
+    {
+        u32 crc = 0xffffffff;
+        for (u32 i = 0; i < size; ++i)
+        {
+            crc ^= data[i];
+            for (s32 k = 0; k < 8; ++k)
+                crc = (crc & 1) ? (crc >> 1) ^ 0x82f63b78 : crc >> 1;
+        }
+        return ~crc;
+    }
+}
+
+UNITTEST_SUITE_BEGIN(xcrc)
+{
+    UNITTEST_FIXTURE(main)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        // Check values from RFC 3720 (iSCSI)
+        UNITTEST_TEST(check_values)
+        {
+            CHECK_EQUAL(0, crc32c(nullptr, 0));
+            CHECK_EQUAL(0xe3069283, crc32c(cbuffer_t(crunes_t("123456789"))));
+
+            xbyte data[32];
+            for (u32 i = 0; i < 32; ++i)
+                data[i] = 0;
+            CHECK_EQUAL(0x8a9136aa, crc32c(data, 32));
+            for (u32 i = 0; i < 32; ++i)
+                data[i] = 0xff;
+            CHECK_EQUAL(0x62a8ab43, crc32c(data, 32));
+            for (u32 i = 0; i < 32; ++i)
+                data[i] = (xbyte)i;
+            CHECK_EQUAL(0x46dd794e, crc32c(data, 32));
+        }
+
+        // Sizes and offsets that go through the unaligned head, the 3-way
+        // interleaved blocks of 8192 and 256 bytes and the tail
+        UNITTEST_TEST(sizes_and_continuation)
+        {
+            u32 const size = 3 * 8192 * 2 + 3 * 256 + 100;
+            xbyte*    data = (xbyte*)gTestAllocator->allocate(size + 8, sizeof(u64));
+            for (u32 i = 0; i < size + 8; ++i)
+                data[i] = (xbyte)((i * 2654435761u) >> 11);
+
+            u32 const sizes[] = {1, 7, 8, 9, 255, 768, 769, 1000, 24576, 24583, 25000, size};
+            bool      ok      = true;
+            for (u32 s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+            {
+                for (u32 offset = 0; offset < 8; offset += 3)
+                    ok = ok && crc32c(data + offset, sizes[s]) == crc32c_bitwise(data + offset, sizes[s]);
+            }
+            CHECK_TRUE(ok);
+
+            u32 const whole = crc32c(data, size);
+            CHECK_EQUAL(whole, crc32c(data + 30001, size - 30001, crc32c(data, 30001)));
+            CHECK_EQUAL(whole, crc32c(data + 5, size - 5, crc32c(data, 5)));
+
+            gTestAllocator->deallocate(data);
+        }
+    }
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,591 @@
+#ifdef XHASH_SPEED_REPORT
+#    include <chrono>
+#endif
+
+#include "xbase/x_allocator.h"
+#include "xbase/x_buffer.h"
+#include "xbase/x_console.h"
+#include "xbase/x_hash.h"
+#include "xbase/x_jobs.h"
+#include "xbase/x_map.h"
+#include "xbase/x_memory.h"
+
+#include "xunittest/xunittest.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t* gTestAllocator;
+
+namespace xcore
+{
+    static u32 hash_strlen(const char* str)
+    {
+        u32 len = 0;
+        while (str[len] != '\0')
+            ++len;
+        return len;
+    }
+
+    // Every output bit should be set for about half of the keys
+    static bool hash_bits_balanced(u64 const* hashes, u32 count)
+    {
+        for (s32 bit = 0; bit < 64; ++bit)
+        {
+            u32 ones = 0;
+            for (u32 i = 0; i < count; ++i)
+                ones += (u32)((hashes[i] >> bit) & 1);
+            if (ones < (count * 45 / 100) || ones > (count * 55 / 100))
+                return false;
+        }
+        return true;
+    }
+
+    // The btree of map_t/set_t branches on 2 bits per level starting at the
+    // lowest bits, the first 4 levels (256 buckets) should be evenly filled
+    static bool hash_low_bits_uniform(u64 const* hashes, u32 count)
+    {
+        u32 buckets[256];
+        for (s32 i = 0; i < 256; ++i)
+            buckets[i] = 0;
+        for (u32 i = 0; i < count; ++i)
+            buckets[hashes[i] & 0xff] += 1;
+        u32 const expected = count / 256;
+        for (s32 i = 0; i < 256; ++i)
+        {
+            if (buckets[i] < (expected / 2) || buckets[i] > (expected * 2))
+                return false;
+        }
+        return true;
+    }
+}
+
+namespace xcore
+{
+    // Hash quality checks in the spirit of SMHasher, every hash function is
+    // wrapped as a function over keys of @size bytes
+    typedef u64 (*hash_quality_fn)(xbyte const* key, u32 size);
+
+    static u64 hq_calchash(xbyte const* key, u32 size) { return calchash(key, size); }
+
+    static u64 hq_hashing(xbyte const* key, u32 size)
+    {
+        hashing_t h;
+        h.reset();
+        h.hash(key, (s32)size);
+        return h.finalize();
+    }
+
+    template <typename T> static u64 hq_hasher(xbyte const* key, u32)
+    {
+        T k;
+        x_memcpy(&k, key, sizeof(T));
+        return hasher_t<T>().hash(k);
+    }
+
+    // hasher_t<const char*> with the key as hex text
+    static u64 hq_hasher_string(xbyte const* key, u32 size)
+    {
+        char text[2 * 16 + 1];
+        for (u32 i = 0; i < size; ++i)
+        {
+            text[i * 2 + 0] = "0123456789abcdef"[key[i] >> 4];
+            text[i * 2 + 1] = "0123456789abcdef"[key[i] & 15];
+        }
+        text[size * 2] = '\0';
+        return hasher_t<const char*>().hash(text);
+    }
+
+    static u64 hq_random(u64& state)
+    {
+        state += 0x9E3779B97F4A7C15ull;
+        u64 z = state;
+        z     = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z     = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    static void hq_random_key(u64& state, xbyte* key, u32 size)
+    {
+        for (u32 i = 0; i < size; i += 8)
+        {
+            u64 const r = hq_random(state);
+            for (u32 j = i; j < size && j < (i + 8); ++j)
+                key[j] = (xbyte)(r >> ((j - i) * 8));
+        }
+    }
+
+    // Avalanche, flipping an input bit should flip every output bit with a
+    // probability of 0.5. Returns the worst bias |p - 0.5| over all pairs of
+    // input and output bits.
+    static f64 hq_avalanche(hash_quality_fn fn, u32 size, u32 samples)
+    {
+        xbyte key[256];
+        u32   flips[64];
+        u64   state = size;
+        f64   worst = 0.0;
+        for (u32 in = 0; in < size * 8; ++in)
+        {
+            for (s32 out = 0; out < 64; ++out)
+                flips[out] = 0;
+            for (u32 s = 0; s < samples; ++s)
+            {
+                hq_random_key(state, key, size);
+                u64 const h = fn(key, size);
+                key[in / 8] ^= (xbyte)(1 << (in & 7));
+                u64 const d = h ^ fn(key, size);
+                for (s32 out = 0; out < 64; ++out)
+                    flips[out] += (u32)((d >> out) & 1);
+            }
+            for (s32 out = 0; out < 64; ++out)
+            {
+                f64 const p    = (f64)flips[out] / (f64)samples;
+                f64 const bias = p > 0.5 ? p - 0.5 : 0.5 - p;
+                worst          = bias > worst ? bias : worst;
+            }
+        }
+        return worst;
+    }
+
+    // Bit independence, two output bits should flip independently of each
+    // other when an input bit flips, p(both) = 0.25. Returns the worst bias
+    // over 16 input bits and all pairs of output bits.
+    static f64 hq_bit_independence(hash_quality_fn fn, u32 size, u32 samples)
+    {
+        xbyte key[256];
+        u32*  both  = (u32*)gTestAllocator->allocate(64 * 64 * sizeof(u32), sizeof(u32));
+        u64   state = size * 7;
+        f64   worst = 0.0;
+        u32 const step = (size * 8 + 15) / 16;
+        for (u32 in = 0; in < size * 8; in += step)
+        {
+            for (s32 i = 0; i < 64 * 64; ++i)
+                both[i] = 0;
+            for (u32 s = 0; s < samples; ++s)
+            {
+                hq_random_key(state, key, size);
+                u64 const h = fn(key, size);
+                key[in / 8] ^= (xbyte)(1 << (in & 7));
+                u64 const d = h ^ fn(key, size);
+                for (s32 j = 0; j < 64; ++j)
+                {
+                    if (((d >> j) & 1) == 0)
+                        continue;
+                    for (s32 k = j + 1; k < 64; ++k)
+                        both[j * 64 + k] += (u32)((d >> k) & 1);
+                }
+            }
+            for (s32 j = 0; j < 64; ++j)
+            {
+                for (s32 k = j + 1; k < 64; ++k)
+                {
+                    f64 const p    = (f64)both[j * 64 + k] / (f64)samples;
+                    f64 const bias = p > 0.25 ? p - 0.25 : 0.25 - p;
+                    worst          = bias > worst ? bias : worst;
+                }
+            }
+        }
+        gTestAllocator->deallocate(both);
+        return worst;
+    }
+
+    // Bucket distribution, structured keys (a counter shifted left by
+    // @shift bits) spread over as many buckets as there are keys, with the
+    // bucket taken from the hash bits starting at @bit. Returns the largest
+    // bucket, which stays below 10 for a random function.
+    //
+    // The btree of map_t/set_t consumes the hash 2 bits at a time from the
+    // low end, so a large bucket at bit 0 means a deep trie.
+    static u32 hq_max_bucket(hash_quality_fn fn, u32 size, u32 shift, s32 bit)
+    {
+        u32 const key_bits = (size * 8 - shift) < 16 ? (size * 8 - shift) : 16;
+        u32 const count    = 1 << key_bits;
+        u32*      buckets  = (u32*)gTestAllocator->allocate(count * sizeof(u32), sizeof(u32));
+        for (u32 i = 0; i < count; ++i)
+            buckets[i] = 0;
+
+        xbyte key[256];
+        u32   largest = 0;
+        for (u32 i = 0; i < count; ++i)
+        {
+            for (u32 b = 0; b < size; ++b)
+                key[b] = 0;
+            for (u32 b = 0; b < key_bits; ++b)
+            {
+                if (((i >> b) & 1) != 0)
+                    key[(shift + b) / 8] |= (xbyte)(1 << ((shift + b) & 7));
+            }
+            u32 const bucket = (u32)(fn(key, size) >> bit) & (count - 1);
+            buckets[bucket] += 1;
+            largest = buckets[bucket] > largest ? buckets[bucket] : largest;
+        }
+        gTestAllocator->deallocate(buckets);
+        return largest;
+    }
+
+    struct hash_quality_case_t
+    {
+        const char*     m_name;
+        hash_quality_fn m_fn;
+        u32             m_size;
+    };
+
+    static const hash_quality_case_t sHashQualityCases[] = {
+      {"calchash/4", hq_calchash, 4},
+      {"calchash/8", hq_calchash, 8},
+      {"calchash/16", hq_calchash, 16},
+      {"calchash/32", hq_calchash, 32},
+      {"calchash/200", hq_calchash, 200},
+      {"hashing_t/8", hq_hashing, 8},
+      {"hashing_t/32", hq_hashing, 32},
+      {"hasher_t<u8>", hq_hasher<u8>, 1},
+      {"hasher_t<s8>", hq_hasher<s8>, 1},
+      {"hasher_t<u16>", hq_hasher<u16>, 2},
+      {"hasher_t<s16>", hq_hasher<s16>, 2},
+      {"hasher_t<u32>", hq_hasher<u32>, 4},
+      {"hasher_t<s32>", hq_hasher<s32>, 4},
+      {"hasher_t<u64>", hq_hasher<u64>, 8},
+      {"hasher_t<s64>", hq_hasher<s64>, 8},
+      {"hasher_t<f32>", hq_hasher<f32>, 4},
+      {"hasher_t<f64>", hq_hasher<f64>, 8},
+      {"hasher_t<void*>", hq_hasher<void*>, sizeof(void*)},
+      {"hasher_t<const char*>", hq_hasher_string, 8},
+    };
+
+    // Key sizes of one byte have 128 distinct pairs per input bit, the
+    // measured bias is noisier
+    static f64 hq_max_bias(u32 size) { return size == 1 ? 0.2 : 0.1; }
+
+    // The CHECK in the loop over the cases does not tell which one failed
+    static bool hq_report(hash_quality_case_t const& q, const char* test, f64 value, bool ok)
+    {
+        if (!ok)
+            console->writeLine("hash quality: %s failed %s with %f", va_list_t(va_t(q.m_name), va_t(test), va_t(value)));
+        return ok;
+    }
+
+#ifdef XHASH_SPEED_REPORT
+    static f64 hq_seconds(std::chrono::steady_clock::time_point start) { return std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count(); }
+#endif
+
+}
+
+namespace xcore
+{
+    // Executes the tasks in a different order than the calling thread would,
+    // like @m_threads threads that each take every n-th task
+    class hash_test_jobs_t : public jobs_t
+    {
+    public:
+        inline hash_test_jobs_t(u32 threads) : m_threads(threads), m_runs(0) {}
+
+        u32 m_threads;
+        u32 m_runs;
+
+    protected:
+        virtual u32  v_concurrency() const { return m_threads; }
+        virtual void v_run(job_t* job, u32 count)
+        {
+            m_runs += 1;
+            for (u32 t = m_threads; t > 0; --t)
+            {
+                for (u32 i = t - 1; i < count; i += m_threads)
+                    job->execute(i);
+            }
+        }
+    };
+}
+
+namespace xcore
+{
+    // A hasher without a batch hook
+    class hash_test_hasher_t
+    {
+    public:
+        u64 hash(u32 const& k) const { return k * 3; }
+    };
+}
+
+static_assert(mixhash(0) == 0, "mixhash should be usable in constant expressions");
+
+UNITTEST_SUITE_BEGIN(xhash)
+{
+    UNITTEST_FIXTURE(main)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        // Reference values are from the xxHash library (v0.8.2)
+        UNITTEST_TEST(xxhash64)
+        {
+            const char* fox = "The quick brown fox jumps over the lazy dog";
+            CHECK_EQUAL(0xef46db3751d8e999ull, xxhash64(nullptr, 0));
+            CHECK_EQUAL(0x44bc2cf5ad770999ull, xxhash64((xbyte const*)"abc", 3));
+            CHECK_EQUAL(0x0b242d361fda71bcull, xxhash64((xbyte const*)fox, hash_strlen(fox)));
+            CHECK_EQUAL(0x5b3c21fecfc907fdull, xxhash64((xbyte const*)fox, hash_strlen(fox), 1234));
+        }
+
+        UNITTEST_TEST(xxhash3_64)
+        {
+            const char* fox = "The quick brown fox jumps over the lazy dog";
+            CHECK_EQUAL(0x2d06800538d394c2ull, xxhash3_64(nullptr, 0));
+            CHECK_EQUAL(0x78af5f94892f3950ull, xxhash3_64((xbyte const*)"abc", 3));
+            CHECK_EQUAL(0x160d8e9329be94f9ull, xxhash3_64((xbyte const*)"message digest", 14));
+            CHECK_EQUAL(0xce7d19a5418fb365ull, xxhash3_64((xbyte const*)fox, hash_strlen(fox)));
+            CHECK_EQUAL(0x2c5cdf3b3b0b029cull, xxhash3_64((xbyte const*)fox, hash_strlen(fox), 1234));
+            CHECK_EQUAL(xxhash3_64((xbyte const*)fox, hash_strlen(fox)), calchash((xbyte const*)fox, hash_strlen(fox)));
+        }
+
+        UNITTEST_TEST(xxhash3_128)
+        {
+            const char* fox = "The quick brown fox jumps over the lazy dog";
+            hash128_t   h   = xxhash3_128((xbyte const*)"abc", 3);
+            CHECK_EQUAL(0x78af5f94892f3950ull, h.m_low);
+            CHECK_EQUAL(0x06b05ab6733a6185ull, h.m_high);
+            h = xxhash3_128((xbyte const*)fox, hash_strlen(fox));
+            CHECK_EQUAL(0x24a1cc2e3a8a7651ull, h.m_low);
+            CHECK_EQUAL(0xddd650205ca3e7faull, h.m_high);
+        }
+
+        // 1000 bytes go through the stripe accumulate kernel
+        UNITTEST_TEST(long_input)
+        {
+            xbyte data[1000];
+            for (u32 i = 0; i < 1000; ++i)
+                data[i] = (xbyte)(i * 31 + 7);
+
+            CHECK_EQUAL(0x99594f4828043d35ull, xxhash64(data, 1000));
+            CHECK_EQUAL(0x989765d0ea7a5ecdull, xxhash3_64(data, 1000));
+            CHECK_EQUAL(0x789764f28d04417dull, xxhash3_64(data, 1000, 1234));
+            hash128_t const h = xxhash3_128(data, 1000, 1234);
+            CHECK_EQUAL(0x789764f28d04417dull, h.m_low);
+            CHECK_EQUAL(0x450e7505f3e1b6e5ull, h.m_high);
+        }
+
+        UNITTEST_TEST(integer_keys_dispersion)
+        {
+            u32 const count  = 65536;
+            u64*      hashes = (u64*)gTestAllocator->allocate(count * sizeof(u64), sizeof(u64));
+
+            // Sequential integers
+            hasher_t<u32> h32;
+            for (u32 i = 0; i < count; ++i)
+                hashes[i] = h32.hash(i);
+            CHECK_TRUE(hash_bits_balanced(hashes, count));
+            CHECK_TRUE(hash_low_bits_uniform(hashes, count));
+
+            // Pointers, aligned and with a common high part
+            hasher_t<void*> hptr;
+            for (u32 i = 0; i < count; ++i)
+                hashes[i] = hptr.hash((void*)(uptr)(0x7f0000000000ull + (u64)i * 64));
+            CHECK_TRUE(hash_bits_balanced(hashes, count));
+            CHECK_TRUE(hash_low_bits_uniform(hashes, count));
+
+            // Keys that only differ in their high bits
+            hasher_t<u64> h64;
+            for (u32 i = 0; i < count; ++i)
+                hashes[i] = h64.hash((u64)i << 40);
+            CHECK_TRUE(hash_bits_balanced(hashes, count));
+            CHECK_TRUE(hash_low_bits_uniform(hashes, count));
+
+            gTestAllocator->deallocate(hashes);
+        }
+
+        UNITTEST_TEST(integer_keys_map)
+        {
+            map_t<s32, s32> map(gTestAllocator);
+            for (s32 i = -1000; i < 1000; ++i)
+                CHECK_TRUE(map.insert(i * 4096, i));
+            for (s32 i = -1000; i < 1000; ++i)
+            {
+                s32 v = 0;
+                CHECK_TRUE(map.find(i * 4096, v));
+                CHECK_EQUAL(i, v);
+            }
+            s32 v = 0;
+            CHECK_FALSE(map.find(4095, v));
+            for (s32 i = -1000; i < 1000; ++i)
+                CHECK_TRUE(map.remove(i * 4096, v));
+
+            hasher_t<f32> hf;
+            CHECK_EQUAL(hf.hash(0.0f), hf.hash(-0.0f));
+            CHECK_NOT_EQUAL(hf.hash(1.0f), hf.hash(-1.0f));
+        }
+
+        UNITTEST_TEST(calchash_parallel)
+        {
+            u32 const size = 3 * HASH_CHUNK_SIZE + 12345;
+            xbyte*    data = (xbyte*)gTestAllocator->allocate(size, sizeof(u64));
+            for (u32 i = 0; i < size; ++i)
+                data[i] = (xbyte)((i * 2654435761u) >> 13);
+
+            u64 const serial = calchash_parallel(cbuffer_t(size, data), nullptr, gTestAllocator);
+            for (u32 threads = 1; threads <= 5; ++threads)
+            {
+                hash_test_jobs_t jobs(threads);
+                CHECK_EQUAL(serial, calchash_parallel(cbuffer_t(size, data), &jobs, gTestAllocator));
+                CHECK_EQUAL(1, jobs.m_runs);
+            }
+
+            // Different length or content give a different hash
+            CHECK_NOT_EQUAL(serial, calchash_parallel(cbuffer_t(size - 1, data), nullptr, gTestAllocator));
+            data[2 * HASH_CHUNK_SIZE + 7] ^= 1;
+            CHECK_NOT_EQUAL(serial, calchash_parallel(cbuffer_t(size, data), nullptr, gTestAllocator));
+
+            // Up to one chunk it is calchash
+            hash_test_jobs_t jobs(4);
+            CHECK_EQUAL(calchash(data, HASH_CHUNK_SIZE), calchash_parallel(cbuffer_t(HASH_CHUNK_SIZE, data), &jobs));
+            CHECK_EQUAL(0, jobs.m_runs);
+
+            gTestAllocator->deallocate(data);
+        }
+
+        UNITTEST_TEST(calchash_batch)
+        {
+            // 37 keys, the vector loops and the scalar tail
+            u32   keys32[37];
+            u64   keys64[37];
+            xbyte bytes[37 * 20];
+            u64   hashes[37];
+            for (u32 i = 0; i < 37; ++i)
+            {
+                keys32[i] = i * 0x9E3779B1u;
+                keys64[i] = (u64)i * 0x9E3779B97F4A7C15ull;
+            }
+            for (u32 i = 0; i < 37 * 20; ++i)
+                bytes[i] = (xbyte)(i * 7 + 1);
+
+            bool ok = true;
+            calchash_batch(keys32, hashes, 37);
+            for (u32 i = 0; i < 37; ++i)
+                ok = ok && hashes[i] == hasher_t<u32>().hash(keys32[i]);
+            calchash_batch(keys64, hashes, 37);
+            for (u32 i = 0; i < 37; ++i)
+                ok = ok && hashes[i] == hasher_t<u64>().hash(keys64[i]);
+            CHECK_TRUE(ok);
+
+            for (u32 key_size = 0; key_size <= 20; ++key_size)
+            {
+                calchash_batch(bytes, key_size, hashes, 37);
+                for (u32 i = 0; i < 37; ++i)
+                    ok = ok && hashes[i] == calchash(bytes + i * key_size, key_size);
+            }
+            CHECK_TRUE(ok);
+
+            // Through the batch hook, and without one
+            s32 skeys[37];
+            for (u32 i = 0; i < 37; ++i)
+                skeys[i] = (s32)i - 18;
+            hash_batch(hasher_t<s32>(), skeys, hashes, 37);
+            for (u32 i = 0; i < 37; ++i)
+                ok = ok && hashes[i] == hasher_t<s32>().hash(skeys[i]);
+            hash_batch(hash_test_hasher_t(), keys32, hashes, 37);
+            for (u32 i = 0; i < 37; ++i)
+                ok = ok && hashes[i] == (u64)(keys32[i] * 3);
+            CHECK_TRUE(ok);
+        }
+    }
+
+    UNITTEST_FIXTURE(quality)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(avalanche)
+        {
+            for (u32 c = 0; c < sizeof(sHashQualityCases) / sizeof(sHashQualityCases[0]); ++c)
+            {
+                hash_quality_case_t const& q = sHashQualityCases[c];
+                f64 const                  bias = hq_avalanche(q.m_fn, q.m_size, 1000);
+                CHECK_TRUE(hq_report(q, "avalanche", bias, bias < hq_max_bias(q.m_size)));
+            }
+        }
+
+        UNITTEST_TEST(bit_independence)
+        {
+            for (u32 c = 0; c < sizeof(sHashQualityCases) / sizeof(sHashQualityCases[0]); ++c)
+            {
+                hash_quality_case_t const& q = sHashQualityCases[c];
+                f64 const                  bias = hq_bit_independence(q.m_fn, q.m_size, 1000);
+                CHECK_TRUE(hq_report(q, "bit independence", bias, bias < hq_max_bias(q.m_size)));
+            }
+        }
+
+        UNITTEST_TEST(bucket_distribution)
+        {
+            // Sequential keys, keys with 6 zero low bits (aligned pointers,
+            // strided indices) and keys that only differ in their high bits,
+            // bucketed on 4 windows of the hash starting at the lowest bit
+            for (u32 c = 0; c < sizeof(sHashQualityCases) / sizeof(sHashQualityCases[0]); ++c)
+            {
+                hash_quality_case_t const& q        = sHashQualityCases[c];
+                u32 const                  key_bits = q.m_size * 8;
+                u32 const                  shifts[] = {0, 6, key_bits > 16 ? key_bits - 16 : 0};
+                for (u32 s = 0; s < 3; ++s)
+                {
+                    if (shifts[s] > 0 && (key_bits - shifts[s]) < 16)
+                        continue;
+                    for (s32 bit = 0; bit < 64; bit += 16)
+                    {
+                        u32 const max = hq_max_bucket(q.m_fn, q.m_size, shifts[s], bit);
+                        CHECK_TRUE(hq_report(q, "bucket distribution", (f64)max, max <= 12));
+                    }
+                }
+            }
+        }
+    }
+
+#ifdef XHASH_SPEED_REPORT
+    // A timing report, not a check, build the tests with XHASH_SPEED_REPORT
+    // defined to run it
+    UNITTEST_FIXTURE(speed)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(speed)
+        {
+            // Throughput on a 1 MB buffer and the latency of one small key where
+            // every key depends on the hash of the previous one
+            u32 const size = 1024 * 1024;
+            xbyte*    data = (xbyte*)gTestAllocator->allocate(size, sizeof(u64));
+            u64       seed = 1;
+            for (u32 i = 0; i < size; ++i)
+                data[i] = (xbyte)hq_random(seed);
+
+            u32 const rounds = 64;
+            u64       sum    = 0;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (u32 r = 0; r < rounds; ++r)
+                sum += calchash(data, size);
+            f64 const calchash_gbs = (f64)rounds * size / hq_seconds(start) / 1e9;
+
+            start = std::chrono::steady_clock::now();
+            for (u32 r = 0; r < rounds; ++r)
+                sum += hq_hashing(data, size);
+            f64 const hashing_gbs = (f64)rounds * size / hq_seconds(start) / 1e9;
+            console->writeLine("hash speed: calchash %f GB/s, hashing_t %f GB/s", va_list_t(va_t(calchash_gbs), va_t(hashing_gbs)));
+
+            u32 const keys = 100000;
+            for (u32 c = 0; c < sizeof(sHashQualityCases) / sizeof(sHashQualityCases[0]); ++c)
+            {
+                hash_quality_case_t const& q = sHashQualityCases[c];
+                xbyte                      key[256];
+                x_memcpy(key, data, q.m_size);
+                start = std::chrono::steady_clock::now();
+                for (u32 i = 0; i < keys; ++i)
+                {
+                    u64 const h = q.m_fn(key, q.m_size);
+                    x_memcpy(key, &h, xmin(q.m_size, (u32)sizeof(h)));
+                    sum += h;
+                }
+                f64 const ns = hq_seconds(start) * 1e9 / keys;
+                console->writeLine("hash latency: %s %f ns", va_list_t(va_t(q.m_name), va_t(ns)));
+            }
+            CHECK_NOT_EQUAL(0, sum);
+
+            gTestAllocator->deallocate(data);
+        }
+    }
+#endif
+}
+UNITTEST_SUITE_END
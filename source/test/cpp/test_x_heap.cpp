@@ -0,0 +1,116 @@
+#include "xbase/x_allocator.h"
+#include "xbase/x_heap.h"
+
+#include "xunittest/xunittest.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t* gTestAllocator;
+
+namespace xcore
+{
+    struct heap_greater_s32
+    {
+        inline bool operator()(s32 a, s32 b) const { return a > b; }
+    };
+}
+
+UNITTEST_SUITE_BEGIN(heap_t)
+{
+    UNITTEST_FIXTURE(main)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(push_pop_sorted)
+        {
+            heap_t<s32> heap(gTestAllocator);
+            CHECK_TRUE(heap.is_empty());
+
+            u32 r = 0x1234;
+            for (s32 i = 0; i < 1000; ++i)
+            {
+                r = r * 1664525 + 1013904223;
+                heap.push((s32)(r >> 8) & 0xffff);
+            }
+            CHECK_EQUAL(1000, heap.size());
+
+            s32 prev = -1;
+            s32 item;
+            while (heap.pop(item))
+            {
+                CHECK_TRUE(prev <= item);
+                prev = item;
+            }
+            CHECK_TRUE(heap.is_empty());
+            CHECK_FALSE(heap.pop(item));
+        }
+
+        UNITTEST_TEST(max_heap_8ary)
+        {
+            heap_t<s32, heap_greater_s32, 8> heap(gTestAllocator);
+            for (s32 i = 0; i < 100; ++i)
+                heap.push((i * 37) % 100);
+            CHECK_EQUAL(99, heap.top());
+
+            s32 item;
+            for (s32 i = 99; i >= 0; --i)
+            {
+                CHECK_TRUE(heap.pop(item));
+                CHECK_EQUAL(i, item);
+            }
+        }
+
+        UNITTEST_TEST(decrease_key)
+        {
+            heap_t<s32> heap(gTestAllocator);
+            handle_t handles[64];
+            for (s32 i = 0; i < 64; ++i)
+                handles[i] = heap.push(1000 + i);
+
+            CHECK_EQUAL(1000, heap.top());
+            heap.decrease(handles[40], 5);
+            CHECK_EQUAL(5, heap.top());
+            CHECK_TRUE(heap.top_handle() == handles[40]);
+            CHECK_EQUAL(5, heap.get(handles[40]));
+
+            heap.update(handles[40], 2000);
+            CHECK_EQUAL(1000, heap.top());
+            heap.update(handles[63], 1);
+            CHECK_EQUAL(1, heap.top());
+            CHECK_TRUE(heap.top_handle() == handles[63]);
+        }
+
+        UNITTEST_TEST(remove_by_handle)
+        {
+            heap_t<s32> heap(gTestAllocator);
+            handle_t handles[100];
+            for (s32 i = 0; i < 100; ++i)
+                handles[i] = heap.push(i);
+
+            s32 item;
+            for (s32 i = 0; i < 100; i += 2)
+            {
+                CHECK_TRUE(heap.remove(handles[i], item));
+                CHECK_EQUAL(i, item);
+                CHECK_FALSE(heap.contains(handles[i]));
+            }
+            CHECK_FALSE(heap.remove(handles[0], item));
+            CHECK_EQUAL(50, heap.size());
+
+            for (s32 i = 1; i < 100; i += 2)
+            {
+                CHECK_TRUE(heap.pop(item));
+                CHECK_EQUAL(i, item);
+            }
+
+            // Handles are recycled
+            handle_t h = heap.push(7);
+            CHECK_TRUE(heap.contains(h));
+            heap.clear();
+            CHECK_FALSE(heap.contains(h));
+            CHECK_TRUE(heap.is_empty());
+        }
+    }
+}
+UNITTEST_SUITE_END
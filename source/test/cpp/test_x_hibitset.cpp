@@ -1,9 +1,12 @@
+#include "xbase/x_allocator.h"
 #include "xbase/x_hibitset.h"
 #include "xbase/x_memory.h"
 #include "xunittest/xunittest.h"
 
 using namespace xcore;
 
+extern xcore::alloc_t* gTestAllocator;
+
 UNITTEST_SUITE_BEGIN(hibitset_t)
 {
 	UNITTEST_FIXTURE(main)
@@ -94,5 +97,204 @@ UNITTEST_SUITE_BEGIN(hibitset_t)
 		}
 
 	}
+
+	UNITTEST_FIXTURE(hibitset64)
+	{
+		UNITTEST_FIXTURE_SETUP() {}
+		UNITTEST_FIXTURE_TEARDOWN() {}
+
+		UNITTEST_TEST(size_in_qwords)
+		{
+			CHECK_EQUAL(1, hibitset64_t::size_in_qwords(64));
+			CHECK_EQUAL(2 + 1, hibitset64_t::size_in_qwords(128));
+			CHECK_EQUAL(64 + 1, hibitset64_t::size_in_qwords(4096));
+			CHECK_EQUAL(4096 + 64 + 1, hibitset64_t::size_in_qwords(64 * 4096));
+		}
+
+		UNITTEST_TEST(set_clr_find)
+		{
+			hibitset64_t bset;
+			bset.init(gTestAllocator, 300000);
+			CHECK_TRUE(bset.is_empty());
+
+			u32 bit;
+			CHECK_FALSE(bset.find(bit));
+
+			bset.set(299999);
+			CHECK_TRUE(bset.is_set(299999));
+			CHECK_TRUE(bset.find(bit));
+			CHECK_EQUAL(299999, bit);
+
+			bset.set(70000);
+			CHECK_TRUE(bset.find(bit));
+			CHECK_EQUAL(70000, bit);
+
+			bset.clr(70000);
+			CHECK_TRUE(bset.find(bit));
+			CHECK_EQUAL(299999, bit);
+			bset.clr(299999);
+			CHECK_FALSE(bset.find(bit));
+			CHECK_TRUE(bset.is_empty());
+
+			bset.release(gTestAllocator);
+		}
+
+		UNITTEST_TEST(upper_lower)
+		{
+			hibitset64_t bset;
+			bset.init(gTestAllocator, 100000);
+
+			u32 const bits[] = {3, 64, 65, 4095, 4096, 50000, 99999};
+			for (s32 i = 0; i < 7; ++i)
+				bset.set(bits[i]);
+
+			u32 bit;
+			CHECK_TRUE(bset.upper(0, bit));
+			CHECK_EQUAL(3, bit);
+			CHECK_TRUE(bset.upper(3, bit));
+			CHECK_EQUAL(3, bit);
+			CHECK_TRUE(bset.upper(4, bit));
+			CHECK_EQUAL(64, bit);
+			CHECK_TRUE(bset.upper(66, bit));
+			CHECK_EQUAL(4095, bit);
+			CHECK_TRUE(bset.upper(4097, bit));
+			CHECK_EQUAL(50000, bit);
+			CHECK_TRUE(bset.upper(50001, bit));
+			CHECK_EQUAL(99999, bit);
+
+			CHECK_TRUE(bset.lower(99999, bit));
+			CHECK_EQUAL(99999, bit);
+			CHECK_TRUE(bset.lower(99998, bit));
+			CHECK_EQUAL(50000, bit);
+			CHECK_TRUE(bset.lower(4095, bit));
+			CHECK_EQUAL(4095, bit);
+			CHECK_TRUE(bset.lower(63, bit));
+			CHECK_EQUAL(3, bit);
+			CHECK_FALSE(bset.lower(2, bit));
+
+			bset.clr(99999);
+			CHECK_FALSE(bset.upper(50001, bit));
+
+			bset.release(gTestAllocator);
+		}
+
+		UNITTEST_TEST(set_range_clr_range)
+		{
+			hibitset64_t bset;
+			bset.init(gTestAllocator, 1 << 20);
+
+			bset.set_range(100, 300000);
+			u32 bit;
+			CHECK_TRUE(bset.find(bit));
+			CHECK_EQUAL(100, bit);
+			CHECK_FALSE(bset.is_set(99));
+			CHECK_TRUE(bset.is_set(299999));
+			CHECK_FALSE(bset.is_set(300000));
+			CHECK_TRUE(bset.lower(1 << 19, bit));
+			CHECK_EQUAL(299999, bit);
+
+			bset.clr_range(100, 299990);
+			CHECK_TRUE(bset.find(bit));
+			CHECK_EQUAL(299990, bit);
+
+			bset.clr_range(299990, 300000);
+			CHECK_FALSE(bset.find(bit));
+			CHECK_TRUE(bset.is_empty());
+
+			bset.set_range(5, 6);
+			CHECK_TRUE(bset.find(bit));
+			CHECK_EQUAL(5, bit);
+
+			bset.release(gTestAllocator);
+		}
+
+		UNITTEST_TEST(iterate)
+		{
+			hibitset64_t bset;
+			bset.init(gTestAllocator, 1 << 18);
+
+			for (u32 b = 7; b < (1 << 18); b += 1001)
+				bset.set(b);
+
+			hibitset64_t::iter_t iter(bset);
+			u32 expect = 7;
+			u32 count  = 0;
+			u32 bit;
+			while (iter.next(bit))
+			{
+				CHECK_EQUAL(expect, bit);
+				expect += 1001;
+				count += 1;
+			}
+			CHECK_EQUAL(((1 << 18) - 7 + 1000) / 1001, count);
+
+			bset.release(gTestAllocator);
+		}
+	}
+	UNITTEST_FIXTURE(hibitset_rank)
+	{
+		UNITTEST_FIXTURE_SETUP() {}
+		UNITTEST_FIXTURE_TEARDOWN() {}
+
+		UNITTEST_TEST(empty)
+		{
+			hibitset_t bset;
+			bset.init(gTestAllocator, 1000);
+			hibitset_rank_t index;
+			index.init(gTestAllocator, bset);
+
+			u32 bit;
+			CHECK_EQUAL(0, index.count());
+			CHECK_EQUAL(0, index.rank(500));
+			CHECK_EQUAL(0, index.rank(1000));
+			CHECK_FALSE(index.select(0, bit));
+
+			index.release(gTestAllocator);
+			bset.release(gTestAllocator);
+		}
+
+		UNITTEST_TEST(rank_select)
+		{
+			u32 const numbits = 200000;
+			hibitset_t bset;
+			bset.init(gTestAllocator, numbits);
+
+			// Dense and sparse regions
+			for (u32 b = 0; b < 3000; ++b)
+				bset.set(b);
+			for (u32 b = 3000; b < numbits; b += 97)
+				bset.set(b);
+			bset.set(numbits - 1);
+
+			hibitset_rank_t index;
+			index.init(gTestAllocator, bset);
+
+			u32 r = 0;
+			u32 bit;
+			for (u32 b = 0; b < numbits; ++b)
+			{
+				CHECK_EQUAL(r, index.rank(b));
+				if (bset.is_set(b))
+				{
+					CHECK_TRUE(index.select(r, bit));
+					CHECK_EQUAL(b, bit);
+					r += 1;
+				}
+			}
+			CHECK_EQUAL(r, index.count());
+			CHECK_EQUAL(r, index.rank(numbits));
+			CHECK_FALSE(index.select(r, bit));
+
+			// The index is a snapshot, rebuild after modification
+			bset.clr(0);
+			index.build();
+			CHECK_EQUAL(r - 1, index.count());
+			CHECK_TRUE(index.select(0, bit));
+			CHECK_EQUAL(1, bit);
+
+			index.release(gTestAllocator);
+			bset.release(gTestAllocator);
+		}
+	}
 }
 UNITTEST_SUITE_END
@@ -0,0 +1,199 @@
+#include <thread>
+
+#include "xbase/x_allocator.h"
+#include "xbase/x_hibitset_atomic.h"
+
+#include "xunittest/xunittest.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t* gTestAllocator;
+
+namespace
+{
+    struct hibitset_atomic_worker_t
+    {
+        hibitset_atomic_t* m_bitset;
+        u32*               m_owned; // the bits this thread claimed
+        u32                m_count;
+        u32                m_rounds;
+        u32                m_failed; // clr of an owned bit that was not set
+    };
+
+    // Claim bits until the bitset is full
+    void hibitset_atomic_claim(hibitset_atomic_worker_t* w)
+    {
+        u32 bit;
+        w->m_count = 0;
+        while (w->m_bitset->find_and_set(bit))
+            w->m_owned[w->m_count++] = bit;
+    }
+
+    // Free one of the owned bits and claim a bit again, find_and_set can see the
+    // bitset as full while another thread is still in clr() so it is retried
+    void hibitset_atomic_churn(hibitset_atomic_worker_t* w)
+    {
+        u32 r = 0x9E3779B9 ^ w->m_count;
+        for (u32 i = 0; i < w->m_rounds; ++i)
+        {
+            r ^= r << 13;
+            r ^= r >> 17;
+            r ^= r << 5;
+            u32 const index = r % w->m_count;
+            if (!w->m_bitset->clr(w->m_owned[index]))
+                w->m_failed += 1;
+            u32 bit;
+            while (!w->m_bitset->find_and_set(bit))
+                std::this_thread::yield();
+            w->m_owned[index] = bit;
+        }
+    }
+} // namespace
+
+UNITTEST_SUITE_BEGIN(hibitset_atomic_t)
+{
+    UNITTEST_FIXTURE(main)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(set_clr)
+        {
+            hibitset_atomic_t bitset;
+            bitset.init(gTestAllocator, 1000);
+
+            CHECK_FALSE(bitset.is_set(10));
+            CHECK_TRUE(bitset.set(10));
+            CHECK_FALSE(bitset.set(10));
+            CHECK_TRUE(bitset.is_set(10));
+            CHECK_TRUE(bitset.clr(10));
+            CHECK_FALSE(bitset.clr(10));
+            CHECK_FALSE(bitset.is_set(10));
+
+            bitset.release(gTestAllocator);
+        }
+
+        UNITTEST_TEST(find_and_set_until_full)
+        {
+            hibitset_atomic_t bitset;
+            bitset.init(gTestAllocator, 5000);
+
+            u32 bit;
+            for (u32 i = 0; i < 5000; ++i)
+            {
+                CHECK_TRUE(bitset.find_and_set(bit));
+                CHECK_EQUAL(i, bit);
+            }
+            CHECK_TRUE(bitset.is_full());
+            CHECK_FALSE(bitset.find_and_set(bit));
+
+            // Freed bits are handed out again
+            CHECK_TRUE(bitset.clr(4097));
+            CHECK_TRUE(bitset.clr(63));
+            CHECK_FALSE(bitset.is_full());
+            CHECK_TRUE(bitset.find_and_set(bit));
+            CHECK_EQUAL(63, bit);
+            CHECK_TRUE(bitset.find_and_set(bit));
+            CHECK_EQUAL(4097, bit);
+            CHECK_FALSE(bitset.find_and_set(bit));
+
+            bitset.reset();
+            CHECK_FALSE(bitset.is_full());
+            CHECK_TRUE(bitset.find_and_set(bit));
+            CHECK_EQUAL(0, bit);
+
+            bitset.release(gTestAllocator);
+        }
+
+        UNITTEST_TEST(threads)
+        {
+            // 4 threads claim bits until the bitset is full, then they free and
+            // claim bits concurrently, which races set/clr on the same words and
+            // the repair of the summary bits
+            u32 const         numbits = 64 * 64 * 3 + 100;
+            u32 const         threads = 4;
+            hibitset_atomic_t bitset;
+            bitset.init(gTestAllocator, numbits);
+
+            hibitset_atomic_worker_t workers[threads];
+            std::thread              t[threads];
+            u8*                      owner = (u8*)gTestAllocator->allocate(numbits, sizeof(u32));
+            for (u32 i = 0; i < threads; ++i)
+            {
+                workers[i].m_bitset = &bitset;
+                workers[i].m_owned  = (u32*)gTestAllocator->allocate(numbits * sizeof(u32), sizeof(u32));
+                workers[i].m_count  = 0;
+                workers[i].m_rounds = 20000;
+                workers[i].m_failed = 0;
+            }
+
+            for (s32 phase = 0; phase < 2; ++phase)
+            {
+                for (u32 i = 0; i < threads; ++i)
+                    t[i] = std::thread(phase == 0 ? hibitset_atomic_claim : hibitset_atomic_churn, &workers[i]);
+                for (u32 i = 0; i < threads; ++i)
+                    t[i].join();
+
+                // Every bit is owned by exactly one thread
+                for (u32 b = 0; b < numbits; ++b)
+                    owner[b] = 0;
+                u32 total = 0;
+                for (u32 i = 0; i < threads; ++i)
+                {
+                    for (u32 j = 0; j < workers[i].m_count; ++j)
+                        owner[workers[i].m_owned[j]] += 1;
+                    total += workers[i].m_count;
+                    CHECK_EQUAL(0, workers[i].m_failed);
+                }
+                bool once = true;
+                for (u32 b = 0; b < numbits; ++b)
+                    once = once && owner[b] == 1;
+                CHECK_EQUAL(numbits, total);
+                CHECK_TRUE(once);
+                CHECK_TRUE(bitset.is_full());
+
+                // Deal the bits out evenly, one thread may have claimed most of them
+                for (u32 i = 0; i < threads; ++i)
+                    workers[i].m_count = 0;
+                for (u32 b = 0; b < numbits; ++b)
+                {
+                    hibitset_atomic_worker_t& w = workers[b % threads];
+                    w.m_owned[w.m_count++]      = b;
+                }
+            }
+
+            // The summary bits are consistent again, every freed bit is found
+            u32 bit;
+            for (u32 b = 5; b < numbits; b += 7)
+                CHECK_TRUE(bitset.clr(b));
+            for (u32 b = 5; b < numbits; b += 7)
+            {
+                CHECK_TRUE(bitset.find_and_set(bit));
+                CHECK_EQUAL(b, bit);
+            }
+            CHECK_FALSE(bitset.find_and_set(bit));
+
+            for (u32 i = 0; i < threads; ++i)
+                gTestAllocator->deallocate(workers[i].m_owned);
+            gTestAllocator->deallocate(owner);
+            bitset.release(gTestAllocator);
+        }
+
+        UNITTEST_TEST(small)
+        {
+            hibitset_atomic_t bitset;
+            bitset.init(gTestAllocator, 10);
+
+            u32 bit;
+            for (u32 i = 0; i < 10; ++i)
+                CHECK_TRUE(bitset.find_and_set(bit));
+            CHECK_FALSE(bitset.find_and_set(bit));
+            CHECK_TRUE(bitset.clr(3));
+            CHECK_TRUE(bitset.find_and_set(bit));
+            CHECK_EQUAL(3, bit);
+
+            bitset.release(gTestAllocator);
+        }
+    }
+}
+UNITTEST_SUITE_END
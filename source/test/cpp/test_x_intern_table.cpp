@@ -0,0 +1,143 @@
+#include "xbase/x_allocator.h"
+#include "xbase/x_hash.h"
+#include "xbase/x_intern_table.h"
+#include "xbase/x_memory.h"
+
+#include "xunittest/xunittest.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t* gTestAllocator;
+
+namespace xcore
+{
+    // Write "key.<i>" into @dst and return it as a string
+    static crunes_t make_key(char* dst, u32 i)
+    {
+        char  digits[12];
+        s32   n = 0;
+        char* p = dst;
+        do
+        {
+            digits[n++] = (char)('0' + (i % 10));
+            i /= 10;
+        } while (i != 0);
+        *p++ = 'k';
+        *p++ = 'e';
+        *p++ = 'y';
+        *p++ = '.';
+        while (n > 0)
+            *p++ = digits[--n];
+        *p = '\0';
+        return crunes_t((ascii::pcrune)dst, (ascii::pcrune)p);
+    }
+}
+
+UNITTEST_SUITE_BEGIN(intern_table_t)
+{
+    UNITTEST_FIXTURE(main)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(intern_find)
+        {
+            intern_table_t table(gTestAllocator);
+            CHECK_EQUAL(0, table.size());
+            CHECK_TRUE(table.find(crunes_t("channel.main")).isNull());
+
+            handle_t a = table.intern(crunes_t("channel.main"));
+            handle_t b = table.intern(crunes_t("channel.side"));
+            handle_t c = table.intern(crunes_t("channel.main"));
+            CHECK_TRUE(a.isValid());
+            CHECK_TRUE(a == c);
+            CHECK_TRUE(a != b);
+            CHECK_EQUAL(2, table.size());
+
+            CHECK_TRUE(table.find(crunes_t("channel.side")) == b);
+            CHECK_TRUE(table.find(crunes_t("channel")).isNull());
+            CHECK_TRUE(table.find(crunes_t("")).isNull());
+
+            handle_t e = table.intern(crunes_t(""));
+            CHECK_TRUE(e.isValid());
+            CHECK_TRUE(table.find(crunes_t("")) == e);
+            CHECK_EQUAL(3, table.size());
+        }
+
+        UNITTEST_TEST(view_hash)
+        {
+            intern_table_t table(gTestAllocator);
+
+            char str[] = "channel.main";
+            handle_t h = table.intern(crunes_t(str));
+
+            // The table holds its own copy
+            str[0]     = 'C';
+            crunes_t v = table.view(h);
+            CHECK_TRUE(v == crunes_t("channel.main"));
+            CHECK_EQUAL(0, v.m_runes.m_ascii.m_end[0]);
+            CHECK_EQUAL(calchash((xbyte const*)"channel.main", 12), table.hash(h));
+        }
+
+        UNITTEST_TEST(rune_types)
+        {
+            intern_table_t table(gTestAllocator);
+
+            utf32::rune wide[] = {'k', 'e', 'y', 0};
+            handle_t    a      = table.intern(crunes_t("key"));
+            handle_t    b      = table.intern(crunes_t(wide, wide + 3));
+            CHECK_TRUE(a != b);
+            CHECK_TRUE(table.find(crunes_t(wide, wide + 3)) == b);
+            CHECK_EQUAL(utf32::TYPE, table.view(b).m_type);
+        }
+
+        UNITTEST_TEST(many)
+        {
+            intern_table_t table(gTestAllocator);
+
+            // Crosses the page size and grows the hash table a few times
+            char name[32];
+            for (u32 i = 0; i < 10000; ++i)
+            {
+                handle_t h = table.intern(make_key(name, i));
+                CHECK_EQUAL(i, h.get());
+            }
+            CHECK_EQUAL(10000, table.size());
+
+            for (u32 i = 0; i < 10000; i += 7)
+            {
+                crunes_t str = make_key(name, i);
+                handle_t h = table.find(str);
+                CHECK_EQUAL(i, h.get());
+                CHECK_TRUE(table.view(h) == str);
+            }
+        }
+
+        UNITTEST_TEST(batch)
+        {
+            intern_table_t table(gTestAllocator);
+            handle_t       known = table.intern(crunes_t("b"));
+
+            crunes_t strs[] = {crunes_t("a"), crunes_t("b"), crunes_t("c"), crunes_t("a")};
+            handle_t handles[4];
+            table.intern(strs, 4, handles);
+
+            CHECK_TRUE(handles[1] == known);
+            CHECK_TRUE(handles[0] == handles[3]);
+            CHECK_TRUE(handles[0] != handles[2]);
+            CHECK_EQUAL(3, table.size());
+            CHECK_TRUE(table.view(handles[2]) == crunes_t("c"));
+        }
+
+        UNITTEST_TEST(release)
+        {
+            intern_table_t table(gTestAllocator);
+            table.intern(crunes_t("x"));
+            table.release();
+            CHECK_EQUAL(0, table.size());
+            CHECK_TRUE(table.find(crunes_t("x")).isNull());
+            CHECK_EQUAL(0, table.intern(crunes_t("y")).get());
+        }
+    }
+}
+UNITTEST_SUITE_END
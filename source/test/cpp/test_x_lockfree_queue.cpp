@@ -0,0 +1,269 @@
+#include <atomic>
+#include <thread>
+
+#include "xbase/x_allocator.h"
+#include "xbase/x_lockfree_queue.h"
+
+#include "xunittest/xunittest.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t* gTestAllocator;
+
+namespace
+{
+    // Producer @p pushes the items p * count .. p * count + count - 1, every
+    // third round as a batch of up to 7 items
+    template <typename Q> void queue_produce(Q* queue, u32 p, u32 count)
+    {
+        u32 items[7];
+        u32 next = 0;
+        for (u32 round = 0; next < count; ++round)
+        {
+            if ((round % 3) == 0)
+            {
+                u32 const n = xmin(count - next, 7u);
+                for (u32 i = 0; i < n; ++i)
+                    items[i] = p * count + next + i;
+                u32 const pushed = queue->push(items, n);
+                next += pushed;
+                if (pushed < n)
+                    std::this_thread::yield();
+            }
+            else if (queue->push(p * count + next))
+            {
+                next += 1;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Pops until @total items were popped by all consumers together, every
+    // popped item is counted in @seen. The items of one producer (@count per
+    // producer, at most 8 producers) have to come out in the order they went in.
+    template <typename Q> void queue_consume(Q* queue, std::atomic<u32>* popped, u32 total, u32 count, u8* seen, bool* in_order)
+    {
+        u32 items[5];
+        u32 next[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        for (u32 round = 0; popped->load() < total; ++round)
+        {
+            u32 n = 0;
+            if ((round & 1) == 0)
+                n = queue->pop(items, 5);
+            else if (queue->pop(items[0]))
+                n = 1;
+            if (n == 0)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            for (u32 i = 0; i < n; ++i)
+            {
+                u32 const p = items[i] / count;
+                *in_order   = *in_order && items[i] >= next[p];
+                next[p]     = items[i] + 1;
+                seen[items[i]] += 1;
+            }
+            popped->fetch_add(n);
+        }
+    }
+} // namespace
+
+UNITTEST_SUITE_BEGIN(lockfree_queue)
+{
+    UNITTEST_FIXTURE(spsc)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(init_release)
+        {
+            spsc_queue_t<u32> queue;
+            queue.init(gTestAllocator, 100);
+            CHECK_EQUAL(128, queue.capacity());
+            CHECK_EQUAL(0, queue.size());
+            queue.release();
+        }
+
+        UNITTEST_TEST(push_pop)
+        {
+            spsc_queue_t<u32> queue;
+            queue.init(gTestAllocator, 16);
+
+            u32 item;
+            CHECK_FALSE(queue.pop(item));
+            for (u32 i = 0; i < 16; ++i)
+                CHECK_TRUE(queue.push(i));
+            CHECK_FALSE(queue.push(16));
+            CHECK_EQUAL(16, queue.size());
+
+            for (u32 i = 0; i < 16; ++i)
+            {
+                CHECK_TRUE(queue.pop(item));
+                CHECK_EQUAL(i, item);
+            }
+            CHECK_FALSE(queue.pop(item));
+        }
+
+        UNITTEST_TEST(push_pop_batch_wrap)
+        {
+            spsc_queue_t<u32> queue;
+            queue.init(gTestAllocator, 8);
+
+            u32 in[6];
+            u32 out[6];
+            u32 next = 0;
+            u32 expect = 0;
+            for (s32 round = 0; round < 10; ++round)
+            {
+                for (u32 i = 0; i < 6; ++i)
+                    in[i] = next + i;
+                u32 const pushed = queue.push(in, 6);
+                next += pushed;
+                u32 const popped = queue.pop(out, 5);
+                for (u32 i = 0; i < popped; ++i)
+                    CHECK_EQUAL(expect + i, out[i]);
+                expect += popped;
+            }
+            CHECK_EQUAL(next - expect, queue.size());
+            CHECK_TRUE(queue.size() <= queue.capacity());
+        }
+
+        UNITTEST_TEST(threads_in_order)
+        {
+            spsc_queue_t<u32> queue;
+            queue.init(gTestAllocator, 64);
+
+            u32 const count = 200000;
+            u8*       seen  = (u8*)gTestAllocator->allocate(count, sizeof(u32));
+            for (u32 i = 0; i < count; ++i)
+                seen[i] = 0;
+
+            std::atomic<u32> popped(0);
+            bool             in_order = true;
+            std::thread      producer(queue_produce<spsc_queue_t<u32> >, &queue, 0, count);
+            std::thread      consumer(queue_consume<spsc_queue_t<u32> >, &queue, &popped, count, count, seen, &in_order);
+            producer.join();
+            consumer.join();
+
+            bool once = true;
+            for (u32 i = 0; i < count; ++i)
+                once = once && seen[i] == 1;
+            CHECK_TRUE(once);
+            CHECK_TRUE(in_order);
+            CHECK_EQUAL(0, queue.size());
+
+            gTestAllocator->deallocate(seen);
+        }
+    }
+
+    UNITTEST_FIXTURE(mpmc)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(push_pop)
+        {
+            mpmc_queue_t<u64> queue;
+            queue.init(gTestAllocator, 32);
+            CHECK_EQUAL(32, queue.capacity());
+
+            u64 item;
+            CHECK_FALSE(queue.pop(item));
+            for (u64 i = 0; i < 32; ++i)
+                CHECK_TRUE(queue.push(i * 3));
+            CHECK_FALSE(queue.push(0));
+            for (u64 i = 0; i < 32; ++i)
+            {
+                CHECK_TRUE(queue.pop(item));
+                CHECK_EQUAL(i * 3, item);
+            }
+            CHECK_FALSE(queue.pop(item));
+        }
+
+        UNITTEST_TEST(push_pop_batch_mixed)
+        {
+            mpmc_queue_t<u32> queue;
+            queue.init(gTestAllocator, 16);
+
+            u32 in[10];
+            for (u32 i = 0; i < 10; ++i)
+                in[i] = i;
+            CHECK_EQUAL(10, queue.push(in, 10));
+            CHECK_EQUAL(6, queue.push(in, 10));
+            CHECK_EQUAL(0, queue.push(in, 10));
+            CHECK_FALSE(queue.push(99));
+
+            u32 item;
+            CHECK_TRUE(queue.pop(item));
+            CHECK_EQUAL(0, item);
+
+            u32 out[16];
+            CHECK_EQUAL(15, queue.pop(out, 16));
+            for (u32 i = 0; i < 9; ++i)
+                CHECK_EQUAL(i + 1, out[i]);
+            for (u32 i = 0; i < 6; ++i)
+                CHECK_EQUAL(i, out[9 + i]);
+            CHECK_EQUAL(0, queue.pop(out, 16));
+
+            CHECK_TRUE(queue.push(42));
+            CHECK_TRUE(queue.pop(item));
+            CHECK_EQUAL(42, item);
+        }
+
+        UNITTEST_TEST(threads_exactly_once)
+        {
+            // 4 producers and 4 consumers on a small queue so that it is often
+            // full or empty, every item is popped exactly once
+            mpmc_queue_t<u32> queue;
+            queue.init(gTestAllocator, 32);
+
+            u32 const producers = 4;
+            u32 const consumers = 4;
+            u32 const count     = 100000;
+            u32 const total     = producers * count;
+            u8*       seen[consumers];
+            for (u32 c = 0; c < consumers; ++c)
+            {
+                seen[c] = (u8*)gTestAllocator->allocate(total, sizeof(u32));
+                for (u32 i = 0; i < total; ++i)
+                    seen[c][i] = 0;
+            }
+
+            std::atomic<u32> popped(0);
+            bool             in_order[consumers];
+            std::thread      threads[producers + consumers];
+            for (u32 p = 0; p < producers; ++p)
+                threads[p] = std::thread(queue_produce<mpmc_queue_t<u32> >, &queue, p, count);
+            for (u32 c = 0; c < consumers; ++c)
+            {
+                in_order[c]            = true;
+                threads[producers + c] = std::thread(queue_consume<mpmc_queue_t<u32> >, &queue, &popped, total, count, seen[c], &in_order[c]);
+            }
+            for (u32 t = 0; t < producers + consumers; ++t)
+                threads[t].join();
+
+            bool once  = true;
+            bool order = true;
+            for (u32 i = 0; i < total; ++i)
+            {
+                u32 n = 0;
+                for (u32 c = 0; c < consumers; ++c)
+                    n += seen[c][i];
+                once = once && n == 1;
+            }
+            for (u32 c = 0; c < consumers; ++c)
+                order = order && in_order[c];
+            CHECK_TRUE(once);
+            CHECK_TRUE(order);
+            CHECK_EQUAL(0, queue.size());
+
+            for (u32 c = 0; c < consumers; ++c)
+                gTestAllocator->deallocate(seen[c]);
+        }
+    }
+}
+UNITTEST_SUITE_END
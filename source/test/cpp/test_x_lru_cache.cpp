@@ -0,0 +1,141 @@
+#include "xbase/x_allocator.h"
+#include "xbase/x_lru_cache.h"
+
+#include "xunittest/xunittest.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t* gTestAllocator;
+
+UNITTEST_SUITE_BEGIN(lru_cache_t)
+{
+    UNITTEST_FIXTURE(main)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(insert_get_remove)
+        {
+            lru_cache_t<u32, u64> cache(gTestAllocator);
+            cache.init(100);
+            CHECK_TRUE(cache.is_empty());
+
+            for (u32 i = 0; i < 50; ++i)
+                CHECK_TRUE(cache.insert(i, (u64)i * 10));
+            CHECK_EQUAL(50, cache.size());
+            CHECK_FALSE(cache.insert(7, 700));
+
+            u64 v;
+            CHECK_TRUE(cache.find(7, v));
+            CHECK_EQUAL(700, v);
+            CHECK_EQUAL(490, *cache.get(49));
+            CHECK_NULL(cache.get(50));
+
+            CHECK_TRUE(cache.remove(7, v));
+            CHECK_EQUAL(700, v);
+            CHECK_FALSE(cache.remove(7));
+            CHECK_FALSE(cache.contains(7));
+            CHECK_EQUAL(49, cache.size());
+
+            cache.clear();
+            CHECK_TRUE(cache.is_empty());
+        }
+
+        UNITTEST_TEST(lru_eviction)
+        {
+            lru_cache_t<u32, u32> cache(gTestAllocator);
+            cache.init(4);
+            for (u32 i = 0; i < 4; ++i)
+                cache.insert(i, i);
+
+            // Use 0 so that 1 becomes the least recently used
+            CHECK_NOT_NULL(cache.get(0));
+            cache.insert(4, 4);
+            CHECK_EQUAL(4, cache.size());
+            CHECK_TRUE(cache.contains(0));
+            CHECK_FALSE(cache.contains(1));
+
+            u32 k, v;
+            CHECK_TRUE(cache.evict(k, v));
+            CHECK_EQUAL(2, k);
+            CHECK_TRUE(cache.evict(k, v));
+            CHECK_EQUAL(3, k);
+            CHECK_TRUE(cache.evict(k, v));
+            CHECK_EQUAL(0, k);
+            CHECK_TRUE(cache.evict(k, v));
+            CHECK_EQUAL(4, k);
+            CHECK_FALSE(cache.evict(k, v));
+        }
+
+        UNITTEST_TEST(clock_eviction)
+        {
+            lru_cache_t<u32, u32> cache(gTestAllocator);
+            cache.init(4, 0, lru_cache_t<u32, u32>::MODE_CLOCK);
+            for (u32 i = 0; i < 4; ++i)
+                cache.insert(i, i);
+
+            // 0 and 2 get a second chance
+            CHECK_NOT_NULL(cache.get(0));
+            CHECK_NOT_NULL(cache.get(2));
+            cache.insert(4, 4);
+            CHECK_FALSE(cache.contains(1));
+            cache.insert(5, 5);
+            CHECK_FALSE(cache.contains(3));
+            CHECK_TRUE(cache.contains(0));
+            CHECK_TRUE(cache.contains(2));
+
+            // The hand cleared the flags, so 0 is next
+            cache.insert(6, 6);
+            CHECK_FALSE(cache.contains(0));
+            CHECK_EQUAL(4, cache.size());
+        }
+
+        UNITTEST_TEST(capacity_in_bytes)
+        {
+            lru_cache_t<u32, u32> cache(gTestAllocator);
+            cache.init(0, 1000);
+            for (u32 i = 0; i < 10; ++i)
+                cache.insert(i, i, 100);
+            CHECK_EQUAL(10, cache.size());
+            CHECK_EQUAL(1000, cache.bytes());
+
+            // Needs to evict 3 entries to fit
+            cache.insert(10, 10, 250);
+            CHECK_EQUAL(8, cache.size());
+            CHECK_EQUAL(950, cache.bytes());
+            CHECK_FALSE(cache.contains(0));
+            CHECK_FALSE(cache.contains(2));
+            CHECK_TRUE(cache.contains(3));
+
+            // Growing an existing entry also evicts
+            cache.insert(10, 10, 450);
+            CHECK_EQUAL(950, cache.bytes());
+            CHECK_EQUAL(6, cache.size());
+            CHECK_TRUE(cache.contains(10));
+
+            // Lowering the capacity evicts
+            cache.init(0, 500);
+            CHECK_EQUAL(450, cache.bytes());
+            CHECK_EQUAL(1, cache.size());
+        }
+
+        UNITTEST_TEST(many)
+        {
+            lru_cache_t<u32, u32> cache(gTestAllocator);
+            cache.init(1000);
+            for (u32 i = 0; i < 100000; ++i)
+            {
+                cache.insert(i, i * 2);
+
+                // Keep 0 alive by using it
+                CHECK_NOT_NULL(cache.get(0));
+            }
+            CHECK_EQUAL(1000, cache.size());
+            CHECK_TRUE(cache.contains(0));
+            CHECK_FALSE(cache.contains(99000));
+            for (u32 i = 99001; i < 100000; ++i)
+                CHECK_EQUAL(i * 2, *cache.get(i));
+        }
+    }
+}
+UNITTEST_SUITE_END
@@ -32,6 +32,31 @@ UNITTEST_SUITE_BEGIN(xmap_and_set)
 			CHECK_EQUAL(v, f);
 			CHECK_TRUE(map.remove(k, v));
         }
+
+        UNITTEST_TEST(map_u64_find_batch)
+        {
+            map_t<u64, u32> map(gTestAllocator);
+            for (u32 i = 0; i < 100; ++i)
+                CHECK_TRUE(map.insert((u64)i * 3, i));
+
+            // Every third key is in the map
+            u64  keys[150];
+            u32  values[150];
+            bool found[150];
+            for (u32 i = 0; i < 150; ++i)
+                keys[i] = i;
+            CHECK_EQUAL(50, map.find(keys, 150, values, found));
+            for (u32 i = 0; i < 150; ++i)
+            {
+                CHECK_EQUAL((i % 3) == 0, found[i]);
+                if (found[i])
+                    CHECK_EQUAL(i / 3, values[i]);
+            }
+
+            u32 v;
+            for (u32 i = 0; i < 100; ++i)
+                CHECK_TRUE(map.remove((u64)i * 3, v));
+        }
     }
 
     UNITTEST_FIXTURE(xset)
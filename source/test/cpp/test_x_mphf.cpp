@@ -0,0 +1,135 @@
+#include "xbase/x_allocator.h"
+#include "xbase/x_buffer.h"
+#include "xbase/x_hash.h"
+#include "xbase/x_memory.h"
+#include "xbase/x_mphf.h"
+#include "xbase/x_runes.h"
+
+#include "xunittest/xunittest.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t* gTestAllocator;
+
+namespace xcore
+{
+    static void mphf_hashes(u64* hashes, u32 count)
+    {
+        for (u32 i = 0; i < count; ++i)
+        {
+            u64 const key = (u64)i * 7919 + 13;
+            hashes[i]     = calchash((xbyte const*)&key, sizeof(key));
+        }
+    }
+
+    // Every hash maps to a different index in [0, count)
+    static bool mphf_is_minimal_perfect(mphf_t const& mphf, u64 const* hashes, u32 count)
+    {
+        u64* seen = (u64*)gTestAllocator->allocate(((count + 63) / 64) * sizeof(u64), sizeof(u64));
+        x_memclr(seen, ((count + 63) / 64) * sizeof(u64));
+        bool ok = true;
+        for (u32 i = 0; i < count && ok; ++i)
+        {
+            u32 const index = mphf.lookup(hashes[i]);
+            ok              = index < count && (seen[index / 64] & ((u64)1 << (index & 63))) == 0;
+            if (ok)
+                seen[index / 64] |= ((u64)1 << (index & 63));
+        }
+        gTestAllocator->deallocate(seen);
+        return ok;
+    }
+}
+
+UNITTEST_SUITE_BEGIN(mphf_t)
+{
+    UNITTEST_FIXTURE(main)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(keys)
+        {
+            mphf_t mphf(gTestAllocator);
+
+            const char* names[] = {"volume", "balance", "mute", "gain", "pan", "reverb", "delay", "chorus"};
+            cbuffer_t   keys[8];
+            for (u32 i = 0; i < 8; ++i)
+                keys[i] = cbuffer_t(crunes_t(names[i]));
+            CHECK_TRUE(mphf.build(keys, 8));
+            CHECK_EQUAL(8, mphf.size());
+
+            u32 seen = 0;
+            for (u32 i = 0; i < 8; ++i)
+            {
+                u32 const index = mphf.lookup(keys[i]);
+                CHECK_TRUE(index < 8);
+                seen |= 1 << index;
+            }
+            CHECK_EQUAL(0xff, seen);
+        }
+
+        UNITTEST_TEST(many)
+        {
+            mphf_t    mphf(gTestAllocator);
+            u32 const count  = 100000;
+            u64*      hashes = (u64*)gTestAllocator->allocate(count * sizeof(u64), sizeof(u64));
+            mphf_hashes(hashes, count);
+
+            CHECK_TRUE(mphf.build(hashes, count));
+            CHECK_TRUE(mphf_is_minimal_perfect(mphf, hashes, count));
+
+            // Roughly 3 bits per key (bit arrays and rank samples)
+            CHECK_TRUE((mphf.size_in_bytes() * 8) < (count * 4));
+
+            mphf_t fast(gTestAllocator);
+            CHECK_TRUE(fast.build(hashes, count, 200));
+            CHECK_TRUE(mphf_is_minimal_perfect(fast, hashes, count));
+
+            gTestAllocator->deallocate(hashes);
+        }
+
+        UNITTEST_TEST(duplicates)
+        {
+            mphf_t mphf(gTestAllocator);
+            u64    hashes[] = {1, 2, 3, 2};
+            CHECK_FALSE(mphf.build(hashes, 4));
+            CHECK_EQUAL(0, mphf.size());
+
+            CHECK_TRUE(mphf.build(hashes, 3));
+            CHECK_TRUE(mphf.build(hashes, 0));
+            CHECK_EQUAL((u32)mphf_t::INVALID, mphf.lookup(1));
+        }
+
+        UNITTEST_TEST(serialize)
+        {
+            mphf_t    mphf(gTestAllocator);
+            u32 const count  = 5000;
+            u64*      hashes = (u64*)gTestAllocator->allocate(count * sizeof(u64), sizeof(u64));
+            mphf_hashes(hashes, count);
+            CHECK_TRUE(mphf.build(hashes, count));
+
+            u32 const size = mphf.serialized_size();
+            xbyte*    data = (xbyte*)gTestAllocator->allocate(size, sizeof(u64));
+            buffer_t  buffer(size, data);
+
+            binary_writer_t writer(buffer);
+            CHECK_EQUAL((s32)size, mphf.serialize(writer));
+
+            mphf_t          copy(gTestAllocator);
+            binary_reader_t reader(data, size);
+            CHECK_TRUE(copy.deserialize(reader));
+            CHECK_EQUAL(count, copy.size());
+            for (u32 i = 0; i < count; ++i)
+                CHECK_EQUAL(mphf.lookup(hashes[i]), copy.lookup(hashes[i]));
+
+            // Truncated data
+            binary_reader_t truncated(data, size - 8);
+            CHECK_FALSE(copy.deserialize(truncated));
+            CHECK_EQUAL(0, copy.size());
+
+            gTestAllocator->deallocate(data);
+            gTestAllocator->deallocate(hashes);
+        }
+    }
+}
+UNITTEST_SUITE_END
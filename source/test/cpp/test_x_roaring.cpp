@@ -0,0 +1,178 @@
+#include "xbase/x_allocator.h"
+#include "xbase/x_buffer.h"
+#include "xbase/x_roaring.h"
+
+#include "xunittest/xunittest.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t* gTestAllocator;
+
+UNITTEST_SUITE_BEGIN(roaring_t)
+{
+    UNITTEST_FIXTURE(main)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(add_remove_contains)
+        {
+            roaring_t set(gTestAllocator);
+            CHECK_TRUE(set.is_empty());
+
+            CHECK_TRUE(set.add(10));
+            CHECK_FALSE(set.add(10));
+            CHECK_TRUE(set.add(0xffffffff));
+            CHECK_TRUE(set.add(70000));
+            CHECK_EQUAL(3, set.cardinality());
+            CHECK_TRUE(set.contains(10));
+            CHECK_TRUE(set.contains(70000));
+            CHECK_TRUE(set.contains(0xffffffff));
+            CHECK_FALSE(set.contains(11));
+
+            CHECK_TRUE(set.remove(70000));
+            CHECK_FALSE(set.remove(70000));
+            CHECK_FALSE(set.contains(70000));
+            CHECK_EQUAL(2, set.cardinality());
+
+            set.clear();
+            CHECK_TRUE(set.is_empty());
+        }
+
+        UNITTEST_TEST(array_to_bitmap_and_back)
+        {
+            roaring_t set(gTestAllocator);
+            for (u32 i = 0; i < 10000; ++i)
+                CHECK_TRUE(set.add(i * 3));
+            CHECK_EQUAL(10000, set.cardinality());
+            for (u32 i = 0; i < 10000; ++i)
+                CHECK_TRUE(set.contains(i * 3));
+
+            for (u32 i = 0; i < 10000; i += 2)
+                CHECK_TRUE(set.remove(i * 3));
+            CHECK_EQUAL(5000, set.cardinality());
+
+            u32 value;
+            u32 expect = 3;
+            roaring_t::iter_t iter(set);
+            while (iter.next(value))
+            {
+                CHECK_EQUAL(expect, value);
+                expect += 6;
+            }
+            CHECK_EQUAL(3 + 5000 * 6, expect);
+        }
+
+        UNITTEST_TEST(set_operations)
+        {
+            roaring_t a(gTestAllocator);
+            roaring_t b(gTestAllocator);
+
+            // Mix of sparse (array) and dense (bitmap) containers
+            for (u32 i = 0; i < 200000; i += 2)
+                a.add(i);
+            for (u32 i = 0; i < 200000; i += 3)
+                b.add(i);
+            for (u32 i = 0; i < 100; ++i)
+                b.add(1000000 + i * 7);
+
+            roaring_t u(gTestAllocator);
+            u.copy(a);
+            u.set_union(b);
+            roaring_t n(gTestAllocator);
+            n.copy(a);
+            n.set_intersection(b);
+            roaring_t d(gTestAllocator);
+            d.copy(a);
+            d.set_difference(b);
+
+            for (u32 i = 0; i < 200000; ++i)
+            {
+                bool const ina = (i % 2) == 0;
+                bool const inb = (i % 3) == 0;
+                CHECK_EQUAL(ina || inb, u.contains(i));
+                CHECK_EQUAL(ina && inb, n.contains(i));
+                CHECK_EQUAL(ina && !inb, d.contains(i));
+            }
+            CHECK_EQUAL(100000 + 66667 - 33334 + 100, u.cardinality());
+            CHECK_EQUAL(33334, n.cardinality());
+            CHECK_EQUAL(100000 - 33334, d.cardinality());
+            CHECK_TRUE(u.contains(1000000 + 7 * 99));
+            CHECK_FALSE(n.contains(1000000));
+        }
+
+        UNITTEST_TEST(run_containers)
+        {
+            roaring_t a(gTestAllocator);
+            for (u32 i = 1000; i < 60000; ++i)
+                a.add(i);
+            for (u32 i = 100000; i < 100010; ++i)
+                a.add(i);
+            CHECK_TRUE(a.run_optimize());
+            CHECK_EQUAL(59000 + 10, a.cardinality());
+            CHECK_TRUE(a.contains(1000));
+            CHECK_TRUE(a.contains(59999));
+            CHECK_FALSE(a.contains(60000));
+            CHECK_FALSE(a.contains(999));
+
+            u32 value;
+            u32 count = 0;
+            roaring_t::iter_t iter(a);
+            while (iter.next(value))
+                count += 1;
+            CHECK_EQUAL(59010, count);
+
+            roaring_t b(gTestAllocator);
+            for (u32 i = 0; i < 100; ++i)
+                b.add(i * 1000);
+            b.set_intersection(a);
+            CHECK_EQUAL(59, b.cardinality());
+
+            // Modifying a run container
+            CHECK_TRUE(a.remove(30000));
+            CHECK_FALSE(a.contains(30000));
+            CHECK_TRUE(a.add(30000));
+            CHECK_EQUAL(59010, a.cardinality());
+        }
+
+        UNITTEST_TEST(serialize)
+        {
+            roaring_t a(gTestAllocator);
+            for (u32 i = 0; i < 100; ++i)
+                a.add(i * 13);
+            for (u32 i = 0; i < 20000; ++i)
+                a.add(0x10000 + i * 2);
+            for (u32 i = 0; i < 5000; ++i)
+                a.add(0x30000 + i);
+            a.run_optimize();
+
+            u32 const size = a.serialized_size();
+            xbyte*    data = (xbyte*)gTestAllocator->allocate(size, 8);
+            binary_writer_t writer(data, size);
+            CHECK_EQUAL((s32)size, a.serialize(writer));
+
+            roaring_t b(gTestAllocator);
+            binary_reader_t reader(data, size);
+            CHECK_TRUE(b.deserialize(reader));
+            CHECK_EQUAL(a.cardinality(), b.cardinality());
+
+            roaring_t::iter_t ia(a);
+            roaring_t::iter_t ib(b);
+            u32 va, vb;
+            while (ia.next(va))
+            {
+                CHECK_TRUE(ib.next(vb));
+                CHECK_EQUAL(va, vb);
+            }
+            CHECK_FALSE(ib.next(vb));
+
+            // Truncated data is rejected
+            binary_reader_t truncated(data, size - 1);
+            CHECK_FALSE(b.deserialize(truncated));
+            CHECK_TRUE(b.is_empty());
+
+            gTestAllocator->deallocate(data);
+        }
+    }
+}
+UNITTEST_SUITE_END
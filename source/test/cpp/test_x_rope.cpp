@@ -0,0 +1,199 @@
+#include "xbase/x_allocator.h"
+#include "xbase/x_integer.h"
+#include "xbase/x_memory.h"
+#include "xbase/x_rope.h"
+
+#include "xunittest/xunittest.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t* gTestAllocator;
+
+namespace xcore
+{
+    // Copy the text of the rope into @dst and return the number of chars
+    static s32 rope_to_chars(rope_t const& rope, char* dst)
+    {
+        s32            n = 0;
+        crunes_t       span;
+        rope_t::iter_t iter(rope);
+        while (iter.next(span))
+        {
+            s32 const len = (s32)(span.m_runes.m_ascii.m_end - span.m_runes.m_ascii.m_str);
+            x_memcpy(dst + n, span.m_runes.m_ascii.m_str, len);
+            n += len;
+        }
+        dst[n] = '\0';
+        return n;
+    }
+
+    // Counts the allocations that are alive, one per chunk of a rope
+    class rope_counting_alloc_t : public alloc_t
+    {
+    public:
+        inline rope_counting_alloc_t() : m_count(0) {}
+
+        virtual void* v_allocate(u32 size, u32 alignment)
+        {
+            m_count += 1;
+            return gTestAllocator->allocate(size, alignment);
+        }
+        virtual u32 v_deallocate(void* mem)
+        {
+            m_count -= 1;
+            return gTestAllocator->deallocate(mem);
+        }
+        virtual void v_release() {}
+
+        s32 m_count;
+    };
+}
+
+UNITTEST_SUITE_BEGIN(rope_t)
+{
+    UNITTEST_FIXTURE(main)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(insert_remove_replace)
+        {
+            rope_t rope(gTestAllocator);
+            CHECK_TRUE(rope.is_empty());
+
+            char text[64];
+            rope.append(crunes_t("hello world"));
+            CHECK_EQUAL(11, rope.size());
+            rope.insert(5, crunes_t(","));
+            rope_to_chars(rope, text);
+            CHECK_EQUAL(0, x_memcmp(text, "hello, world", 13));
+
+            rope.replace(0, 5, crunes_t("goodbye"));
+            rope_to_chars(rope, text);
+            CHECK_EQUAL(0, x_memcmp(text, "goodbye, world", 15));
+            CHECK_EQUAL('w', rope.at(9));
+
+            rope.remove(7, 14);
+            CHECK_EQUAL(7, rope.size());
+            rope_to_chars(rope, text);
+            CHECK_EQUAL(0, x_memcmp(text, "goodbye", 8));
+
+            rope.clear();
+            CHECK_TRUE(rope.is_empty());
+        }
+
+        UNITTEST_TEST(large_random_edits)
+        {
+            // Compare against a flat buffer that is edited the slow way
+            s32 const maxlen = 64 * 1024;
+            char*     flat   = (char*)gTestAllocator->allocate(maxlen + 1, 8);
+            char*     check  = (char*)gTestAllocator->allocate(maxlen + 1000 + 1, 8);
+            char      piece[300];
+            s32       len = 0;
+
+            rope_t rope(gTestAllocator);
+            u32    r = 0x1234;
+            for (s32 i = 0; i < 2000; ++i)
+            {
+                r             = r * 1664525 + 1013904223;
+                s32 const pos = len == 0 ? 0 : (s32)((r >> 8) % (u32)(len + 1));
+                r             = r * 1664525 + 1013904223;
+                s32 const n   = (s32)((r >> 8) % 300);
+                if ((i % 3) != 2 && (len + n) < maxlen)
+                {
+                    for (s32 j = 0; j < n; ++j)
+                        piece[j] = (char)('a' + ((i + j) % 26));
+                    rope.insert(pos, crunes_t((ascii::pcrune)piece, (ascii::pcrune)piece + n));
+                    xmem::memmove(flat + pos + n, flat + pos, len - pos);
+                    x_memcpy(flat + pos, piece, n);
+                    len += n;
+                }
+                else
+                {
+                    s32 const to = xmin(pos + n, len);
+                    rope.remove(pos, to);
+                    xmem::memmove(flat + pos, flat + to, len - to);
+                    len -= to - pos;
+                }
+            }
+
+            CHECK_EQUAL(len, rope.size());
+            CHECK_EQUAL(len, rope_to_chars(rope, check));
+            CHECK_EQUAL(0, x_memcmp(flat, check, len));
+
+            rope_t sub(gTestAllocator);
+            rope.substring(100, 1100, sub);
+            CHECK_EQUAL(1000, sub.size());
+            rope_to_chars(sub, check);
+            CHECK_EQUAL(0, x_memcmp(flat + 100, check, 1000));
+
+            // Concatenation moves the chunks
+            rope.concat(sub);
+            CHECK_TRUE(sub.is_empty());
+            CHECK_EQUAL(len + 1000, rope.size());
+            rope_to_chars(rope, check);
+            CHECK_EQUAL(0, x_memcmp(flat + 100, check + len, 1000));
+
+            gTestAllocator->deallocate(flat);
+            gTestAllocator->deallocate(check);
+        }
+
+        UNITTEST_TEST(small_edits_keep_chunks_full)
+        {
+            // Every remove cuts a chunk and inserts into full chunks cut them too,
+            // the pieces are joined again so most chunks stay at least half full
+            s32 const maxlen = 16 * 1024;
+            char*     flat   = (char*)gTestAllocator->allocate(maxlen + 1, 8);
+            char*     check  = (char*)gTestAllocator->allocate(maxlen + 1, 8);
+            for (s32 i = 0; i < maxlen; ++i)
+                flat[i] = (char)('a' + (i % 26));
+            s32 len = maxlen / 2;
+
+            rope_counting_alloc_t allocator;
+            {
+                rope_t rope(&allocator);
+                rope.append(crunes_t((ascii::pcrune)flat, (ascii::pcrune)flat + len));
+                u32 r = 0x5678;
+                for (s32 i = 0; i < 5000; ++i)
+                {
+                    r             = r * 1664525 + 1013904223;
+                    s32 const pos = (s32)((r >> 8) % (u32)(len - 4));
+                    s32 const n   = 1 + (s32)((r >> 4) & 3);
+                    if ((i & 1) == 0 && (len + n) < maxlen)
+                    {
+                        rope.insert(pos, crunes_t((ascii::pcrune)"wxyz", (ascii::pcrune)"wxyz" + n));
+                        xmem::memmove(flat + pos + n, flat + pos, len - pos);
+                        x_memcpy(flat + pos, "wxyz", n);
+                        len += n;
+                    }
+                    else
+                    {
+                        rope.remove(pos, pos + n);
+                        xmem::memmove(flat + pos, flat + pos + n, len - pos - n);
+                        len -= n;
+                    }
+                }
+
+                CHECK_EQUAL(len, rope_to_chars(rope, check));
+                CHECK_EQUAL(0, x_memcmp(flat, check, len));
+                CHECK_TRUE(allocator.m_count <= 2 * (len / 1024) + 2);
+            }
+            CHECK_EQUAL(0, allocator.m_count);
+
+            gTestAllocator->deallocate(flat);
+            gTestAllocator->deallocate(check);
+        }
+
+        UNITTEST_TEST(utf32)
+        {
+            utf32::rune text[] = {0x41, 0x1F600, 0x42, 0};
+            rope_t rope(gTestAllocator, utf32::TYPE);
+            rope.append(crunes_t(text, text + 3));
+            rope.insert(1, crunes_t(text, text + 1));
+            CHECK_EQUAL(4, rope.size());
+            CHECK_EQUAL(0x41, rope.at(1));
+            CHECK_EQUAL(0x1F600, rope.at(2));
+        }
+    }
+}
+UNITTEST_SUITE_END
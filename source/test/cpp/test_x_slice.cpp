@@ -1,3 +1,5 @@
+#include <thread>
+
 #include "xbase/x_allocator.h"
 #include "xbase/x_slice.h"
 
@@ -7,6 +9,19 @@ using namespace xcore;
 
 extern xcore::alloc_t* gTestAllocator;
 
+namespace
+{
+	// Sum the items of a shared slice on another thread and release it
+	void slice_sum_and_release(slice_t* slice, s32* sum)
+	{
+		s32 total = 0;
+		for (s32 i = 0; i < slice->size(); ++i)
+			total += *(s32 const*)slice->at(i);
+		*sum = total;
+		slice->release();
+	}
+}
+
 UNITTEST_SUITE_BEGIN(xslice)
 {
 	UNITTEST_FIXTURE(main)
@@ -20,6 +35,99 @@ UNITTEST_SUITE_BEGIN(xslice)
 			slice_t::alloc(s, gTestAllocator, 100, 4);
 			s.release();
 		}
+
+		UNITTEST_TEST(obtain_release_refcount)
+		{
+			slice_t s;
+			slice_t::alloc(s, gTestAllocator, 100, 4);
+			CHECK_EQUAL(1, s.refcnt());
+			CHECK_FALSE(s.is_shared());
+
+			slice_t o = s.obtain();
+			CHECK_EQUAL(2, s.refcnt());
+			CHECK_TRUE(s.is_shared());
+			CHECK_TRUE(o.begin() == s.begin());
+
+			o.release();
+			CHECK_EQUAL(1, s.refcnt());
+			s.release();
+		}
+
+		UNITTEST_TEST(copy_on_write)
+		{
+			slice_t s(gTestAllocator, 10, sizeof(s32), slice_t::REFCOUNT_ATOMIC);
+			s32* items = (s32*)s.begin();
+			for (s32 i = 0; i < 10; ++i)
+				items[i] = i;
+
+			slice_t v = s.view(2, 6);
+			CHECK_EQUAL(2, s.refcnt());
+			CHECK_EQUAL(2, *(s32*)v.begin());
+
+			// The view is shared, so removing makes it a copy of only the view
+			v.remove(1);
+			CHECK_FALSE(v.is_shared());
+			CHECK_FALSE(s.is_shared());
+			CHECK_EQUAL(3, v.size());
+			CHECK_EQUAL(3, *(s32*)v.begin());
+			CHECK_EQUAL(10, s.size());
+			CHECK_EQUAL(2, ((s32*)s.begin())[2]);
+
+			// Not shared anymore, modified in place
+			v.resize(3);
+			CHECK_EQUAL(3, v.size());
+			CHECK_EQUAL(5, ((s32*)v.begin())[2]);
+
+			slice_t o = v.obtain();
+			o.insert(2);
+			CHECK_EQUAL(5, o.size());
+			CHECK_EQUAL(3, v.size());
+			CHECK_EQUAL(3, ((s32*)o.begin())[2]);
+			CHECK_EQUAL(1, v.refcnt());
+			CHECK_EQUAL(1, o.refcnt());
+
+			o.release();
+			v.release();
+			s.release();
+		}
+
+		UNITTEST_TEST(atomic_threads)
+		{
+			// Threads read their shared slice and release it while this thread
+			// waits until it holds the only reference and then edits in place
+			s32 const count   = 1000;
+			s32 const threads = 4;
+			for (s32 round = 0; round < 20; ++round)
+			{
+				slice_t s(gTestAllocator, count, sizeof(s32), slice_t::REFCOUNT_ATOMIC);
+				for (s32 i = 0; i < count; ++i)
+					*(s32*)s.at(i) = i;
+
+				slice_t     shared[threads];
+				s32         sums[threads];
+				std::thread t[threads];
+				for (s32 i = 0; i < threads; ++i)
+				{
+					shared[i] = s.obtain();
+					t[i]      = std::thread(slice_sum_and_release, &shared[i], &sums[i]);
+				}
+
+				while (s.is_shared())
+					std::this_thread::yield();
+				s.insert(10);
+				for (s32 i = 0; i < s.size(); ++i)
+					*(s32*)s.at(i) = -1;
+
+				for (s32 i = 0; i < threads; ++i)
+				{
+					t[i].join();
+					CHECK_EQUAL(count * (count - 1) / 2, sums[i]);
+				}
+				CHECK_EQUAL(1, s.refcnt());
+				CHECK_EQUAL(count + 10, s.size());
+				s.release();
+			}
+		}
 	}
 }
 UNITTEST_SUITE_END
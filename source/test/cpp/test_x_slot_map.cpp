@@ -0,0 +1,85 @@
+#include "xbase/x_allocator.h"
+#include "xbase/x_slot_map.h"
+
+#include "xunittest/xunittest.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t* gTestAllocator;
+
+UNITTEST_SUITE_BEGIN(slot_map_t)
+{
+    UNITTEST_FIXTURE(main)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(insert_get_remove)
+        {
+            slot_map_t<u64> map(gTestAllocator);
+            CHECK_TRUE(map.is_empty());
+
+            handle_t h1 = map.insert(100);
+            handle_t h2 = map.insert(200);
+            CHECK_TRUE(h1.isValid());
+            CHECK_TRUE(h1 != h2);
+            CHECK_EQUAL(2, map.size());
+            CHECK_EQUAL(100, *map.get(h1));
+            CHECK_EQUAL(200, *map.get(h2));
+
+            CHECK_TRUE(map.remove(h1));
+            CHECK_FALSE(map.remove(h1));
+            CHECK_NULL(map.get(h1));
+            CHECK_EQUAL(200, *map.get(h2));
+            CHECK_EQUAL(1, map.size());
+        }
+
+        UNITTEST_TEST(stale_handle_does_not_alias)
+        {
+            slot_map_t<u32> map(gTestAllocator);
+            handle_t h1 = map.insert(1);
+            CHECK_TRUE(map.remove(h1));
+
+            // The slot is re-used but with a new generation
+            handle_t h2 = map.insert(2);
+            CHECK_EQUAL(h1.get() & 0xffffff, h2.get() & 0xffffff);
+            CHECK_TRUE(h1 != h2);
+            CHECK_FALSE(map.contains(h1));
+            CHECK_NULL(map.get(h1));
+            CHECK_EQUAL(2, *map.get(h2));
+
+            CHECK_FALSE(map.contains(handle_t()));
+        }
+
+        UNITTEST_TEST(dense_iteration)
+        {
+            slot_map_t<u32> map(gTestAllocator);
+            handle_t handles[1000];
+            for (u32 i = 0; i < 1000; ++i)
+                handles[i] = map.insert(i);
+
+            for (u32 i = 0; i < 1000; i += 2)
+                CHECK_TRUE(map.remove(handles[i]));
+            CHECK_EQUAL(500, map.size());
+
+            u32 sum = 0;
+            for (u32* it = map.begin(); it != map.end(); ++it)
+            {
+                CHECK_EQUAL(1, *it & 1);
+                sum += *it;
+            }
+            CHECK_EQUAL(500 * 500, sum);
+
+            for (u32 i = 0; i < map.size(); ++i)
+                CHECK_EQUAL(map.at(i), *map.get(map.handle_at(i)));
+
+            for (u32 i = 1; i < 1000; i += 2)
+                CHECK_EQUAL(i, *map.get(handles[i]));
+
+            map.clear();
+            CHECK_TRUE(map.is_empty());
+            CHECK_FALSE(map.contains(handles[1]));
+        }
+    }
+}
+UNITTEST_SUITE_END
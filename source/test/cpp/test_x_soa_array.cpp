@@ -0,0 +1,94 @@
+#include "xbase/x_allocator.h"
+#include "xbase/x_soa_array.h"
+
+#include "xunittest/xunittest.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t* gTestAllocator;
+
+UNITTEST_SUITE_BEGIN(soa_array_t)
+{
+    UNITTEST_FIXTURE(main)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(construct)
+        {
+            soa_array_t<f32, u32, u8> array(gTestAllocator);
+            CHECK_EQUAL(0, array.size());
+            CHECK_EQUAL(0, array.capacity());
+            CHECK_TRUE(array.is_empty());
+        }
+
+        UNITTEST_TEST(reserve_aligns_columns)
+        {
+            soa_array_t<f32, u64, u8> array(gTestAllocator);
+            array.reserve(100);
+            CHECK_EQUAL(100, array.capacity());
+            CHECK_EQUAL(0, ((uptr)array.data<0>()) & (X_CACHE_LINE_SIZE - 1));
+            CHECK_EQUAL(0, ((uptr)array.data<1>()) & (X_CACHE_LINE_SIZE - 1));
+            CHECK_EQUAL(0, ((uptr)array.data<2>()) & (X_CACHE_LINE_SIZE - 1));
+        }
+
+        UNITTEST_TEST(push_back_and_get)
+        {
+            soa_array_t<f32, u32, u8> array(gTestAllocator);
+            for (u32 i = 0; i < 1000; ++i)
+                array.push_back((f32)i * 0.5f, i, (u8)(i & 0xff));
+
+            CHECK_EQUAL(1000, array.size());
+            for (u32 i = 0; i < 1000; ++i)
+            {
+                CHECK_EQUAL((f32)i * 0.5f, array.get<0>(i));
+                CHECK_EQUAL(i, array.get<1>(i));
+                CHECK_EQUAL((u8)(i & 0xff), array.get<2>(i));
+            }
+        }
+
+        UNITTEST_TEST(column_span)
+        {
+            soa_array_t<u32, u64> array(gTestAllocator);
+            for (u32 i = 0; i < 64; ++i)
+                array.push_back(i, (u64)i * 3);
+
+            soa_column_t<u64> column = array.column<1>();
+            CHECK_EQUAL(64, column.size());
+
+            u64 sum = 0;
+            for (u64* it = column.begin(); it != column.end(); ++it)
+                sum += *it;
+            CHECK_EQUAL((u64)(3 * (63 * 64) / 2), sum);
+
+            column[10] = 7;
+            CHECK_EQUAL(7, array.get<1>(10));
+        }
+
+        UNITTEST_TEST(swap_remove_and_remove)
+        {
+            soa_array_t<u32, u16> array(gTestAllocator);
+            for (u32 i = 0; i < 10; ++i)
+                array.push_back(i, (u16)(i + 100));
+
+            array.swap_remove(2);
+            CHECK_EQUAL(9, array.size());
+            CHECK_EQUAL(9, array.get<0>(2));
+            CHECK_EQUAL(109, array.get<1>(2));
+
+            array.remove(0);
+            CHECK_EQUAL(8, array.size());
+            CHECK_EQUAL(1, array.get<0>(0));
+            CHECK_EQUAL(9, array.get<0>(1));
+            CHECK_EQUAL(3, array.get<0>(2));
+            CHECK_EQUAL(103, array.get<1>(2));
+
+            CHECK_TRUE(array.pop_back());
+            CHECK_EQUAL(7, array.size());
+            array.clear();
+            CHECK_TRUE(array.is_empty());
+            CHECK_FALSE(array.pop_back());
+        }
+    }
+}
+UNITTEST_SUITE_END
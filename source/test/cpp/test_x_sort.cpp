@@ -0,0 +1,542 @@
+#include "xbase/x_allocator.h"
+#include "xbase/x_jobs.h"
+#include "xbase/x_qsort.h"
+#include "xbase/x_sort.h"
+
+#include "xunittest/xunittest.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t* gTestAllocator;
+
+namespace xcore
+{
+    enum sort_pattern_e
+    {
+        SORT_RANDOM,
+        SORT_SORTED,
+        SORT_REVERSED,
+        SORT_EQUAL,
+        SORT_FEW_UNIQUE,
+        SORT_ORGAN_PIPE, // ascending then descending
+        SORT_SAWTOOTH,   // many short ascending runs
+        SORT_NEARLY_SORTED,
+        SORT_PATTERNS
+    };
+
+    static u32 sort_random(u32& state)
+    {
+        state = state * 1664525 + 1013904223;
+        return state;
+    }
+
+    static void sort_fill(u32* items, u32 count, s32 pattern)
+    {
+        u32 state = count;
+        for (u32 i = 0; i < count; ++i)
+        {
+            switch (pattern)
+            {
+                case SORT_RANDOM: items[i] = sort_random(state); break;
+                case SORT_SORTED: items[i] = i; break;
+                case SORT_REVERSED: items[i] = count - i; break;
+                case SORT_EQUAL: items[i] = 42; break;
+                case SORT_FEW_UNIQUE: items[i] = sort_random(state) >> 29; break;
+                case SORT_ORGAN_PIPE: items[i] = i < (count / 2) ? i : count - i; break;
+                case SORT_SAWTOOTH: items[i] = i % 37; break;
+                case SORT_NEARLY_SORTED: items[i] = (sort_random(state) % 16) == 0 ? sort_random(state) % count : i; break;
+            }
+        }
+    }
+
+    template <typename T, typename L> static bool sort_is_sorted(T const* items, u32 count, L const& less)
+    {
+        for (u32 i = 1; i < count; ++i)
+        {
+            if (less(items[i], items[i - 1]))
+                return false;
+        }
+        return true;
+    }
+
+    static s32 sort_u32_compare(const void* const a, const void* const b, void*)
+    {
+        u32 const aa = *(u32 const*)a;
+        u32 const bb = *(u32 const*)b;
+        return aa < bb ? -1 : (aa > bb ? 1 : 0);
+    }
+
+    // The sorted items should be the same as the ones sorted by xqsort
+    static bool sort_same_as_xqsort(u32* items, u32* expected, u32 count)
+    {
+        xqsort(expected, (s32)count, sizeof(u32), sort_u32_compare);
+        for (u32 i = 0; i < count; ++i)
+        {
+            if (items[i] != expected[i])
+                return false;
+        }
+        return true;
+    }
+
+    struct sort_record_t
+    {
+        u64 m_time;
+        u32 m_id;
+        u32 m_payload[5];
+    };
+
+    struct sort_record_by_time_t
+    {
+        inline bool operator()(sort_record_t const& a, sort_record_t const& b) const { return a.m_time < b.m_time; }
+    };
+
+    struct sort_record_time_t
+    {
+        inline u64 operator()(sort_record_t const& r) const { return r.m_time; }
+    };
+
+    // Equal keys keep the order of their ids
+    static bool sort_is_stable(sort_record_t const* records, u32 count)
+    {
+        for (u32 i = 1; i < count; ++i)
+        {
+            if (records[i].m_time < records[i - 1].m_time)
+                return false;
+            if (records[i].m_time == records[i - 1].m_time && records[i].m_id < records[i - 1].m_id)
+                return false;
+        }
+        return true;
+    }
+
+    // Few distinct times, many equal keys
+    static void sort_fill_records(sort_record_t* records, u32 count)
+    {
+        u32 state = 7;
+        for (u32 i = 0; i < count; ++i)
+        {
+            records[i].m_time = 1700000000000ull + (sort_random(state) % 1000);
+            records[i].m_id   = i;
+            for (s32 j = 0; j < 5; ++j)
+                records[i].m_payload[j] = i * 5 + j;
+        }
+    }
+
+    // Executes the tasks in a different order than the calling thread would,
+    // like @m_threads threads that each take every n-th task
+    class sort_test_jobs_t : public jobs_t
+    {
+    public:
+        inline sort_test_jobs_t(u32 threads) : m_threads(threads), m_tasks(0) {}
+
+        u32 m_threads;
+        u32 m_tasks;
+
+    protected:
+        virtual u32  v_concurrency() const { return m_threads; }
+        virtual void v_run(job_t* job, u32 count)
+        {
+            m_tasks += count;
+            for (u32 t = m_threads; t > 0; --t)
+            {
+                for (u32 i = t - 1; i < count; i += m_threads)
+                    job->execute(i);
+            }
+        }
+    };
+
+    // Counts the comparisons
+    struct sort_counting_less_t
+    {
+        sort_counting_less_t(u64* count) : m_count(count) {}
+        inline bool operator()(u32 a, u32 b) const
+        {
+            *m_count += 1;
+            return a < b;
+        }
+        u64* m_count;
+    };
+}
+
+UNITTEST_SUITE_BEGIN(xsort)
+{
+    UNITTEST_FIXTURE(main)
+    {
+        UNITTEST_FIXTURE_SETUP() {}
+        UNITTEST_FIXTURE_TEARDOWN() {}
+
+        UNITTEST_TEST(sort_patterns)
+        {
+            u32 const sizes[] = {0, 1, 2, 3, 15, 16, 17, 100, 129, 1000, 20000};
+            u32* items    = (u32*)gTestAllocator->allocate(20000 * sizeof(u32), sizeof(u32));
+            u32* expected = (u32*)gTestAllocator->allocate(20000 * sizeof(u32), sizeof(u32));
+            for (u32 s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+            {
+                for (s32 p = 0; p < SORT_PATTERNS; ++p)
+                {
+                    sort_fill(items, sizes[s], p);
+                    sort_fill(expected, sizes[s], p);
+                    sort(items, sizes[s]);
+                    CHECK_TRUE(sort_same_as_xqsort(items, expected, sizes[s]));
+                }
+            }
+            gTestAllocator->deallocate(expected);
+            gTestAllocator->deallocate(items);
+        }
+
+        UNITTEST_TEST(sort_records)
+        {
+            u32 const      count   = 5000;
+            sort_record_t* records = (sort_record_t*)gTestAllocator->allocate(count * sizeof(sort_record_t), sizeof(u64));
+            u32            state   = 7;
+            u64            sum     = 0;
+            for (u32 i = 0; i < count; ++i)
+            {
+                records[i].m_time = ((u64)sort_random(state) << 32) | (sort_random(state) % 100);
+                records[i].m_id   = i;
+                for (s32 j = 0; j < 5; ++j)
+                    records[i].m_payload[j] = i * 5 + j;
+                sum += i;
+            }
+
+            sort(records, count, sort_record_by_time_t());
+            CHECK_TRUE(sort_is_sorted(records, count, sort_record_by_time_t()));
+
+            // Records moved as a whole
+            bool ok = true;
+            for (u32 i = 0; i < count; ++i)
+            {
+                for (s32 j = 0; j < 5; ++j)
+                    ok = ok && records[i].m_payload[j] == records[i].m_id * 5 + j;
+                sum -= records[i].m_id;
+            }
+            CHECK_TRUE(ok);
+            CHECK_EQUAL(0, sum);
+
+            gTestAllocator->deallocate(records);
+        }
+
+        UNITTEST_TEST(sort_worst_case)
+        {
+            // Patterns that are bad for a median of 3 pivot stay O(n log n),
+            // with and without the branchless partition
+            u32 const count = 1 << 16;
+            u32*      items = (u32*)gTestAllocator->allocate(count * sizeof(u32), sizeof(u32));
+            for (s32 p = 0; p < SORT_PATTERNS; ++p)
+            {
+                u64 comparisons = 0;
+                sort_fill(items, count, p);
+                sort(items, count, sort_counting_less_t(&comparisons));
+                CHECK_TRUE(sort_is_sorted(items, count, sort_less_t<u32>()));
+                CHECK_TRUE(comparisons < (u64)count * 16 * 3);
+
+                sort_fill(items, count, p);
+                sort(items, count);
+                CHECK_TRUE(sort_is_sorted(items, count, sort_less_t<u32>()));
+            }
+            gTestAllocator->deallocate(items);
+        }
+
+        UNITTEST_TEST(sort_adaptive)
+        {
+            // Sorted, descending and equal items take O(n) comparisons, few
+            // distinct values O(n log k)
+            u32 const count    = 1 << 16;
+            u32*      items    = (u32*)gTestAllocator->allocate(count * sizeof(u32), sizeof(u32));
+            s32 const linear[] = {SORT_SORTED, SORT_REVERSED, SORT_EQUAL};
+            for (s32 p = 0; p < 3; ++p)
+            {
+                u64 comparisons = 0;
+                sort_fill(items, count, linear[p]);
+                sort(items, count, sort_counting_less_t(&comparisons));
+                CHECK_TRUE(sort_is_sorted(items, count, sort_less_t<u32>()));
+                CHECK_TRUE(comparisons < (u64)count * 4);
+            }
+
+            u64 comparisons = 0;
+            sort_fill(items, count, SORT_FEW_UNIQUE);
+            sort(items, count, sort_counting_less_t(&comparisons));
+            CHECK_TRUE(sort_is_sorted(items, count, sort_less_t<u32>()));
+            CHECK_TRUE(comparisons < (u64)count * 8);
+
+            gTestAllocator->deallocate(items);
+        }
+
+        UNITTEST_TEST(radix_sort_u32)
+        {
+            u32 const sizes[] = {0, 1, 2, 64, 65, 1000, 20000};
+            u32*      items    = (u32*)gTestAllocator->allocate(20000 * sizeof(u32), sizeof(u32));
+            u32*      expected = (u32*)gTestAllocator->allocate(20000 * sizeof(u32), sizeof(u32));
+            for (u32 s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+            {
+                for (s32 p = 0; p < SORT_PATTERNS; ++p)
+                {
+                    sort_fill(items, sizes[s], p);
+                    sort_fill(expected, sizes[s], p);
+                    radix_sort(items, sizes[s], gTestAllocator);
+                    CHECK_TRUE(sort_same_as_xqsort(items, expected, sizes[s]));
+                }
+            }
+            gTestAllocator->deallocate(expected);
+            gTestAllocator->deallocate(items);
+        }
+
+        UNITTEST_TEST(radix_sort_signed_and_float)
+        {
+            u32 const count = 5000;
+            s64*      s     = (s64*)gTestAllocator->allocate(count * sizeof(s64), sizeof(s64));
+            f32*      f     = (f32*)gTestAllocator->allocate(count * sizeof(f32), sizeof(f32));
+            f64*      d     = (f64*)gTestAllocator->allocate(count * sizeof(f64), sizeof(f64));
+            s32*      i32   = (s32*)gTestAllocator->allocate(count * sizeof(s32), sizeof(s32));
+            u32       state = 3;
+            for (u32 i = 0; i < count; ++i)
+            {
+                u32 const r = sort_random(state);
+                s[i]        = (s64)(s32)r * (1 << 20) + (s64)(i & 0xff);
+                i32[i]      = (s32)r >> (i & 15);
+                f[i]        = (f32)(s32)r / 1000.0f;
+                d[i]        = (f64)(s32)r * 1e200 / 4e9;
+            }
+            f[0] = -0.0f;
+            f[1] = 0.0f;
+            f[2] = -1e30f;
+            f[3] = 1e-30f;
+
+            radix_sort(s, count, gTestAllocator);
+            radix_sort(f, count, gTestAllocator);
+            radix_sort(d, count, gTestAllocator);
+            radix_sort(i32, count, gTestAllocator);
+            CHECK_TRUE(sort_is_sorted(s, count, sort_less_t<s64>()));
+            CHECK_TRUE(sort_is_sorted(f, count, sort_less_t<f32>()));
+            CHECK_TRUE(sort_is_sorted(d, count, sort_less_t<f64>()));
+            CHECK_TRUE(sort_is_sorted(i32, count, sort_less_t<s32>()));
+            CHECK_TRUE(s[0] < 0 && s[count - 1] > 0);
+            CHECK_EQUAL(-1e30f, f[0]);
+
+            gTestAllocator->deallocate(i32);
+            gTestAllocator->deallocate(d);
+            gTestAllocator->deallocate(f);
+            gTestAllocator->deallocate(s);
+        }
+
+        UNITTEST_TEST(radix_sort_records)
+        {
+            // Timestamps share their high digits, those passes are skipped
+            u32 const      count   = 20000;
+            sort_record_t* records = (sort_record_t*)gTestAllocator->allocate(count * sizeof(sort_record_t), sizeof(u64));
+            sort_fill_records(records, count);
+
+            radix_sort_by(records, count, sort_record_time_t(), gTestAllocator);
+            CHECK_TRUE(sort_is_stable(records, count));
+            bool ok = true;
+            for (u32 i = 0; i < count; ++i)
+            {
+                for (s32 j = 0; j < 5; ++j)
+                    ok = ok && records[i].m_payload[j] == records[i].m_id * 5 + j;
+            }
+            CHECK_TRUE(ok);
+
+            // Caller supplied scratch memory
+            u32 const size    = (u32)radix_sort_scratch_size<sort_record_t>(count);
+            xbyte*    data    = (xbyte*)gTestAllocator->allocate(size, sizeof(u64));
+            sort_fill_records(records, count);
+            CHECK_FALSE(radix_sort_by(records, count, sort_record_time_t(), buffer_t(size - 64, data)));
+            CHECK_TRUE(radix_sort_by(records, count, sort_record_time_t(), buffer_t(size, data)));
+            CHECK_TRUE(sort_is_stable(records, count));
+
+            u64* keys = (u64*)gTestAllocator->allocate(count * sizeof(u64), sizeof(u64));
+            for (u32 i = 0; i < count; ++i)
+                keys[i] = records[(i * 7919) % count].m_time;
+            CHECK_TRUE(radix_sort(keys, count, buffer_t(size, data)));
+            CHECK_TRUE(sort_is_sorted(keys, count, sort_less_t<u64>()));
+
+            // The scratch size of 2^30 records does not fit in a u32, no buffer is large enough
+            u32 const huge = 0x40000000;
+            CHECK_TRUE(radix_sort_scratch_size<sort_record_t>(huge) > (u64)huge * sizeof(sort_record_t));
+            CHECK_FALSE(radix_sort_by(records, huge, sort_record_time_t(), buffer_t(size, data)));
+
+            gTestAllocator->deallocate(keys);
+            gTestAllocator->deallocate(data);
+            gTestAllocator->deallocate(records);
+        }
+
+        UNITTEST_TEST(parallel_sort)
+        {
+            u32 const count    = 200000;
+            u32*      items    = (u32*)gTestAllocator->allocate(count * sizeof(u32), sizeof(u32));
+            u32*      expected = (u32*)gTestAllocator->allocate(count * sizeof(u32), sizeof(u32));
+            u32 const threads[] = {1, 2, 3, 8, 13};
+            for (u32 t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+            {
+                for (s32 p = 0; p < SORT_PATTERNS; ++p)
+                {
+                    sort_test_jobs_t jobs(threads[t]);
+                    sort_fill(items, count, p);
+                    sort_fill(expected, count, p);
+                    parallel_sort(items, count, &jobs, gTestAllocator);
+                    CHECK_TRUE(sort_same_as_xqsort(items, expected, count));
+                    CHECK_EQUAL(threads[t] > 1, jobs.m_tasks > 0);
+                }
+            }
+
+            // Small arrays and no jobs are sorted on the calling thread
+            sort_test_jobs_t jobs(8);
+            sort_fill(items, 1000, SORT_RANDOM);
+            parallel_sort(items, 1000, &jobs);
+            CHECK_TRUE(sort_is_sorted(items, 1000, sort_less_t<u32>()));
+            CHECK_EQUAL(0, jobs.m_tasks);
+            sort_fill(items, count, SORT_RANDOM);
+            parallel_sort(items, count, (jobs_t*)nullptr);
+            CHECK_TRUE(sort_is_sorted(items, count, sort_less_t<u32>()));
+
+            gTestAllocator->deallocate(expected);
+            gTestAllocator->deallocate(items);
+        }
+
+        UNITTEST_TEST(parallel_sort_slices)
+        {
+            // An array that needs more scratch memory than allowed is sorted in
+            // slices, here the limit is lowered from 4 GB to 40000 items
+            u32 const count    = 200000;
+            u32*      items    = (u32*)gTestAllocator->allocate(count * sizeof(u32), sizeof(u32));
+            u32*      expected = (u32*)gTestAllocator->allocate(count * sizeof(u32), sizeof(u32));
+            for (s32 p = 0; p < SORT_PATTERNS; ++p)
+            {
+                sort_test_jobs_t jobs(3);
+                sort_fill(items, count, p);
+                sort_fill(expected, count, p);
+                nsort::parallel_sort(items, count, sort_less_t<u32>(), &jobs, gTestAllocator, 40000 * sizeof(u32));
+                CHECK_TRUE(sort_same_as_xqsort(items, expected, count));
+            }
+
+            gTestAllocator->deallocate(expected);
+            gTestAllocator->deallocate(items);
+        }
+
+        UNITTEST_TEST(parallel_sort_records)
+        {
+            u32 const      count   = 100000;
+            sort_record_t* records = (sort_record_t*)gTestAllocator->allocate(count * sizeof(sort_record_t), sizeof(u64));
+            sort_fill_records(records, count);
+
+            sort_test_jobs_t jobs(5);
+            parallel_sort(records, count, sort_record_by_time_t(), &jobs, gTestAllocator);
+            CHECK_TRUE(sort_is_sorted(records, count, sort_record_by_time_t()));
+            bool ok  = true;
+            u64  sum = 0;
+            for (u32 i = 0; i < count; ++i)
+            {
+                for (s32 j = 0; j < 5; ++j)
+                    ok = ok && records[i].m_payload[j] == records[i].m_id * 5 + j;
+                sum += records[i].m_id;
+            }
+            CHECK_TRUE(ok);
+            CHECK_EQUAL((u64)count * (count - 1) / 2, sum);
+
+            gTestAllocator->deallocate(records);
+        }
+
+        UNITTEST_TEST(stable_sort_patterns)
+        {
+            u32 const sizes[] = {0, 1, 2, 24, 25, 63, 64, 65, 1000, 20000};
+            u32*      items    = (u32*)gTestAllocator->allocate(20000 * sizeof(u32), sizeof(u32));
+            u32*      expected = (u32*)gTestAllocator->allocate(20000 * sizeof(u32), sizeof(u32));
+            for (u32 s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+            {
+                for (s32 p = 0; p < SORT_PATTERNS; ++p)
+                {
+                    sort_fill(items, sizes[s], p);
+                    sort_fill(expected, sizes[s], p);
+                    merge_sort(items, sizes[s], sort_less_t<u32>(), gTestAllocator);
+                    CHECK_TRUE(sort_same_as_xqsort(items, expected, sizes[s]));
+
+                    sort_fill(items, sizes[s], p);
+                    tim_sort(items, sizes[s], sort_less_t<u32>(), gTestAllocator);
+                    CHECK_TRUE(sort_same_as_xqsort(items, expected, sizes[s]));
+                }
+            }
+            gTestAllocator->deallocate(expected);
+            gTestAllocator->deallocate(items);
+        }
+
+        UNITTEST_TEST(stable_sort_records)
+        {
+            u32 const      count   = 20000;
+            sort_record_t* records = (sort_record_t*)gTestAllocator->allocate(count * sizeof(sort_record_t), sizeof(u64));
+
+            sort_fill_records(records, count);
+            merge_sort(records, count, sort_record_by_time_t(), gTestAllocator);
+            CHECK_TRUE(sort_is_stable(records, count));
+
+            sort_fill_records(records, count);
+            tim_sort(records, count, sort_record_by_time_t(), gTestAllocator);
+            CHECK_TRUE(sort_is_stable(records, count));
+
+            // Mostly in order, with equal times, runs in both directions and
+            // late arrivals
+            for (u32 i = 0; i < count; ++i)
+            {
+                records[i].m_time = i / 4;
+                records[i].m_id   = i;
+            }
+            for (u32 i = 5000; i < 6000; ++i)
+                records[i].m_time = 7000 - i / 4;
+            for (u32 i = 100; i < count; i += 997)
+                records[i].m_time = i / 8;
+            tim_sort(records, count, sort_record_by_time_t(), gTestAllocator);
+            CHECK_TRUE(sort_is_stable(records, count));
+
+            // Caller supplied scratch memory
+            u32 const size = (u32)stable_sort_scratch_size<sort_record_t>(count);
+            xbyte*    data = (xbyte*)gTestAllocator->allocate(size, sizeof(u64));
+            sort_fill_records(records, count);
+            CHECK_FALSE(merge_sort(records, count, sort_record_by_time_t(), buffer_t(size - 1, data)));
+            CHECK_FALSE(tim_sort(records, count, sort_record_by_time_t(), buffer_t(size - 1, data)));
+            CHECK_TRUE(tim_sort(records, count, sort_record_by_time_t(), buffer_t(size, data)));
+            CHECK_TRUE(sort_is_stable(records, count));
+            sort_fill_records(records, count);
+            CHECK_TRUE(merge_sort(records, count, sort_record_by_time_t(), buffer_t(size, data)));
+            CHECK_TRUE(sort_is_stable(records, count));
+
+            // The scratch size of 2^30 records does not fit in a u32, no buffer is large enough
+            u32 const huge = 0x40000000;
+            CHECK_EQUAL((u64)(huge / 2) * sizeof(sort_record_t), stable_sort_scratch_size<sort_record_t>(huge));
+            CHECK_FALSE(merge_sort(records, huge, sort_record_by_time_t(), buffer_t(size, data)));
+            CHECK_FALSE(tim_sort(records, huge, sort_record_by_time_t(), buffer_t(size, data)));
+
+            gTestAllocator->deallocate(data);
+            gTestAllocator->deallocate(records);
+        }
+
+        UNITTEST_TEST(tim_sort_adaptive)
+        {
+            u32 const count = 1 << 16;
+            u32*      items = (u32*)gTestAllocator->allocate(count * sizeof(u32), sizeof(u32));
+
+            // Sorted and descending input is one run
+            u64 comparisons = 0;
+            sort_fill(items, count, SORT_SORTED);
+            tim_sort(items, count, sort_counting_less_t(&comparisons), gTestAllocator);
+            CHECK_EQUAL((u64)count - 1, comparisons);
+            comparisons = 0;
+            sort_fill(items, count, SORT_REVERSED);
+            tim_sort(items, count, sort_counting_less_t(&comparisons), gTestAllocator);
+            CHECK_TRUE(sort_is_sorted(items, count, sort_less_t<u32>()));
+            CHECK_TRUE(comparisons < (u64)count * 2);
+
+            // Two sorted halves that interleave in long stretches, the merge
+            // gallops through them
+            for (u32 i = 0; i < count / 2; ++i)
+            {
+                items[i]             = (i / 1024) * 2048 + (i % 1024);
+                items[count / 2 + i] = (i / 1024) * 2048 + 1024 + (i % 1024);
+            }
+            comparisons = 0;
+            tim_sort(items, count, sort_counting_less_t(&comparisons), gTestAllocator);
+            CHECK_TRUE(sort_is_sorted(items, count, sort_less_t<u32>()));
+            CHECK_TRUE(comparisons < (u64)count * 3 / 2);
+
+            gTestAllocator->deallocate(items);
+        }
+    }
+}
+UNITTEST_SUITE_END
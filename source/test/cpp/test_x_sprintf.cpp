@@ -40,6 +40,15 @@ UNITTEST_SUITE_BEGIN(xsprintf)
 			sprintf(str, fmt, va_t("test string"));
 			CHECK_EQUAL(0, compare(str, "the test string"));
 		}
+
+		UNITTEST_TEST(format_string_then_more)
+		{
+			runez_t<ascii::rune, 256> str;
+			crunes_t fmt("%s and %s took %f");
+
+			sprintf(str, fmt, va_t("this"), va_t("that"), va_t(1.5));
+			CHECK_EQUAL(0, compare(str, "this and that took 1.500000"));
+		}
 	}
 }
 UNITTEST_SUITE_END